@@ -0,0 +1,132 @@
+/*
+ * Created by switchblade on 2023-01-30.
+ */
+
+#include <functional>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <tpp/fast_hash.hpp>
+#include <tpp/sparse_map.hpp>
+
+/* Throughput benchmark of string hashing via `std::hash` and every implementation of `fast_hash` supported by the CPU,
+ * followed by lookup throughput of a `sparse_map` with string keys using `std::hash` and `fast_hash`.
+ *
+ * Usage: tpp-fast-hash-bench [bytes] */
+
+struct xorshift
+{
+	std::uint64_t operator()() noexcept
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	std::uint64_t state;
+};
+
+template<typename F>
+static double run_hash(const std::vector<std::string> &keys, std::size_t total_bytes, F hash)
+{
+	std::uint64_t sink = 0;
+	std::size_t bytes = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	while (bytes < total_bytes)
+		for (auto &key: keys)
+		{
+			sink += hash(key);
+			bytes += key.size();
+		}
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	/* Prevent the hashes from being optimized out. */
+	if (sink == 1) std::puts("");
+	return static_cast<double>(bytes) / elapsed / 1e9;
+}
+
+static std::vector<std::string> make_keys(std::size_t length, std::size_t n)
+{
+	auto rng = xorshift{0x9e3779b97f4a7c15ull};
+	std::vector<std::string> keys(n);
+	for (auto &key: keys)
+	{
+		key.resize(length);
+		for (auto &c: key) c = static_cast<char>('a' + rng() % 26);
+	}
+	return keys;
+}
+
+template<typename Map>
+static double run_lookup(const Map &map, const std::vector<std::string> &keys, std::size_t lookups)
+{
+	std::uint64_t sink = 0;
+	auto rng = xorshift{0x2545f4914f6cdd1dull};
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < lookups; ++i)
+		if (const auto pos = map.find(keys[rng() % keys.size()]); pos != map.end())
+			sink += pos->second;
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (sink == 1) std::puts("");
+	return static_cast<double>(lookups) / elapsed / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+	namespace detail = tpp::_detail;
+
+	const auto total_bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1ull << 30;
+	const auto isa = detail::detect_hash_isa();
+
+	std::printf("%-8s %12s %12s %12s %12s\n", "length", "std::hash", "portable", "crc32c", "aes");
+	std::printf("%-8s %12s %12s %12s %12s\n", "", "GB/s", "GB/s", "GB/s", "GB/s");
+	for (std::size_t length: {4, 8, 16, 24, 32, 64, 128, 1024})
+	{
+		const auto keys = make_keys(length, 1024);
+		const auto bytes = static_cast<std::size_t>(total_bytes);
+		const auto with = [&](auto func)
+		{
+			return run_hash(keys, bytes, [&](const std::string &key) { return func(reinterpret_cast<const unsigned char *>(key.data()), key.size(), 0); });
+		};
+
+		std::printf("%-8zu %12.2f %12.2f", length, run_hash(keys, bytes, std::hash<std::string>{}), with(detail::hash_bytes_portable));
+#ifdef TPP_FAST_HASH_X64
+		if (isa != detail::hash_isa::portable)
+			std::printf(" %12.2f", with(detail::hash_bytes_crc32c));
+		else
+			std::printf(" %12s", "-");
+		if (isa == detail::hash_isa::aes)
+			std::printf(" %12.2f", with(detail::hash_bytes_aes));
+		else
+			std::printf(" %12s", "-");
+#else
+		static_cast<void>(isa);
+		std::printf(" %12s %12s", "-", "-");
+#endif
+		std::puts("");
+	}
+
+	std::printf("\n%-8s %12s %12s\n", "length", "std::hash", "fast_hash");
+	std::printf("%-8s %12s %12s\n", "", "Mop/s", "Mop/s");
+	for (std::size_t length: {8, 16, 32, 64})
+	{
+		const auto keys = make_keys(length, 1 << 20);
+		auto std_map = tpp::sparse_map<std::string, std::uint64_t>{};
+		auto fast_map = tpp::sparse_map<std::string, std::uint64_t, tpp::fast_hash<std::string>>{};
+		for (std::size_t i = 0; i < keys.size(); ++i)
+		{
+			std_map.emplace(keys[i], i);
+			fast_map.emplace(keys[i], i);
+		}
+		const auto lookups = static_cast<std::size_t>(total_bytes / 64);
+		std::printf("%-8zu %12.2f %12.2f\n", length, run_lookup(std_map, keys, lookups), run_lookup(fast_map, keys, lookups));
+	}
+}
@@ -0,0 +1,90 @@
+/*
+ * Created by switchblade on 2023-01-28.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+
+#include <tpp/sparse_map.hpp>
+#include <tpp/frozen_map.hpp>
+
+/* Lookup throughput benchmark of `frozen_map` against `sparse_map`. Sparse maps are filled up to their maximum load factor,
+ * which is their most memory-efficient state, and the frozen map is built from the same elements. Memory used by the
+ * element & metadata arrays of both tables is reported alongside the throughput.
+ *
+ * Usage: tpp-frozen-map-bench [lookups] */
+
+struct xorshift
+{
+	std::uint64_t operator()() noexcept
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	std::uint64_t state;
+};
+
+template<typename Map>
+static double run(const Map &map, const std::vector<std::uint64_t> &keys, std::size_t lookups)
+{
+	std::uint64_t sink = 0;
+	auto rng = xorshift{0x9e3779b97f4a7c15ull};
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < lookups; ++i)
+		if (const auto pos = map.find(keys[rng() % keys.size()]); pos != map.end())
+			sink += pos->second;
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	/* Prevent the lookups from being optimized out. */
+	if (sink == 1) std::puts("");
+	return static_cast<double>(lookups) / elapsed / 1e6;
+}
+
+static void bench_size(std::size_t buckets, std::size_t lookups)
+{
+	auto sparse = tpp::sparse_map<std::uint64_t, std::uint64_t>{};
+	sparse.rehash(buckets);
+	const auto n = sparse.capacity();
+
+	auto rng = xorshift{0x2545f4914f6cdd1dull};
+	std::vector<std::uint64_t> hits, misses;
+	while (sparse.size() < n)
+		if (const auto key = rng(); sparse.try_emplace(key, key).second)
+			hits.push_back(key);
+	while (misses.size() < n)
+		if (const auto key = rng(); !sparse.contains(key))
+			misses.push_back(key);
+
+	const auto build_start = std::chrono::steady_clock::now();
+	const auto frozen = tpp::freeze(sparse);
+	const auto build_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - build_start).count();
+
+	/* Sparse map stores one metadata byte per bucket, followed by the mirrored metadata block. */
+	const auto sparse_bytes = sparse.bucket_count() * (sizeof(std::pair<std::uint64_t, std::uint64_t>) + 1) + 16;
+	const auto frozen_bytes = frozen.memory_usage();
+
+	std::printf("%-10zu %14.2f %14.2f %14.2f %14.2f %12.2f %12.2f %10.1f\n", n,
+	            run(sparse, hits, lookups), run(frozen, hits, lookups),
+	            run(sparse, misses, lookups), run(frozen, misses, lookups),
+	            static_cast<double>(sparse_bytes) / static_cast<double>(n),
+	            static_cast<double>(frozen_bytes) / static_cast<double>(n),
+	            build_time * 1e3);
+}
+
+int main(int argc, char *argv[])
+{
+	const auto lookups = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000ull;
+
+	std::printf("%-10s %14s %14s %14s %14s %12s %12s %10s\n", "size", "sparse hit", "frozen hit", "sparse miss", "frozen miss",
+	            "sparse B/el", "frozen B/el", "build ms");
+	std::printf("%-10s %14s %14s %14s %14s\n", "", "Mop/s", "Mop/s", "Mop/s", "Mop/s");
+	for (std::size_t buckets = 1 << 12; buckets <= (1 << 22); buckets <<= 2)
+		bench_size(buckets, static_cast<std::size_t>(lookups));
+}
@@ -0,0 +1,93 @@
+/*
+ * Created by switchblade on 2023-01-20.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <tpp/sharded_map.hpp>
+#include <tpp/sparse_map.hpp>
+#include <tpp/dense_map.hpp>
+
+/* Multi-threaded throughput benchmark of `sharded_map`. Every thread runs a mixed workload of lookups, inserts & erases
+ * over a shared key range. Running the benchmark with a single shard measures a map protected by a single lock.
+ *
+ * Usage: tpp-sharded-map-bench [max threads] [operations per thread] [read percentage] */
+
+struct xorshift
+{
+	std::uint64_t operator()() noexcept
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	std::uint64_t state;
+};
+
+template<typename Map>
+static double run(std::size_t threads, std::size_t ops, unsigned read_pct, std::uint64_t key_range)
+{
+	Map map;
+	map.reserve(static_cast<std::size_t>(key_range));
+	for (std::uint64_t i = 0; i < key_range; i += 2) map.try_emplace(i, i);
+
+	std::vector<std::thread> workers;
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < threads; ++i)
+		workers.emplace_back([&map, ops, read_pct, key_range, i]()
+		                     {
+			                     auto rng = xorshift{0x9e3779b97f4a7c15ull * (i + 1)};
+			                     std::uint64_t sink = 0;
+			                     for (std::size_t j = 0; j < ops; ++j)
+			                     {
+				                     const auto r = rng();
+				                     const auto key = r % key_range;
+				                     if ((r >> 32) % 100 < read_pct)
+					                     map.cvisit(key, [&](const auto &value) { sink += value.second; });
+				                     else if ((r >> 32) & 1)
+					                     map.try_emplace(key, key);
+				                     else
+					                     map.erase(key);
+			                     }
+			                     /* Prevent the lookups from being optimized out. */
+			                     if (sink == 1) std::puts("");
+		                     });
+	for (auto &worker: workers) worker.join();
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return static_cast<double>(threads * ops) / elapsed / 1e6;
+}
+
+template<typename Table>
+static void bench_table(const char *name, std::size_t max_threads, std::size_t ops, unsigned read_pct)
+{
+	constexpr std::uint64_t key_range = 1 << 20;
+
+	std::printf("%s\n%-8s %16s %16s %16s\n", name, "threads", "1 shard Mop/s", "16 shards Mop/s", "64 shards Mop/s");
+	for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		const auto single = run<tpp::sharded_map<Table, 1>>(threads, ops, read_pct, key_range);
+		const auto shards16 = run<tpp::sharded_map<Table, 16>>(threads, ops, read_pct, key_range);
+		const auto shards64 = run<tpp::sharded_map<Table, 64>>(threads, ops, read_pct, key_range);
+		std::printf("%-8zu %16.2f %16.2f %16.2f\n", threads, single, shards16, shards64);
+	}
+	std::puts("");
+}
+
+int main(int argc, char *argv[])
+{
+	const auto max_threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::max(std::thread::hardware_concurrency(), 1u);
+	const auto ops = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000ull;
+	const auto read_pct = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 90u;
+
+	bench_table<tpp::sparse_map<std::uint64_t, std::uint64_t>>("sparse_map", max_threads, ops, read_pct);
+	bench_table<tpp::dense_map<std::uint64_t, std::uint64_t>>("dense_map", max_threads, ops, read_pct);
+}
@@ -0,0 +1,164 @@
+/*
+ * Created by switchblade on 2023-01-27.
+ */
+
+#include "tests.hpp"
+#include "offset_allocator.hpp"
+
+#include <functional>
+#include <cstring>
+#include <vector>
+#include <tuple>
+
+#include <tpp/sparse_set.hpp>
+#include <tpp/sparse_map.hpp>
+#include <tpp/stable_set.hpp>
+#include <tpp/stable_map.hpp>
+#include <tpp/cow_map.hpp>
+#include <tpp/dense_set.hpp>
+#include <tpp/dense_map.hpp>
+#include <tpp/dense_multiset.hpp>
+#include <tpp/dense_multimap.hpp>
+
+static_assert(std::is_same_v<std::pointer_traits<offset_ptr<int>>::rebind<void>, offset_ptr<void>>);
+
+/* Adapters used to run the same tests on sets, maps & multi-key containers. */
+struct set_ops
+{
+	template<typename C>
+	static void insert(C &c, int i) { c.emplace(i); }
+	template<typename C>
+	static bool check(const C &c, int i) { return c.contains(i); }
+};
+struct map_ops
+{
+	template<typename C>
+	static void insert(C &c, int i) { c.emplace(i, i * 2); }
+	template<typename C>
+	static bool check(const C &c, int i) { return c.contains(i) && c.at(i) == i * 2; }
+};
+struct multi_ops
+{
+	template<typename C>
+	static void insert(C &c, int i) { c.emplace(std::make_tuple(i, static_cast<long>(i) + 1)); }
+	template<typename C>
+	static bool check(const C &c, int i) { return c.template contains<0>(i) && c.template find<1>(static_cast<long>(i) + 1) == c.template find<0>(i); }
+};
+struct multimap_ops
+{
+	template<typename C>
+	static void insert(C &c, int i) { c.emplace(std::make_tuple(i, static_cast<long>(i) + 1), i * 2); }
+	template<typename C>
+	static bool check(const C &c, int i) { return c.template contains<0>(i) && c.template find<1>(static_cast<long>(i) + 1)->second == i * 2; }
+};
+
+template<typename Ops, typename C>
+static void check_contents(const C &c, int n)
+{
+	TEST_ASSERT(c.size() == static_cast<std::size_t>(n - (n + 2) / 3));
+	std::size_t count = 0;
+	for (auto iter = c.begin(); iter != c.end(); ++iter) ++count;
+	TEST_ASSERT(count == c.size());
+	for (int i = 0; i < n; ++i) TEST_ASSERT(Ops::check(c, i) == (i % 3 != 0));
+}
+template<typename Ops, typename C>
+static void fill(C &c, int n)
+{
+	for (int i = 0; i < n; ++i) Ops::insert(c, i);
+	c.erase(c.find(0));
+	for (int i = 3; i < n; i += 3) c.erase(i);
+}
+template<typename Ops, typename C>
+static void fill_multi(C &c, int n)
+{
+	for (int i = 0; i < n; ++i) Ops::insert(c, i);
+	for (int i = 0; i < n; i += 3) c.template erase<0>(i);
+}
+
+/* Containers must be fully functional with fancy pointers. */
+template<typename Ops, typename C, typename F>
+static void test_offset_ptr(F fill_func) noexcept
+{
+	constexpr int n = 1000;
+
+	auto c = C{};
+	fill_func(c, n);
+	check_contents<Ops>(c, n);
+
+	auto copy = C{c};
+	check_contents<Ops>(copy, n);
+	auto moved = C{std::move(copy)};
+	check_contents<Ops>(moved, n);
+
+	copy = c;
+	check_contents<Ops>(copy, n);
+	moved = std::move(copy);
+	check_contents<Ops>(moved, n);
+
+	c.rehash(c.bucket_count() * 2);
+	check_contents<Ops>(c, n);
+	swap(c, moved);
+	check_contents<Ops>(c, n);
+
+	c.clear();
+	TEST_ASSERT(c.empty() && c.begin() == c.end());
+}
+
+/* Containers allocated within an arena via offset pointers must remain valid when the arena is relocated,
+ * as if it was a shared memory region mapped at a different address by another process. */
+template<typename Ops, typename C, typename F>
+static void test_relocate(F fill_func) noexcept
+{
+	constexpr int n = 1000;
+	constexpr std::size_t arena_size = 1 << 21;
+
+	std::vector<std::max_align_t> src((arena_size + sizeof(offset_arena)) / sizeof(std::max_align_t) + 1);
+	auto *arena = new(src.data()) offset_arena{arena_size};
+	auto *c = new(arena->allocate(sizeof(C), alignof(C))) C{typename C::allocator_type{arena}};
+	fill_func(*c, n);
+	check_contents<Ops>(*c, n);
+
+	/* Copy the arena and poison the original. */
+	auto dst = src;
+	std::memset(static_cast<void *>(src.data()), 0xcd, src.size() * sizeof(std::max_align_t));
+	auto *relocated = reinterpret_cast<const C *>(reinterpret_cast<const std::byte *>(dst.data()) + (reinterpret_cast<const std::byte *>(c) - reinterpret_cast<const std::byte *>(src.data())));
+	check_contents<Ops>(*relocated, n);
+}
+
+template<typename Ops, typename C, typename F>
+static void test_fancy_container(F fill_func) noexcept
+{
+	test_offset_ptr<Ops, C>(fill_func);
+	test_relocate<Ops, C>(fill_func);
+}
+
+void test_fancy_pointer() noexcept
+{
+	const auto fill_set = [](auto &c, int n) { fill<set_ops>(c, n); };
+	const auto fill_map = [](auto &c, int n) { fill<map_ops>(c, n); };
+	const auto fill_mset = [](auto &c, int n) { fill_multi<multi_ops>(c, n); };
+	const auto fill_mmap = [](auto &c, int n) { fill_multi<multimap_ops>(c, n); };
+
+	test_fancy_container<set_ops, tpp::sparse_set<int, std::hash<int>, std::equal_to<int>, offset_allocator<int>>>(fill_set);
+	test_fancy_container<map_ops, tpp::sparse_map<int, int, std::hash<int>, std::equal_to<int>, offset_allocator<std::pair<int, int>>>>(fill_map);
+	test_fancy_container<set_ops, tpp::ordered_sparse_set<int, std::hash<int>, std::equal_to<int>, offset_allocator<int>>>(fill_set);
+	test_fancy_container<map_ops, tpp::ordered_sparse_map<int, int, std::hash<int>, std::equal_to<int>, offset_allocator<std::pair<int, int>>>>(fill_map);
+
+	test_fancy_container<set_ops, tpp::stable_set<int, std::hash<int>, std::equal_to<int>, offset_allocator<int>>>(fill_set);
+	test_fancy_container<map_ops, tpp::stable_map<int, int, std::hash<int>, std::equal_to<int>, offset_allocator<std::pair<int, int>>>>(fill_map);
+	test_fancy_container<set_ops, tpp::ordered_stable_set<int, std::hash<int>, std::equal_to<int>, offset_allocator<int>>>(fill_set);
+	test_fancy_container<map_ops, tpp::ordered_stable_map<int, int, std::hash<int>, std::equal_to<int>, offset_allocator<std::pair<int, int>>>>(fill_map);
+
+	test_fancy_container<map_ops, tpp::cow_map<int, int, std::hash<int>, std::equal_to<int>, offset_allocator<std::pair<const int, int>>>>(fill_map);
+
+	test_fancy_container<set_ops, tpp::dense_set<int, std::hash<int>, std::equal_to<int>, offset_allocator<int>>>(fill_set);
+	test_fancy_container<map_ops, tpp::dense_map<int, int, std::hash<int>, std::equal_to<int>, offset_allocator<std::pair<int, int>>>>(fill_map);
+	test_fancy_container<set_ops, tpp::ordered_dense_set<int, std::hash<int>, std::equal_to<int>, offset_allocator<int>>>(fill_set);
+	test_fancy_container<map_ops, tpp::ordered_dense_map<int, int, std::hash<int>, std::equal_to<int>, offset_allocator<std::pair<int, int>>>>(fill_map);
+
+	using mk = tpp::multikey<int, long>;
+	using mk_hash = tpp::_detail::multikey_hash<mk>;
+	using mk_eq = tpp::_detail::multikey_eq<mk>;
+	test_fancy_container<multi_ops, tpp::dense_multiset<mk, mk_hash, mk_eq, offset_allocator<std::tuple<int, long>>>>(fill_mset);
+	test_fancy_container<multimap_ops, tpp::dense_multimap<mk, int, mk_hash, mk_eq, offset_allocator<std::pair<std::tuple<int, long>, int>>>>(fill_mmap);
+}
@@ -0,0 +1,406 @@
+/*
+ * Created by switchblade on 2023-01-20.
+ */
+
+#include "tests.hpp"
+
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <list>
+#include <atomic>
+
+#include <tpp/concurrent_insert_set.hpp>
+#include <tpp/concurrent_read_map.hpp>
+#include <tpp/sharded_map.hpp>
+#include <tpp/sparse_map.hpp>
+#include <tpp/sparse_set.hpp>
+#include <tpp/stable_map.hpp>
+#include <tpp/stable_set.hpp>
+#include <tpp/dense_map.hpp>
+#include <tpp/dense_set.hpp>
+#include <tpp/parallel.hpp>
+
+template<typename Table>
+static void test_sharded() noexcept
+{
+	constexpr std::size_t thread_count = 4;
+	constexpr std::size_t per_thread = 1000;
+
+	tpp::sharded_map<Table, 8> map;
+	TEST_ASSERT(map.empty());
+	TEST_ASSERT(!map.find(0).has_value());
+
+	/* Concurrently insert disjoint key ranges while other threads read the keys. */
+	{
+		std::atomic<std::size_t> found = 0;
+		std::vector<std::thread> threads;
+		for (std::size_t i = 0; i < thread_count; ++i)
+		{
+			threads.emplace_back([&map, i]()
+			                     {
+				                     for (std::size_t j = i * per_thread; j < (i + 1) * per_thread; ++j)
+					                     TEST_ASSERT(map.try_emplace(j, std::to_string(j)));
+			                     });
+			threads.emplace_back([&map, &found, i]()
+			                     {
+				                     for (std::size_t j = i * per_thread; j < (i + 1) * per_thread; ++j)
+					                     map.cvisit(j, [&](const auto &value)
+					                     {
+						                     TEST_ASSERT(value.second == std::to_string(value.first));
+						                     found.fetch_add(1, std::memory_order_relaxed);
+					                     });
+			                     });
+		}
+		for (auto &thread: threads) thread.join();
+		TEST_ASSERT(found <= thread_count * per_thread);
+	}
+
+	TEST_ASSERT(map.size() == thread_count * per_thread);
+	for (std::size_t j = 0; j < thread_count * per_thread; ++j)
+	{
+		TEST_ASSERT(map.contains(j));
+		TEST_ASSERT(map.find(j) == std::to_string(j));
+		TEST_ASSERT(!map.try_emplace(j, std::string{}));
+	}
+
+	/* Mutable visit is applied to the stored element. */
+	TEST_ASSERT(map.visit(0, [](auto &&value) { value.second = "zero"; }));
+	TEST_ASSERT(map.find(0) == "zero");
+	TEST_ASSERT(!map.visit(thread_count * per_thread, [](auto &&) { TEST_ASSERT(false); }));
+
+	/* Concurrently erase odd keys. */
+	{
+		std::vector<std::thread> threads;
+		for (std::size_t i = 0; i < thread_count; ++i)
+			threads.emplace_back([&map, i]()
+			                     {
+				                     for (std::size_t j = i * per_thread + 1; j < (i + 1) * per_thread; j += 2)
+					                     TEST_ASSERT(map.erase(j) == 1);
+			                     });
+		for (auto &thread: threads) thread.join();
+	}
+
+	TEST_ASSERT(map.size() == thread_count * per_thread / 2);
+	TEST_ASSERT(map.erase(1) == 0);
+	TEST_ASSERT(!map.contains(1));
+
+	std::size_t visited = 0;
+	map.cvisit_all([&](const auto &value)
+	               {
+		               TEST_ASSERT(value.first % 2 == 0);
+		               ++visited;
+	               });
+	TEST_ASSERT(visited == map.size());
+
+	TEST_ASSERT(map.erase_if([](const auto &value) { return value.first % 4 == 0; }) == thread_count * per_thread / 4);
+	TEST_ASSERT(map.size() == thread_count * per_thread / 4);
+
+	map.clear();
+	TEST_ASSERT(map.empty());
+}
+
+void test_sharded_map() noexcept
+{
+	test_sharded<tpp::sparse_map<std::size_t, std::string>>();
+	test_sharded<tpp::dense_map<std::size_t, std::string>>();
+	test_sharded<tpp::ordered_dense_map<std::size_t, std::string>>();
+}
+
+void test_concurrent_read_map() noexcept
+{
+	constexpr std::size_t reader_count = 3;
+	constexpr std::size_t key_count = 2000;
+	constexpr std::size_t stable_count = 100;
+	constexpr std::size_t rounds = 4;
+
+	tpp::concurrent_read_map<std::size_t, std::string> map;
+	TEST_ASSERT(map.empty());
+	TEST_ASSERT(!map.find(0).has_value());
+	TEST_ASSERT(!map.contains(0));
+
+	/* Keys in range [key_count, key_count + stable_count) are never erased, and are only replaced with increasing values. */
+	for (std::size_t k = key_count; k < key_count + stable_count; ++k)
+		TEST_ASSERT(map.try_emplace(k, std::to_string(k)));
+
+	/* Mapped values of key `k` are always `k + n * key_count` (as a string), which readers verify while the single writer
+	 * inserts, replaces & erases elements, causing the table to be rehashed. Stable keys must always be found, and their
+	 * values must never go back to one replaced earlier. */
+	{
+		std::atomic<bool> done = false;
+		std::vector<std::thread> readers;
+		for (std::size_t i = 0; i < reader_count; ++i)
+			readers.emplace_back([&map, &done]()
+			                     {
+				                     std::vector<std::size_t> last_seen(stable_count, 0);
+				                     while (!done.load(std::memory_order_acquire))
+				                     {
+					                     for (std::size_t k = 0; k < key_count; ++k)
+					                     {
+						                     if (const auto value = map.find(k); value.has_value())
+							                     TEST_ASSERT(std::stoull(*value) % key_count == k);
+						                     map.visit(k, [&](const auto &entry)
+						                     {
+							                     TEST_ASSERT(entry.first == k);
+							                     TEST_ASSERT(std::stoull(entry.second) % key_count == k);
+						                     });
+					                     }
+					                     for (std::size_t k = key_count; k < key_count + stable_count; ++k)
+					                     {
+						                     const auto value = map.find(k);
+						                     TEST_ASSERT(value.has_value());
+
+						                     const auto v = std::stoull(*value);
+						                     TEST_ASSERT(v % key_count == k % key_count && v >= last_seen[k - key_count]);
+						                     last_seen[k - key_count] = v;
+					                     }
+				                     }
+				                     map.visit_all([](const auto &entry) { TEST_ASSERT(std::stoull(entry.second) % key_count == entry.first % key_count); });
+			                     });
+
+		for (std::size_t n = 0; n < rounds; ++n)
+		{
+			for (std::size_t k = 0; k < key_count; ++k)
+				TEST_ASSERT(map.try_emplace(k, std::to_string(k + n * key_count)) == (n == 0 || k % 2 != 0));
+			for (std::size_t k = 0; k < key_count; ++k)
+				TEST_ASSERT(!map.insert_or_assign(k, std::to_string(k + (n + 1) * key_count)));
+			for (std::size_t k = 0; k < key_count; k += 2)
+				TEST_ASSERT(map.erase(k) == 1);
+			for (std::size_t k = 0; k < key_count; k += 2)
+				TEST_ASSERT(map.insert_or_assign(k, std::to_string(k)));
+			for (std::size_t k = 1; k < key_count; k += 2)
+				TEST_ASSERT(map.erase(k) == 1);
+			for (std::size_t k = key_count; k < key_count + stable_count; ++k)
+				TEST_ASSERT(!map.insert_or_assign(k, std::to_string(k + (n + 1) * key_count)));
+		}
+		done.store(true, std::memory_order_release);
+		for (auto &reader: readers) reader.join();
+	}
+
+	TEST_ASSERT(map.size() == key_count / 2 + stable_count);
+	for (std::size_t k = 0; k < key_count; ++k)
+	{
+		TEST_ASSERT(map.contains(k) == (k % 2 == 0));
+		if (k % 2 == 0) TEST_ASSERT(map.find(k) == std::to_string(k));
+	}
+	for (std::size_t k = key_count; k < key_count + stable_count; ++k)
+		TEST_ASSERT(map.find(k) == std::to_string(k + rounds * key_count));
+
+	map.reserve(key_count * 4);
+	TEST_ASSERT(map.capacity() >= key_count * 4);
+	TEST_ASSERT(map.size() == key_count / 2 + stable_count);
+	TEST_ASSERT(map.find(0) == "0");
+
+	map.clear();
+	map.reclaim();
+	TEST_ASSERT(map.empty());
+	TEST_ASSERT(!map.contains(0));
+	TEST_ASSERT(map.try_emplace(0, "0"));
+	TEST_ASSERT(map.find(0) == "0");
+}
+
+void test_concurrent_insert_set() noexcept
+{
+	constexpr std::size_t thread_count = 4;
+	constexpr std::size_t value_count = 5000;
+
+	/* Every thread inserts the same (overlapping) range of values, so that only one insert of every value succeeds. */
+	{
+		tpp::concurrent_insert_set<std::uint64_t> set{value_count};
+		TEST_ASSERT(set.empty());
+		TEST_ASSERT(set.capacity() >= value_count);
+
+		std::atomic<std::size_t> inserted = 0;
+		std::vector<std::thread> threads;
+		for (std::size_t i = 0; i < thread_count; ++i)
+			threads.emplace_back([&set, &inserted, i]()
+			                     {
+				                     for (std::size_t j = 0; j < value_count; ++j)
+				                     {
+					                     const auto value = static_cast<std::uint64_t>((j + i * 7) % value_count) * 0x9e3779b97f4a7c15ull;
+					                     if (set.insert(value)) inserted.fetch_add(1, std::memory_order_relaxed);
+					                     TEST_ASSERT(set.contains(value));
+				                     }
+			                     });
+		for (auto &thread: threads) thread.join();
+
+		TEST_ASSERT(inserted == value_count);
+		TEST_ASSERT(set.size() == value_count);
+		for (std::size_t j = 0; j < value_count; ++j)
+		{
+			TEST_ASSERT(set.contains(j * 0x9e3779b97f4a7c15ull));
+			TEST_ASSERT(!set.insert(j * 0x9e3779b97f4a7c15ull));
+		}
+		TEST_ASSERT(!set.contains(value_count * 0x9e3779b97f4a7c15ull));
+
+		std::size_t visited = 0;
+		set.visit_all([&](std::uint64_t) { ++visited; });
+		TEST_ASSERT(visited == value_count);
+
+		set.clear();
+		TEST_ASSERT(set.empty());
+		TEST_ASSERT(!set.contains(0));
+	}
+
+	/* Inserting past the capacity of the set fails. */
+	{
+		tpp::concurrent_insert_set<std::string> set{4};
+		for (std::size_t i = 0; i < set.capacity(); ++i)
+			TEST_ASSERT(set.insert(std::to_string(i)));
+		TEST_ASSERT(!set.insert("0"));
+		TEST_ASSERT(set.size() == set.capacity());
+
+		bool failed = false;
+		try { set.insert(std::to_string(set.capacity())); }
+		catch (std::length_error &) { failed = true; }
+		TEST_ASSERT(failed);
+	}
+}
+
+template<typename Map>
+static void test_parallel_map(const tpp::thread_executor &exec) noexcept
+{
+	constexpr int unique_count = 60000;
+	constexpr int value_count = 100000;
+
+	/* Every key is repeated with different values, the first occurrence must win. */
+	std::vector<std::pair<int, int>> values;
+	for (int i = 0; i < value_count; ++i)
+		values.emplace_back(i % unique_count, i);
+
+	auto map = Map::from_range(exec, values.begin(), values.end());
+	TEST_ASSERT(map.size() == unique_count);
+	for (int i = 0; i < unique_count; ++i)
+	{
+		const auto pos = map.find(i);
+		TEST_ASSERT(pos != map.end() && pos->second == i);
+	}
+
+	/* Parallel rehash preserves all elements. */
+	map.reserve(map.size() * 4, exec);
+	TEST_ASSERT(map.size() == unique_count);
+	map.rehash(map.bucket_count() * 2, 4);
+	TEST_ASSERT(map.size() == unique_count);
+	for (int i = 0; i < unique_count; ++i)
+		TEST_ASSERT(map.at(i) == i);
+
+	/* Bulk insertion into a non-empty map with erased entries keeps existing elements. */
+	for (int i = 0; i < unique_count; i += 2) map.erase(i);
+	map.insert(exec, values.begin(), values.end());
+	TEST_ASSERT(map.size() == unique_count);
+	for (int i = 0; i < unique_count; ++i)
+		TEST_ASSERT(map.at(i) == i);
+
+	/* Non-random-access ranges are inserted sequentially. */
+	const auto list = std::list<std::pair<int, int>>{values.begin(), values.end()};
+	const auto copy = Map::from_range(exec, list.begin(), list.end());
+	TEST_ASSERT(copy.size() == unique_count);
+	for (int i = 0; i < unique_count; ++i)
+		TEST_ASSERT(copy.at(i) == i);
+}
+
+void test_parallel_build() noexcept
+{
+	const auto exec = tpp::thread_executor{4};
+	test_parallel_map<tpp::sparse_map<int, int>>(exec);
+	test_parallel_map<tpp::stable_map<int, int>>(exec);
+
+	/* Non-trivial elements & executors that run tasks sequentially. */
+	{
+		std::vector<std::string> values;
+		for (std::size_t i = 0; i < 50000; ++i)
+			values.push_back(std::to_string(i % 20000));
+
+		const auto set = tpp::sparse_set<std::string>::from_range(tpp::thread_executor{1}, values.begin(), values.end());
+		TEST_ASSERT(set.size() == 20000);
+
+		auto other = tpp::stable_set<std::string>::from_range(exec, values.begin(), values.end());
+		TEST_ASSERT(other.size() == 20000);
+		other.rehash(other.bucket_count() * 4, exec);
+		for (std::size_t i = 0; i < 20000; ++i)
+			TEST_ASSERT(set.contains(std::to_string(i)) && other.contains(std::to_string(i)));
+	}
+
+	/* Elements constructed before an exception is thrown are kept. */
+	{
+		struct throwing
+		{
+			throwing(int value) : value(value) {}
+			throwing(const throwing &other) : value(other.value) { if (value == 777) throw std::runtime_error("throwing"); }
+			throwing(throwing &&other) noexcept : value(other.value) {}
+			throwing &operator=(const throwing &) = default;
+			throwing &operator=(throwing &&) noexcept = default;
+
+			int value;
+		};
+
+		std::vector<std::pair<int, throwing>> values;
+		for (int i = 0; i < 50000; ++i)
+			values.emplace_back(i, i);
+
+		tpp::sparse_map<int, throwing> map;
+		bool failed = false;
+		try { map.insert(exec, values.begin(), values.end()); }
+		catch (std::runtime_error &) { failed = true; }
+		TEST_ASSERT(failed);
+		TEST_ASSERT(!map.contains(777));
+
+		std::size_t visited = 0;
+		for (const auto &value: map)
+		{
+			TEST_ASSERT(value.first == value.second.value);
+			++visited;
+		}
+		TEST_ASSERT(visited == map.size());
+	}
+}
+
+template<typename Map>
+static void test_parallel_scan_map() noexcept
+{
+	constexpr std::uint64_t value_count = 20000;
+	const auto exec = tpp::thread_executor{4};
+
+	Map map;
+	TEST_ASSERT(map.split(4).size() == 1);
+	TEST_ASSERT(map.split(4).front().empty());
+	TEST_ASSERT(tpp::parallel_reduce(map, std::uint64_t{7}, std::plus<>{}, [](auto &&) { return std::uint64_t{1}; }, exec) == 7);
+
+	for (std::uint64_t i = 0; i < value_count; ++i) map.emplace(i, i * 3);
+
+	/* Sub-ranges are disjoint and cover the whole map. */
+	const auto ranges = std::as_const(map).split(16);
+	TEST_ASSERT(!ranges.empty() && ranges.size() <= 16);
+
+	std::vector<bool> visited(value_count);
+	for (auto &range: ranges)
+		for (auto &&value: range)
+		{
+			TEST_ASSERT(!visited[value.first]);
+			visited[value.first] = true;
+		}
+	TEST_ASSERT(std::find(visited.begin(), visited.end(), false) == visited.end());
+
+	std::atomic<std::uint64_t> sum = 0;
+	tpp::parallel_for_each(map, [&](auto &value) { value.second += 1; }, exec);
+	tpp::parallel_for_each(std::as_const(map), [&](auto &value) { sum.fetch_add(value.second, std::memory_order_relaxed); }, 2);
+	TEST_ASSERT(sum == value_count * (value_count - 1) / 2 * 3 + value_count);
+
+	const auto total = tpp::parallel_reduce(map, std::uint64_t{0}, std::plus<>{}, [](auto &value) { return value.first; }, exec);
+	TEST_ASSERT(total == value_count * (value_count - 1) / 2);
+}
+
+void test_parallel_scan() noexcept
+{
+	test_parallel_scan_map<tpp::sparse_map<std::uint64_t, std::uint64_t>>();
+	test_parallel_scan_map<tpp::stable_map<std::uint64_t, std::uint64_t>>();
+	test_parallel_scan_map<tpp::dense_map<std::uint64_t, std::uint64_t>>();
+
+	tpp::dense_set<std::string> set;
+	for (std::size_t i = 0; i < 1000; ++i) set.insert(std::to_string(i));
+	const auto length = tpp::parallel_reduce(set, std::size_t{0}, std::plus<>{}, [](auto &value) { return value.size(); }, 3);
+	TEST_ASSERT(length == 10 + 90 * 2 + 900 * 3);
+}
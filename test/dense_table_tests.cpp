@@ -14,6 +14,9 @@
 #define TPP_STL_HASH_ALL
 #endif
 
+#include <stdexcept>
+#include <limits>
+
 #include <tpp/dense_set.hpp>
 #include <tpp/dense_map.hpp>
 #include <tpp/dense_multiset.hpp>
@@ -24,19 +27,160 @@ static_assert(std::is_same_v<decltype(tpp::ordered_dense_set{std::declval<std::s
 static_assert(std::is_same_v<decltype(tpp::dense_map{std::declval<std::pair<std::string, int>>()}), tpp::dense_map<std::string, int>>);
 static_assert(std::is_same_v<decltype(tpp::ordered_dense_map{std::declval<std::pair<std::string, int>>()}), tpp::ordered_dense_map<std::string, int>>);
 
-void test_dense_set() noexcept { test_set<tpp::dense_set>(); }
-void test_dense_map() noexcept { test_map<tpp::dense_map>(); }
+template<typename P>
+struct policy_hash : std::hash<std::string> { using bucket_policy = P; };
+template<typename P, typename... Ks>
+struct multikey_policy_hash : tpp::_detail::multikey_hash<tpp::multikey<Ks...>> { using bucket_policy = P; };
+template<typename... Ks>
+struct multikey_index32_hash : tpp::_detail::multikey_hash<tpp::multikey<Ks...>> { using index_type = std::uint32_t; };
+struct index32_hash : std::hash<std::string> { using index_type = std::uint32_t; };
+struct index16_hash : std::hash<int> { using index_type = std::uint16_t; };
+template<typename P>
+struct int_policy_hash : std::hash<int> { using bucket_policy = P; };
+
+static_assert(std::is_same_v<tpp::_detail::bucket_policy_t<std::hash<std::string>>, tpp::pow2_bucket_policy>);
+static_assert(std::is_same_v<tpp::_detail::bucket_policy_t<policy_hash<tpp::prime_bucket_policy>>, tpp::prime_bucket_policy>);
+#ifdef __cpp_lib_ranges
+static_assert(std::random_access_iterator<tpp::strided_view<const int>::iterator>);
+static_assert(std::ranges::random_access_range<tpp::strided_view<double>>);
+#endif
+
+void test_dense_set() noexcept
+{
+	test_set<tpp::dense_set>();
+	test_set<tpp::dense_set, tpp::dense_set<std::string, policy_hash<tpp::fastrange_bucket_policy>>>();
+	test_set<tpp::dense_set, tpp::dense_set<std::string, policy_hash<tpp::prime_bucket_policy>>>();
+	test_set<tpp::dense_set, tpp::dense_set<std::string, policy_hash<tpp::open_bucket_policy>>>();
+	test_set<tpp::dense_set, tpp::dense_set<std::string, index32_hash>>();
+	test_view_set<tpp::dense_set>();
+	test_erase_if_set<tpp::dense_set>();
+}
+void test_dense_map() noexcept
+{
+	test_map<tpp::dense_map>();
+	test_map<tpp::dense_map, tpp::dense_map<std::string, int, policy_hash<tpp::fastrange_bucket_policy>>>();
+	test_map<tpp::dense_map, tpp::dense_map<std::string, int, policy_hash<tpp::prime_bucket_policy>>>();
+	test_map<tpp::dense_map, tpp::dense_map<std::string, int, policy_hash<tpp::open_bucket_policy>>>();
+	test_map<tpp::dense_map, tpp::dense_map<std::string, int, index32_hash>>();
+	test_view_map<tpp::dense_map>();
+	test_emplace_map<tpp::dense_map>();
+	test_erase_if_map<tpp::dense_map>();
+	test_erase_if_map<tpp::dense_map, tpp::dense_map<int, double, int_policy_hash<tpp::open_bucket_policy>>>();
+
+	/* Size of the table is limited by the range of the index type. */
+	{
+		auto map = tpp::dense_map<int, int, index16_hash>{};
+		const auto max_size = static_cast<int>(map.max_size());
+		TEST_ASSERT(max_size < std::numeric_limits<std::uint16_t>::max());
+
+		bool thrown = false;
+		try { map.reserve(map.max_size() + 1); }
+		catch (const std::length_error &) { thrown = true; }
+		TEST_ASSERT(thrown && map.empty());
+
+		for (int i = 0; i < max_size; ++i) TEST_ASSERT(map.emplace(i, i).second);
+		thrown = false;
+		try { map.emplace(max_size, max_size); }
+		catch (const std::length_error &) { thrown = true; }
+		TEST_ASSERT(thrown);
+		TEST_ASSERT(!map.emplace(0, 0).second);
+
+		TEST_ASSERT(map.size() == map.max_size() && !map.contains(max_size));
+		for (int i = 0; i < max_size; ++i) TEST_ASSERT(map.contains(i) && map.at(i) == i);
+	}
+}
 
 void test_ordered_dense_set() noexcept
 {
 	test_set<tpp::ordered_dense_set>();
 	test_ordered_set<tpp::ordered_dense_set>();
+	test_compact_set<tpp::ordered_dense_set>();
+	test_view_set<tpp::ordered_dense_set>();
+	test_erase_if_set<tpp::ordered_dense_set>();
+
+	using open_set_t = tpp::ordered_dense_set<std::string, policy_hash<tpp::open_bucket_policy>>;
+	test_ordered_set<tpp::ordered_dense_set, open_set_t>();
+	test_compact_set<tpp::ordered_dense_set, open_set_t>();
 }
 void test_ordered_dense_map() noexcept
 {
 	test_map<tpp::ordered_dense_map>();
 	test_ordered_map<tpp::ordered_dense_map>();
+	test_compact_map<tpp::ordered_dense_map>();
+	test_view_map<tpp::ordered_dense_map>();
+	test_emplace_map<tpp::ordered_dense_map>();
+	test_erase_if_map<tpp::ordered_dense_map>();
+
+	using open_map_t = tpp::ordered_dense_map<std::string, int, policy_hash<tpp::open_bucket_policy>>;
+	test_ordered_map<tpp::ordered_dense_map, open_map_t>();
+	test_compact_map<tpp::ordered_dense_map, open_map_t>();
 }
 
-void test_dense_multiset() noexcept { test_multiset<tpp::dense_multiset>(); }
-void test_dense_multimap() noexcept { test_multimap<tpp::dense_multimap>(); }
+void test_dense_multiset() noexcept
+{
+	test_multiset<tpp::dense_multiset>();
+
+	using open_hash = multikey_policy_hash<tpp::open_bucket_policy, std::string, int>;
+	test_multiset<tpp::dense_multiset, tpp::dense_multiset<tpp::multikey<std::string, int>, open_hash>>();
+
+	using mk_index32_hash = multikey_index32_hash<std::string, int>;
+	test_multiset<tpp::dense_multiset, tpp::dense_multiset<tpp::multikey<std::string, int>, mk_index32_hash>>();
+
+	test_lazy_multiset<tpp::dense_multiset>();
+	test_lazy_multiset<tpp::dense_multiset, tpp::dense_multiset<tpp::multikey<std::string, tpp::lazy_key<int>>, open_hash>>();
+}
+/* Tables past the parallel index threshold rebuild indices of different keys on separate threads. */
+template<typename Map>
+static void test_parallel_index() noexcept
+{
+	constexpr int value_count = 100000;
+
+	std::vector<typename Map::insert_type> values;
+	for (int i = 0; i < value_count; ++i)
+		values.push_back({{std::to_string(i), i, static_cast<std::uint64_t>(i) * 3}, i});
+	/* Elements that conflict with any of the previous keys are not inserted. */
+	values.push_back({{"conflict", value_count, 0}, -1});
+	values.push_back({{std::to_string(value_count), 0, 1}, -1});
+
+	const auto check = [&](const Map &map)
+	{
+		TEST_ASSERT(map.size() == value_count);
+		for (int i = 0; i < value_count; i += 7)
+		{
+			const auto pos = map.template find<0>(std::to_string(i));
+			TEST_ASSERT(pos != map.end() && pos->second == i);
+			TEST_ASSERT(map.template find<1>(i) == pos);
+			TEST_ASSERT(map.template find<2>(static_cast<std::uint64_t>(i) * 3) == pos);
+		}
+		TEST_ASSERT(!map.template contains<0>("conflict"));
+	};
+
+	Map map;
+	map.insert(values.begin(), values.end());
+	check(map);
+
+	map.rehash(map.bucket_count() * 2);
+	check(map);
+	check(Map{map});
+
+	auto moved = Map{std::move(map), typename Map::allocator_type{}};
+	check(moved);
+}
+
+void test_dense_multimap() noexcept
+{
+	test_multimap<tpp::dense_multimap>();
+
+	using open_hash = multikey_policy_hash<tpp::open_bucket_policy, std::string, int>;
+	test_multimap<tpp::dense_multimap, tpp::dense_multimap<tpp::multikey<std::string, int>, float, open_hash>>();
+
+	using mk_index32_hash = multikey_index32_hash<std::string, int>;
+	test_multimap<tpp::dense_multimap, tpp::dense_multimap<tpp::multikey<std::string, int>, float, mk_index32_hash>>();
+
+	test_lazy_multimap<tpp::dense_multimap>();
+	test_lazy_multimap<tpp::dense_multimap, tpp::dense_multimap<tpp::multikey<std::string, tpp::lazy_key<int>>, float, open_hash>>();
+
+	test_parallel_index<tpp::dense_multimap<tpp::multikey<std::string, int, std::uint64_t>, int>>();
+	using open_hash3 = multikey_policy_hash<tpp::open_bucket_policy, std::string, int, std::uint64_t>;
+	test_parallel_index<tpp::dense_multimap<tpp::multikey<std::string, int, std::uint64_t>, int, open_hash3>>();
+}
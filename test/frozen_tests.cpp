@@ -0,0 +1,160 @@
+/*
+ * Created by switchblade on 2023-01-28.
+ */
+
+#include "tests.hpp"
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tpp/frozen_map.hpp>
+#include <tpp/frozen_set.hpp>
+#include <tpp/sparse_map.hpp>
+#include <tpp/sparse_set.hpp>
+#include <tpp/stable_map.hpp>
+#include <tpp/dense_map.hpp>
+
+/* Hash that maps all keys to the same value. */
+struct constant_hash
+{
+	std::size_t operator()(int) const noexcept { return 0; }
+};
+
+template<typename M>
+static void check_frozen_map(const M &frozen, int n)
+{
+	TEST_ASSERT(frozen.size() == static_cast<std::size_t>(n));
+	TEST_ASSERT(frozen.bucket_count() >= frozen.size());
+
+	std::size_t count = 0;
+	for (auto &value: frozen)
+	{
+		TEST_ASSERT(value.second == value.first * 2);
+		++count;
+	}
+	TEST_ASSERT(count == frozen.size());
+
+	for (int i = 0; i < n; ++i)
+	{
+		TEST_ASSERT(frozen.contains(i));
+		TEST_ASSERT(frozen.find(i)->first == i);
+		TEST_ASSERT(frozen.at(i) == i * 2);
+	}
+	for (int i = n; i < n * 2; ++i)
+	{
+		TEST_ASSERT(!frozen.contains(i));
+		TEST_ASSERT(frozen.find(i) == frozen.end());
+	}
+	TEST_ASSERT(!frozen.contains(-1));
+}
+
+void test_frozen() noexcept
+{
+	constexpr int n = 10000;
+
+	auto sparse = tpp::sparse_map<int, int>{};
+	auto dense = tpp::dense_map<int, int>{};
+	auto stable = tpp::stable_map<int, int>{};
+	for (int i = 0; i < n; ++i)
+	{
+		sparse.emplace(i, i * 2);
+		dense.emplace(i, i * 2);
+		stable.emplace(i, i * 2);
+	}
+	check_frozen_map(tpp::freeze(sparse), n);
+	check_frozen_map(tpp::freeze(dense), n);
+	check_frozen_map(tpp::freeze(stable), n);
+
+	/* Small maps & maps of non-trivial types. */
+	for (int i = 0; i < 70; ++i)
+	{
+		auto values = std::vector<std::pair<int, int>>{};
+		for (int j = 0; j < i; ++j) values.emplace_back(j, j * 2);
+		check_frozen_map(tpp::frozen_map<int, int>{values.begin(), values.end()}, i);
+	}
+	{
+		auto strings = tpp::sparse_map<std::string, std::string>{};
+		for (int i = 0; i < 1000; ++i) strings.emplace(std::to_string(i), std::to_string(i * 2));
+		const auto frozen = tpp::freeze(strings);
+		TEST_ASSERT(frozen.size() == strings.size());
+		for (int i = 0; i < 1000; ++i) TEST_ASSERT(frozen.at(std::to_string(i)) == std::to_string(i * 2));
+		TEST_ASSERT(!frozen.contains("") && !frozen.contains("1000"));
+	}
+
+	/* Duplicate keys keep the first element, while colliding hashes are rejected. */
+	{
+		const auto frozen = tpp::frozen_map<int, int>{{1, 2}, {2, 4}, {1, 3}, {3, 6}, {2, 5}};
+		TEST_ASSERT(frozen.size() == 3);
+		TEST_ASSERT(frozen.at(1) == 2 && frozen.at(2) == 4 && frozen.at(3) == 6);
+
+		bool thrown = false;
+		try { tpp::frozen_set<int, constant_hash>{1, 2}; }
+		catch (const std::invalid_argument &) { thrown = true; }
+		TEST_ASSERT(thrown);
+		TEST_ASSERT((tpp::frozen_set<int, constant_hash>{1, 1}.size() == 1));
+	}
+
+	/* Empty tables. */
+	{
+		const auto frozen = tpp::freeze(tpp::sparse_map<int, int>{});
+		TEST_ASSERT(frozen.empty() && frozen.begin() == frozen.end());
+		TEST_ASSERT(!frozen.contains(0));
+
+		std::stringstream ss;
+		frozen.save(ss);
+		auto loaded = tpp::frozen_map<int, int>{{1, 2}};
+		loaded.load(ss);
+		TEST_ASSERT(loaded.empty() && !loaded.contains(1));
+	}
+
+	/* Sets. */
+	{
+		auto set = tpp::sparse_set<int>{};
+		for (int i = 0; i < n; i += 2) set.insert(i);
+		auto frozen = tpp::freeze(set);
+		TEST_ASSERT(frozen.size() == set.size());
+		for (int i = 0; i < n; ++i) TEST_ASSERT(frozen.contains(i) == (i % 2 == 0));
+
+		std::size_t count = 0;
+		for (auto key: frozen) count += set.contains(key);
+		TEST_ASSERT(count == set.size());
+	}
+
+	/* Snapshots are loaded without re-building the hash function. */
+	{
+		const auto frozen = tpp::freeze(sparse);
+		std::stringstream ss;
+		frozen.save(ss);
+
+		auto loaded = tpp::frozen_map<int, int>{};
+		loaded.load(ss);
+		TEST_ASSERT(loaded.bucket_count() == frozen.bucket_count());
+		check_frozen_map(loaded, n);
+
+		/* Corrupted snapshots must be rejected, leaving the map unchanged. */
+		const auto data = ss.str();
+		const auto reject = [&](std::string corrupted)
+		{
+			auto target = tpp::frozen_map<int, int>{{1, 2}};
+			std::stringstream is{std::move(corrupted)};
+			bool thrown = false;
+			try { target.load(is); }
+			catch (const tpp::snapshot_error &) { thrown = true; }
+			TEST_ASSERT(thrown);
+			TEST_ASSERT(target.size() == 1 && target.at(1) == 2);
+		};
+		reject(data.substr(0, data.size() - 1));
+
+		/* Size of the table is at offset 40 of the header. */
+		auto corrupted = data;
+		++corrupted[40];
+		reject(corrupted);
+
+		/* Modified pilot no longer maps elements of the bucket to their slots. */
+		corrupted = data;
+		corrupted[sizeof(tpp::_detail::snapshot_header)] ^= 1;
+		reject(corrupted);
+	}
+}
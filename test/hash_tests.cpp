@@ -0,0 +1,296 @@
+/*
+ * Created by switchblade on 2023-01-30.
+ */
+
+#include "tests.hpp"
+
+#include <string_view>
+#include <functional>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+
+#include <tpp/seeded_hash.hpp>
+#include <tpp/sharded_map.hpp>
+#include <tpp/sparse_map.hpp>
+#include <tpp/stable_map.hpp>
+#include <tpp/dense_set.hpp>
+#include <tpp/dense_map.hpp>
+
+/* Transparent comparator of strings & string views. */
+struct string_eq
+{
+	using is_transparent = std::true_type;
+
+	bool operator()(std::string_view a, std::string_view b) const noexcept { return a == b; }
+};
+
+using hash_bytes_func = std::uint64_t (*)(const unsigned char *, std::size_t, std::uint64_t);
+
+/* Chi-squared statistic of a histogram must not exceed the mean by more than 6 standard deviations. */
+static bool is_uniform(const std::vector<std::size_t> &histogram, std::size_t samples)
+{
+	const auto expected = static_cast<double>(samples) / static_cast<double>(histogram.size());
+	double chi2 = 0;
+	for (auto n: histogram)
+	{
+		const auto diff = static_cast<double>(n) - expected;
+		chi2 += diff * diff / expected;
+	}
+	const auto dof = static_cast<double>(histogram.size() - 1);
+	return chi2 < dof + 6 * std::sqrt(2 * dof);
+}
+
+/* Swiss tables use the low 7 bits of a hash as the metadata tag (H2), and the remaining bits as the probe position (H1),
+ * thus both must be distributed uniformly, including for keys that only differ in a few bits. */
+template<typename F>
+static bool check_distribution(std::size_t samples, F hash)
+{
+	std::vector<std::size_t> h2(128), h1_low(1024), h1_high(1024);
+	for (std::size_t i = 0; i < samples; ++i)
+	{
+		const auto h = static_cast<std::uint64_t>(hash(i));
+		++h2[h & 0x7f];
+		++h1_low[(h >> 7) & 1023];
+		++h1_high[h >> 54];
+	}
+	return is_uniform(h2, samples) && is_uniform(h1_low, samples) && is_uniform(h1_high, samples);
+}
+/* Flipping any bit of the input must flip every bit of the hash with probability close to 1/2. */
+static bool check_avalanche(std::size_t n, hash_bytes_func hash)
+{
+	constexpr std::size_t samples = 256;
+	std::vector<unsigned char> data(n);
+	std::uint64_t state = 0x1234'5678'9abc'def0ull;
+
+	for (std::size_t bit = 0; bit < n * 8; ++bit)
+	{
+		std::array<std::size_t, 64> flips = {};
+		for (std::size_t i = 0; i < samples; ++i)
+		{
+			for (auto &b: data) b = static_cast<unsigned char>((state = state * 6364136223846793005ull + 1442695040888963407ull) >> 56);
+			const auto a = hash(data.data(), n, 0);
+			data[bit / 8] ^= static_cast<unsigned char>(1 << (bit % 8));
+			const auto diff = a ^ hash(data.data(), n, 0);
+			for (std::size_t j = 0; j < 64; ++j) flips[j] += (diff >> j) & 1;
+		}
+		for (auto f: flips)
+			if (f < samples / 4 || f > samples * 3 / 4) return false;
+	}
+	return true;
+}
+
+static void test_hash_bytes(hash_bytes_func hash)
+{
+	/* Sequential integers, and strings with common prefixes. */
+	TEST_ASSERT(check_distribution(1 << 17, [&](std::size_t i)
+	{
+		const auto value = static_cast<std::uint64_t>(i);
+		unsigned char bytes[8];
+		std::memcpy(bytes, &value, sizeof(value));
+		return hash(bytes, sizeof(bytes), 0);
+	}));
+	for (const std::string prefix: {"", "key_", "/usr/share/very/long/common/prefix/of/a/file/path/that/is/longer/than/64/bytes/"})
+		TEST_ASSERT(check_distribution(1 << 17, [&](std::size_t i)
+		{
+			const auto str = prefix + std::to_string(i);
+			return hash(reinterpret_cast<const unsigned char *>(str.data()), str.size(), 0);
+		}));
+
+	/* Every length class of the implementations. */
+	for (std::size_t n: {1, 3, 4, 7, 8, 12, 16, 17, 31, 33, 48, 49, 64, 65, 100})
+		TEST_ASSERT(check_avalanche(n, hash));
+
+	/* Different lengths & seeds must produce different hashes, including for zero-filled inputs. */
+	const unsigned char zeros[128] = {};
+	std::vector<std::uint64_t> hashes;
+	for (std::size_t n = 0; n <= 128; ++n)
+	{
+		hashes.push_back(hash(zeros, n, 0));
+		hashes.push_back(hash(zeros, n, 1));
+	}
+	std::sort(hashes.begin(), hashes.end());
+	TEST_ASSERT(std::adjacent_find(hashes.begin(), hashes.end()) == hashes.end());
+}
+
+#ifdef TPP_FAST_HASH_X64
+/* Words with equal CRC collide under plain CRC for every initial state, thus the seed must separate them. */
+TPP_TARGET("sse4.2") static void test_crc32c_seed() noexcept
+{
+	/* CRC of a word is zero if it's high half is the CRC of it's low half. */
+	const auto lo = std::uint32_t{0x1234'5678};
+	const auto x = std::uint64_t{0x0123'4567'89ab'cdef}, y = x ^ ((std::uint64_t{_mm_crc32_u32(0, lo)} << 32) | lo), z = x * 3;
+	TEST_ASSERT(x != y && _mm_crc32_u64(0, x) == _mm_crc32_u64(0, y));
+
+	unsigned char a[16], b[16];
+	std::memcpy(a, &x, 8);
+	std::memcpy(b, &y, 8);
+	std::memcpy(a + 8, &z, 8);
+	std::memcpy(b + 8, &z, 8);
+	for (const std::uint64_t seed: {0ull, 1ull, 0xdead'beefull, 0x0123'4567'89ab'cdefull})
+		TEST_ASSERT(tpp::_detail::hash_bytes_crc32c(a, sizeof(a), seed) != tpp::_detail::hash_bytes_crc32c(b, sizeof(b), seed));
+}
+#endif
+
+void test_fast_hash() noexcept
+{
+	test_hash_bytes(tpp::_detail::hash_bytes_portable);
+#ifdef TPP_FAST_HASH_X64
+	if (tpp::_detail::detect_hash_isa() != tpp::_detail::hash_isa::portable)
+	{
+		test_hash_bytes(tpp::_detail::hash_bytes_crc32c);
+		test_crc32c_seed();
+	}
+	if (tpp::_detail::detect_hash_isa() == tpp::_detail::hash_isa::aes)
+		test_hash_bytes(tpp::_detail::hash_bytes_aes);
+#endif
+
+	TEST_ASSERT(check_distribution(1 << 17, [](std::size_t i) { return tpp::fast_hash<std::size_t>{}(i); }));
+	TEST_ASSERT(check_distribution(1 << 17, [](std::size_t i) { return tpp::fast_hash<std::size_t>{}(i << 32); }));
+	TEST_ASSERT(check_distribution(1 << 17, [](std::size_t i) { return tpp::fast_hash<std::int32_t>{}(-static_cast<std::int32_t>(i)); }));
+
+	/* Hashes of strings are consistent between string types. */
+	const auto str = std::string{"hello, world"};
+	TEST_ASSERT(tpp::fast_hash<std::string>{}(str) == tpp::fast_hash<std::string_view>{}(str));
+	TEST_ASSERT(tpp::fast_hash<std::string>{}(str) == tpp::fast_hash<std::string>{}("hello, world"));
+	TEST_ASSERT(tpp::fast_hash<std::wstring>{}(L"hello") != tpp::fast_hash<std::wstring>{}(L"hellp"));
+
+	auto map = tpp::sparse_map<std::string, int, tpp::fast_hash<std::string>, string_eq>{};
+	for (int i = 0; i < 10000; ++i) map.emplace("key_" + std::to_string(i), i);
+	for (int i = 0; i < 10000; ++i)
+	{
+		const auto key = "key_" + std::to_string(i);
+		TEST_ASSERT(map.find(std::string_view{key}) != map.end() && map.find(std::string_view{key})->second == i);
+	}
+	TEST_ASSERT(!map.contains(std::string_view{"key_10000"}));
+
+	struct point { std::int32_t x, y; };
+	using points_t = std::vector<std::int32_t>;
+	TEST_ASSERT(tpp::bytes_hash<point>{}(point{1, 2}) == tpp::bytes_hash<point>{}(point{1, 2}));
+	TEST_ASSERT(tpp::bytes_hash<point>{}(point{1, 2}) != tpp::bytes_hash<point>{}(point{2, 1}));
+	using array_t = std::array<std::int32_t, 3>;
+	const auto array = array_t{1, 2, 3};
+	TEST_ASSERT(tpp::bytes_hash<points_t>{}(points_t(array.begin(), array.end())) == tpp::bytes_hash<array_t>{}(array));
+
+	auto set = tpp::dense_set<points_t, tpp::bytes_hash<points_t>>{};
+	for (std::int32_t i = 0; i < 1000; ++i) set.insert(points_t{i, i % 10});
+	TEST_ASSERT(set.size() == 1000 && set.contains(points_t{13, 3}) && !set.contains(points_t{14, 3}));
+}
+
+/* Hash which makes all keys collide unless the seed is changed from `bad_seed`, as if the keys were crafted against it. */
+struct flood_hash
+{
+	static constexpr std::uint64_t bad_seed = 0x5eed;
+
+	std::size_t operator()(int key, std::uint64_t seed) const noexcept
+	{
+		return seed == bad_seed ? 0 : tpp::fast_hash<int>{}(key, seed);
+	}
+};
+/* Hash which makes all keys collide regardless of the seed. */
+struct constant_hash
+{
+	std::size_t operator()(int) const noexcept { return 42; }
+};
+
+template<typename M>
+static void test_flooded_map()
+{
+	using hash_t = typename M::hasher;
+
+	auto map = M{0, hash_t{flood_hash::bad_seed}};
+	for (int i = 0; i < 4096; ++i) TEST_ASSERT(map.emplace(i, i).second);
+	TEST_ASSERT(map.hash_function().seed() != flood_hash::bad_seed);
+	for (int i = 0; i < 4096; ++i) TEST_ASSERT(map.find(i) != map.end() && map.find(i)->second == i);
+	TEST_ASSERT(!map.contains(4096));
+
+	/* Seed is kept across rehash & copies. */
+	const auto seed = map.hash_function().seed();
+	map.rehash(map.bucket_count() * 4);
+	TEST_ASSERT(map.hash_function().seed() == seed);
+	const auto copy = map;
+	TEST_ASSERT(copy.hash_function().seed() == seed);
+	for (int i = 0; i < 4096; ++i) TEST_ASSERT(copy.contains(i));
+
+	/* Reseeding state is exchanged together with the buffer & the hasher. */
+	const auto flood = [](M &target)
+	{
+		target.rehash(8192);
+		for (int i = 0; i < 512; ++i) TEST_ASSERT(target.emplace(i, i).second);
+		TEST_ASSERT(target.hash_function().seed() != flood_hash::bad_seed);
+	};
+	auto a = M{0, hash_t{flood_hash::bad_seed}}, b = M{0, hash_t{flood_hash::bad_seed}};
+	flood(a);
+	a.swap(b);
+	flood(a);
+	a = M{0, hash_t{flood_hash::bad_seed}};
+	flood(a);
+	const auto flooded = M{0, hash_t{flood_hash::bad_seed}};
+	a = flooded;
+	flood(a);
+}
+
+void test_seeded_hash() noexcept
+{
+	/* Every hasher uses a different seed, and hashes change with the seed. */
+	using string_hash = tpp::seeded_hash<std::string>;
+	const auto a = string_hash{}, b = string_hash{};
+	TEST_ASSERT(a.seed() != b.seed());
+	TEST_ASSERT(a("key") != b("key") && a("key") == string_hash{a}("key"));
+	TEST_ASSERT(a("key") == a(std::string_view{"key"}));
+	TEST_ASSERT(string_hash{1}("key") == tpp::fast_hash<std::string>{}("key", 1));
+	TEST_ASSERT(check_distribution(1 << 17, [h = tpp::seeded_hash<std::size_t, std::hash<std::size_t>>{}](std::size_t i) { return h(i); }));
+
+	using map_t = tpp::sparse_map<int, int, tpp::seeded_hash<int, flood_hash>>;
+	using ordered_map_t = tpp::ordered_sparse_map<int, int, tpp::seeded_hash<int, flood_hash>>;
+	using stable_map_t = tpp::stable_map<int, int, tpp::seeded_hash<int, flood_hash>>;
+	test_flooded_map<map_t>();
+	test_flooded_map<ordered_map_t>();
+	test_flooded_map<stable_map_t>();
+
+	/* Reseeding preserves order of ordered tables. */
+	{
+		auto map = ordered_map_t{0, tpp::seeded_hash<int, flood_hash>{flood_hash::bad_seed}};
+		for (int i = 0; i < 2048; ++i) map.emplace(i, i);
+		int expected = 0;
+		for (auto value: map) TEST_ASSERT(value.first == expected++);
+	}
+
+	/* Elements escaping their partition during a parallel insert are hashed with the seed of the reseeded hasher. */
+	{
+		std::vector<std::pair<int, int>> values;
+		for (int i = 0; i < 20000; ++i) values.emplace_back(i, i);
+
+		auto map = map_t{0, tpp::seeded_hash<int, flood_hash>{flood_hash::bad_seed}};
+		map.insert(tpp::thread_executor{4}, values.begin(), values.end());
+		TEST_ASSERT(map.size() == values.size());
+		TEST_ASSERT(map.hash_function().seed() != flood_hash::bad_seed);
+		for (int i = 0; i < 20000; ++i) TEST_ASSERT(map.contains(i));
+	}
+
+	/* Keys which collide regardless of the seed are still inserted, without reseeding on every insertion. */
+	{
+		auto map = tpp::sparse_map<int, int, tpp::seeded_hash<int, constant_hash>>{};
+		for (int i = 0; i < 2048; ++i) TEST_ASSERT(map.emplace(i, i).second);
+		for (int i = 0; i < 2048; ++i) TEST_ASSERT(map.contains(i));
+		map.erase(1000);
+		TEST_ASSERT(!map.contains(1000) && map.size() == 2047);
+	}
+
+	/* Other containers use the seed without reseeding. */
+	{
+		auto map = tpp::dense_map<std::string, int, tpp::seeded_hash<std::string>, string_eq>{};
+		for (int i = 0; i < 1000; ++i) map.emplace(std::to_string(i), i);
+		TEST_ASSERT(map.find(std::string_view{"999"}) != map.end() && map.find(std::string_view{"999"})->second == 999);
+		const auto copy = map;
+		TEST_ASSERT(copy.hash_function().seed() == map.hash_function().seed() && copy.size() == 1000);
+
+		auto sharded = tpp::sharded_map<tpp::sparse_map<int, int, tpp::seeded_hash<int, flood_hash>>>{};
+		for (int i = 0; i < 4096; ++i) TEST_ASSERT(sharded.try_emplace(i, i));
+		for (int i = 0; i < 4096; ++i) TEST_ASSERT(sharded.contains(i));
+	}
+}
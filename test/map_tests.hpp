@@ -7,6 +7,9 @@
 #include "assert.hpp"
 
 #include <tpp/detail/multikey.hpp>
+#include <algorithm>
+#include <numeric>
+#include <vector>
 #include <string>
 
 template<template<typename...> typename T, typename map_t = T<std::string, int>>
@@ -171,6 +174,35 @@ static void test_ordered_map() noexcept
 	TEST_ASSERT(map2 == map1);
 }
 
+template<template<typename...> typename T, typename map_t = T<std::string, int>>
+static void test_compact_map() noexcept
+{
+	auto map0 = map_t{};
+
+	const int n = 0x400;
+	for (int i = 0; i < n; ++i)
+		TEST_ASSERT(map0.try_emplace(std::to_string(i), i).second);
+	for (int i = 0; i < n; i += 3)
+		map0.erase(std::to_string(i));
+	for (int i = n; i < n * 2; i += 2)
+		TEST_ASSERT(map0.try_emplace(std::to_string(i), i).second);
+
+	auto map1 = map0;
+	map0.compact();
+
+	TEST_ASSERT(map0 == map1);
+	TEST_ASSERT(std::equal(map0.begin(), map0.end(), map1.begin(), map1.end()));
+	for (const auto &value: map1)
+	{
+		TEST_ASSERT(map0.contains(value.first));
+		TEST_ASSERT(map0.find(value.first)->second == value.second);
+	}
+
+	TEST_ASSERT(map0.try_emplace("a", -1).second);
+	TEST_ASSERT(map0.find("a") == std::prev(map0.end()));
+	TEST_ASSERT(map0.back().second == -1);
+}
+
 template<template<typename...> typename T, typename map_t = T<tpp::multikey<std::string, int>, float>>
 static void test_multimap() noexcept
 {
@@ -234,6 +266,170 @@ static void test_multimap() noexcept
 	TEST_ASSERT(map2 == map1);
 }
 
+struct counted_value
+{
+	static inline int instances = 0;
+
+	counted_value(int value) : value(value) { ++instances; }
+	counted_value(const counted_value &) = default;
+	counted_value(counted_value &&) = default;
+	counted_value &operator=(const counted_value &) = default;
+	counted_value &operator=(counted_value &&) = default;
+
+	int value;
+};
+
+template<template<typename...> typename T, typename map_t = T<std::string, counted_value>>
+static void test_emplace_map() noexcept
+{
+	auto map0 = map_t{};
+	const auto key = std::string{"0"};
+	counted_value::instances = 0;
+
+	TEST_ASSERT(map0.emplace(key, 0).second);
+	TEST_ASSERT(counted_value::instances == 1);
+
+	/* Duplicate keys are detected without constructing the value. */
+	TEST_ASSERT(!map0.emplace(key, 1).second);
+	TEST_ASSERT(!map0.emplace(std::string{"0"}, 2).second);
+	TEST_ASSERT(!map0.emplace(std::pair<std::string, int>{key, 3}).second);
+	TEST_ASSERT(!map0.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(4)).second);
+	TEST_ASSERT(counted_value::instances == 1);
+	TEST_ASSERT(map0.find(key)->second.value == 0);
+
+	TEST_ASSERT(map0.emplace(std::piecewise_construct, std::forward_as_tuple("1"), std::forward_as_tuple(1)).second);
+	TEST_ASSERT(map0.emplace(std::pair<std::string, int>{"2", 2}).second);
+	TEST_ASSERT(counted_value::instances == 3);
+	TEST_ASSERT(map0.find("1")->second.value == 1);
+	TEST_ASSERT(map0.find("2")->second.value == 2);
+}
+
+template<template<typename...> typename T, typename map_t = T<int, double>>
+static void test_erase_if_map() noexcept
+{
+	auto map0 = map_t{};
+
+	const int n = 0x400;
+	for (int i = 0; i < n; ++i) TEST_ASSERT(map0.emplace(i, static_cast<double>(i)).second);
+	for (int i = 0; i < n; i += 7) map0.erase(i);
+
+	/* Relative order of the remaining elements is preserved. */
+	auto expected = std::vector<int>{};
+	for (auto entry: map0) if (entry.first % 3 != 0) expected.push_back(entry.first);
+
+	const auto old_size = map0.size();
+	TEST_ASSERT(erase_if(map0, [](auto entry) { return entry.first % 3 == 0; }) == old_size - expected.size());
+	TEST_ASSERT(map0.size() == expected.size());
+	TEST_ASSERT(std::equal(map0.begin(), map0.end(), expected.begin(), expected.end(), [](auto entry, int k) { return entry.first == k; }));
+
+	for (int i = 0; i < n; ++i)
+	{
+		const auto iter = map0.find(i);
+		TEST_ASSERT((iter != map0.end()) == (i % 3 != 0 && i % 7 != 0));
+		TEST_ASSERT(iter == map0.end() || iter->second == static_cast<double>(i));
+	}
+	TEST_ASSERT(map0.erase_if([](auto) { return false; }) == 0);
+
+	/* Elements not yet visited are kept if the predicate throws. */
+	auto remaining = std::vector<int>{};
+	for (auto k = expected.begin(), thrown = std::find_if(expected.begin(), expected.end(), [](int k) { return k % 5 == 0; }); k != expected.end(); ++k)
+		if (k >= thrown || *k % 2 != 0) remaining.push_back(*k);
+	try
+	{
+		map0.erase_if([](auto entry) -> bool
+		{
+			if (entry.first % 5 == 0) throw entry.first;
+			return entry.first % 2 == 0;
+		});
+		TEST_ASSERT(false);
+	}
+	catch (int) {}
+	TEST_ASSERT(std::equal(map0.begin(), map0.end(), remaining.begin(), remaining.end(), [](auto entry, int k) { return entry.first == k; }));
+	for (auto k: remaining) TEST_ASSERT(map0.find(k)->second == static_cast<double>(k));
+
+	const auto size = map0.size();
+	TEST_ASSERT(map0.erase_if([](auto) { return true; }) == size);
+	TEST_ASSERT(map0.empty());
+	TEST_ASSERT(map0.begin() == map0.end());
+	TEST_ASSERT(map0.emplace(1, 1.0).second);
+	TEST_ASSERT(map0.contains(1));
+}
+
+template<template<typename...> typename T, typename map_t = T<int, double>>
+static void test_view_map() noexcept
+{
+	auto map0 = map_t{};
+	TEST_ASSERT(map0.keys().empty());
+	TEST_ASSERT(map0.values().begin() == map0.values().end());
+
+	const int n = 0x100;
+	for (int i = 0; i < n; ++i) TEST_ASSERT(map0.emplace(i, static_cast<double>(i) * 2).second);
+	for (int i = 0; i < n; i += 4) map0.erase(i);
+
+	const auto keys = map0.keys();
+	auto values = map0.values();
+	TEST_ASSERT(keys.size() == map0.size());
+	TEST_ASSERT(values.size() == map0.size());
+	TEST_ASSERT(values.end() - values.begin() == static_cast<std::ptrdiff_t>(map0.size()));
+
+	for (std::size_t i = 0; i < keys.size(); ++i)
+	{
+		TEST_ASSERT(map0.contains(keys[i]));
+		TEST_ASSERT(&values[i] == &map0.find(keys[i])->second);
+	}
+	TEST_ASSERT(std::all_of(map0.begin(), map0.end(), [&](auto v) { return std::count(keys.rbegin(), keys.rend(), v.first) == 1; }));
+
+	for (auto &value: values) value += 1;
+	for (auto entry: map0) TEST_ASSERT(entry.second == static_cast<double>(entry.first) * 2 + 1);
+
+	const auto sum = std::accumulate(std::as_const(map0).values().begin(), std::as_const(map0).values().end(), 0.0);
+	TEST_ASSERT(sum == std::accumulate(keys.begin(), keys.end(), 0.0, [](double acc, int k) { return acc + k * 2 + 1; }));
+	TEST_ASSERT(*std::max_element(keys.begin(), keys.end()) == n - 1);
+}
+
+template<template<typename...> typename T, typename map_t = T<tpp::multikey<std::string, tpp::lazy_key<int>>, float>>
+static void test_lazy_multimap() noexcept
+{
+	auto map0 = map_t{};
+
+	const int n = 0x1000;
+	for (int i = 0; i < n; ++i) TEST_ASSERT(map0.try_emplace(std::forward_as_tuple(std::to_string(i), i), static_cast<float>(i)).second);
+	for (int i = 0; i < n; i += 2) map0.template erase<0>(std::to_string(i));
+	TEST_ASSERT(map0.size() == n / 2);
+
+	/* Const lookups by the lazy key search the elements without building it's index. */
+	{
+		const auto &cmap = map0;
+		TEST_ASSERT(cmap.template contains<1>(1) && !cmap.template contains<1>(0));
+		TEST_ASSERT(cmap.template find<1>(3) == cmap.template find<0>("3"));
+		TEST_ASSERT(cmap.template find<1>(n) == cmap.end());
+
+		const auto map2 = map0;
+		TEST_ASSERT(map2.template contains<1>(n - 1) && map2.template find<1>(5)->second == 5.0f);
+	}
+
+	/* First non-const lookup by the lazy key builds it's index. */
+	for (int i = 1; i < n; i += 2)
+	{
+		const auto iter = map0.template find<1>(i);
+		TEST_ASSERT(iter != map0.end());
+		TEST_ASSERT(iter->second == static_cast<float>(i));
+		TEST_ASSERT(iter == map0.template find<0>(std::to_string(i)));
+	}
+	TEST_ASSERT(!map0.template contains<1>(0));
+
+	/* Built index is maintained. */
+	TEST_ASSERT(!map0.try_emplace(std::forward_as_tuple("a", 1), 0.0f).second);
+	TEST_ASSERT(map0.try_emplace(std::forward_as_tuple("a", 0), 0.0f).second);
+	map0.template erase<1>(1);
+	TEST_ASSERT(!map0.template contains<0>("1"));
+	TEST_ASSERT(map0.template find<1>(0) == map0.template find<0>("a"));
+
+	auto map1 = map_t{std::move(map0)};
+	TEST_ASSERT(map1.template find<1>(0) == map1.template find<0>("a"));
+	TEST_ASSERT(map1.template find<1>(3) == map1.template find<0>("3"));
+}
+
 template<template<typename...> typename T, typename map_t = T<std::string, int>>
 static void test_node_map() noexcept
 {
@@ -0,0 +1,188 @@
+/*
+ * Created by switchblade on 2023-01-27.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+/* Fancy pointer that stores the offset of the target from it's own address (similar to `boost::interprocess::offset_ptr`).
+ * Structures that only use offset pointers remain valid when the memory containing them is mapped at a different address. */
+template<typename T>
+class offset_ptr
+{
+	template<typename>
+	friend class offset_ptr;
+
+	/* Offset of 1 is never a valid target, as the pointer itself occupies the byte. */
+	constexpr static std::ptrdiff_t null_off = 1;
+
+public:
+	using element_type = T;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = offset_ptr;
+	using reference = std::add_lvalue_reference_t<T>;
+	using iterator_category = std::random_access_iterator_tag;
+
+	template<typename U>
+	using rebind = offset_ptr<U>;
+
+	template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+	[[nodiscard]] static offset_ptr pointer_to(U &ref) noexcept { return offset_ptr{std::addressof(ref)}; }
+
+public:
+	offset_ptr() noexcept = default;
+	offset_ptr(std::nullptr_t) noexcept {}
+	offset_ptr(T *ptr) noexcept { set(ptr); }
+
+	offset_ptr(const offset_ptr &other) noexcept { set(other.get()); }
+	offset_ptr &operator=(const offset_ptr &other) noexcept
+	{
+		set(other.get());
+		return *this;
+	}
+
+	template<typename U, typename = std::enable_if_t<!std::is_same_v<T, U> && std::is_convertible_v<U *, T *>>>
+	offset_ptr(const offset_ptr<U> &other) noexcept { set(other.get()); }
+	/* Allocators must support `static_cast` from void pointers. */
+	template<typename U, typename = std::enable_if_t<!std::is_convertible_v<U *, T *> && std::is_void_v<std::remove_cv_t<U>>>, typename = void>
+	explicit offset_ptr(const offset_ptr<U> &other) noexcept { set(static_cast<T *>(other.get())); }
+
+	[[nodiscard]] T *get() const noexcept
+	{
+		if (m_off == null_off) return nullptr;
+		return reinterpret_cast<T *>(reinterpret_cast<std::uintptr_t>(this) + m_off);
+	}
+
+	[[nodiscard]] explicit operator bool() const noexcept { return m_off != null_off; }
+	[[nodiscard]] T *operator->() const noexcept { return get(); }
+	template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+	[[nodiscard]] U &operator*() const noexcept { return *get(); }
+	template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+	[[nodiscard]] U &operator[](difference_type i) const noexcept { return get()[i]; }
+
+	offset_ptr &operator+=(difference_type n) noexcept
+	{
+		set(get() + n);
+		return *this;
+	}
+	offset_ptr &operator-=(difference_type n) noexcept
+	{
+		set(get() - n);
+		return *this;
+	}
+	offset_ptr &operator++() noexcept { return *this += 1; }
+	offset_ptr &operator--() noexcept { return *this -= 1; }
+	offset_ptr operator++(int) noexcept
+	{
+		auto tmp = *this;
+		++(*this);
+		return tmp;
+	}
+	offset_ptr operator--(int) noexcept
+	{
+		auto tmp = *this;
+		--(*this);
+		return tmp;
+	}
+
+	[[nodiscard]] friend offset_ptr operator+(const offset_ptr &p, difference_type n) noexcept { return offset_ptr{p.get() + n}; }
+	[[nodiscard]] friend offset_ptr operator+(difference_type n, const offset_ptr &p) noexcept { return offset_ptr{p.get() + n}; }
+	[[nodiscard]] friend offset_ptr operator-(const offset_ptr &p, difference_type n) noexcept { return offset_ptr{p.get() - n}; }
+	[[nodiscard]] friend difference_type operator-(const offset_ptr &a, const offset_ptr &b) noexcept { return a.get() - b.get(); }
+
+	[[nodiscard]] friend bool operator==(const offset_ptr &a, const offset_ptr &b) noexcept { return a.get() == b.get(); }
+	[[nodiscard]] friend bool operator!=(const offset_ptr &a, const offset_ptr &b) noexcept { return a.get() != b.get(); }
+	[[nodiscard]] friend bool operator<(const offset_ptr &a, const offset_ptr &b) noexcept { return a.get() < b.get(); }
+	[[nodiscard]] friend bool operator<=(const offset_ptr &a, const offset_ptr &b) noexcept { return a.get() <= b.get(); }
+	[[nodiscard]] friend bool operator>(const offset_ptr &a, const offset_ptr &b) noexcept { return a.get() > b.get(); }
+	[[nodiscard]] friend bool operator>=(const offset_ptr &a, const offset_ptr &b) noexcept { return a.get() >= b.get(); }
+	[[nodiscard]] friend bool operator==(const offset_ptr &a, std::nullptr_t) noexcept { return !a; }
+	[[nodiscard]] friend bool operator!=(const offset_ptr &a, std::nullptr_t) noexcept { return !!a; }
+	[[nodiscard]] friend bool operator==(std::nullptr_t, const offset_ptr &a) noexcept { return !a; }
+	[[nodiscard]] friend bool operator!=(std::nullptr_t, const offset_ptr &a) noexcept { return !!a; }
+
+private:
+	void set(const volatile void *ptr) noexcept
+	{
+		if (ptr == nullptr)
+			m_off = null_off;
+		else
+			m_off = static_cast<std::ptrdiff_t>(reinterpret_cast<std::uintptr_t>(ptr) - reinterpret_cast<std::uintptr_t>(this));
+	}
+
+	std::ptrdiff_t m_off = null_off;
+};
+
+/* Bump allocator over a fixed buffer. Memory is never reused, which is fine for tests. */
+struct offset_arena
+{
+	explicit offset_arena(std::size_t size) noexcept : size(size) {}
+
+	[[nodiscard]] void *allocate(std::size_t n, std::size_t align)
+	{
+		const auto base = reinterpret_cast<std::uintptr_t>(this + 1);
+		const auto pos = (base + used + align - 1) / align * align;
+		if (pos + n > base + size) throw std::bad_alloc();
+		used = pos + n - base;
+		return reinterpret_cast<void *>(pos);
+	}
+
+	std::size_t size;
+	std::size_t used = 0;
+};
+
+/* Allocator that returns offset pointers. If bound to an arena, allocates from the arena, otherwise from the global heap.
+ * Arena allocators keep an offset pointer to the arena, so that containers placed within the arena can be relocated with it. */
+template<typename T>
+class offset_allocator
+{
+	template<typename>
+	friend class offset_allocator;
+
+public:
+	using value_type = T;
+	using pointer = offset_ptr<T>;
+	using const_pointer = offset_ptr<const T>;
+	using void_pointer = offset_ptr<void>;
+	using const_void_pointer = offset_ptr<const void>;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+
+	using propagate_on_container_copy_assignment = std::true_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	template<typename U>
+	struct rebind { using other = offset_allocator<U>; };
+
+public:
+	offset_allocator() noexcept = default;
+	explicit offset_allocator(offset_arena *arena) noexcept : m_arena(arena) {}
+	template<typename U>
+	offset_allocator(const offset_allocator<U> &other) noexcept : m_arena(other.m_arena) {}
+
+	[[nodiscard]] pointer allocate(size_type n)
+	{
+		if (m_arena) return pointer{static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)))};
+		return pointer{std::allocator<T>{}.allocate(n)};
+	}
+	void deallocate(pointer p, size_type n)
+	{
+		if (!m_arena) std::allocator<T>{}.deallocate(p.get(), n);
+	}
+
+	template<typename U>
+	[[nodiscard]] bool operator==(const offset_allocator<U> &other) const noexcept { return m_arena == other.m_arena; }
+	template<typename U>
+	[[nodiscard]] bool operator!=(const offset_allocator<U> &other) const noexcept { return m_arena != other.m_arena; }
+
+private:
+	offset_ptr<offset_arena> m_arena;
+};
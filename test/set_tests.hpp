@@ -7,6 +7,8 @@
 #include "assert.hpp"
 
 #include <tpp/detail/multikey.hpp>
+#include <algorithm>
+#include <vector>
 #include <string>
 
 template<template<typename...> typename T, typename set_t = T<std::string>>
@@ -147,6 +149,31 @@ static void test_ordered_set() noexcept
 	TEST_ASSERT(set2 == set1);
 }
 
+template<template<typename...> typename T, typename set_t = T<std::string>>
+static void test_compact_set() noexcept
+{
+	auto set0 = set_t{};
+
+	const int n = 0x400;
+	for (int i = 0; i < n; ++i)
+		TEST_ASSERT(set0.insert(std::to_string(i)).second);
+	for (int i = 0; i < n; i += 3)
+		set0.erase(std::to_string(i));
+	for (int i = n; i < n * 2; i += 2)
+		TEST_ASSERT(set0.insert(std::to_string(i)).second);
+
+	auto set1 = set0;
+	set0.compact();
+
+	TEST_ASSERT(set0 == set1);
+	TEST_ASSERT(std::equal(set0.begin(), set0.end(), set1.begin(), set1.end()));
+	for (const auto &value: set1) TEST_ASSERT(set0.contains(value));
+
+	TEST_ASSERT(set0.insert("a").second);
+	TEST_ASSERT(set0.find("a") == std::prev(set0.end()));
+	TEST_ASSERT(set0.back() == "a");
+}
+
 template<template<typename...> typename T, typename set_t = T<tpp::multikey<std::string, int>>>
 static void test_multiset() noexcept
 {
@@ -245,6 +272,94 @@ static void test_multiset() noexcept
 	}
 }
 
+template<template<typename...> typename T, typename set_t = T<int>>
+static void test_erase_if_set() noexcept
+{
+	auto set0 = set_t{};
+
+	const int n = 0x400;
+	for (int i = 0; i < n; ++i) TEST_ASSERT(set0.insert(i).second);
+	for (int i = 0; i < n; i += 7) set0.erase(i);
+
+	/* Relative order of the remaining elements is preserved. */
+	auto expected = std::vector<int>{};
+	std::copy_if(set0.begin(), set0.end(), std::back_inserter(expected), [](int k) { return k % 3 != 0; });
+
+	const auto old_size = set0.size();
+	TEST_ASSERT(erase_if(set0, [](int k) { return k % 3 == 0; }) == old_size - expected.size());
+	TEST_ASSERT(std::equal(set0.begin(), set0.end(), expected.begin(), expected.end()));
+	for (int i = 0; i < n; ++i) TEST_ASSERT(set0.contains(i) == (i % 3 != 0 && i % 7 != 0));
+
+	TEST_ASSERT(set0.erase_if([](int) { return false; }) == 0);
+	TEST_ASSERT(set0.insert(0).second);
+	TEST_ASSERT(set0.contains(0));
+}
+
+template<template<typename...> typename T, typename set_t = T<int>>
+static void test_view_set() noexcept
+{
+	auto set0 = set_t{};
+	TEST_ASSERT(set0.keys().empty());
+
+	const int n = 0x100;
+	for (int i = 0; i < n; ++i) TEST_ASSERT(set0.insert(i).second);
+	for (int i = 0; i < n; i += 3) set0.erase(i);
+
+	const auto keys = set0.keys();
+	TEST_ASSERT(keys.size() == set0.size());
+	TEST_ASSERT(std::is_permutation(keys.begin(), keys.end(), set0.begin(), set0.end()));
+	TEST_ASSERT(&keys.front() == &*set0.find(keys.front()));
+	TEST_ASSERT(&keys.back() == &*set0.find(keys.back()));
+
+	auto count = std::count_if(keys.begin(), keys.end(), [](int k) { return k % 3 == 0; });
+	TEST_ASSERT(count == 0);
+	TEST_ASSERT(static_cast<std::size_t>(std::count_if(keys.begin(), keys.end(), [&](int k) { return set0.contains(k); })) == set0.size());
+}
+
+template<template<typename...> typename T, typename set_t = T<tpp::multikey<std::string, tpp::lazy_key<int>>>>
+static void test_lazy_multiset() noexcept
+{
+	auto set0 = set_t{};
+
+	const int n = 0x1000;
+	for (int i = 0; i < n; ++i) TEST_ASSERT(set0.emplace(std::to_string(i), i).second);
+	for (int i = 0; i < n; i += 2) set0.template erase<0>(std::to_string(i));
+	TEST_ASSERT(!set0.emplace("1", -1).second);
+	TEST_ASSERT(set0.size() == n / 2);
+
+	/* Const lookups by the lazy key search the elements without building it's index. */
+	{
+		const auto &cset = set0;
+		TEST_ASSERT(cset.template contains<1>(1) && !cset.template contains<1>(0));
+		TEST_ASSERT(cset.template find<1>(3) == cset.template find<0>("3"));
+		TEST_ASSERT(cset.template find<1>(n) == cset.end());
+	}
+
+	/* First non-const lookup by the lazy key builds it's index. */
+	for (int i = 0; i < n; ++i)
+	{
+		TEST_ASSERT(set0.template contains<1>(i) == (i % 2 != 0));
+		TEST_ASSERT(set0.template contains<0>(std::to_string(i)) == (i % 2 != 0));
+	}
+	TEST_ASSERT(set0.template find<0>("1") == set0.template find<1>(1));
+
+	/* Built index is maintained. */
+	TEST_ASSERT(!set0.emplace("a", 1).second);
+	for (int i = n; i < n * 2; ++i) TEST_ASSERT(set0.emplace(std::to_string(i), i).second);
+	set0.template erase<1>(3);
+	TEST_ASSERT(!set0.template contains<0>("3"));
+	TEST_ASSERT(!set0.template contains<1>(3));
+
+	const auto set1 = set0;
+	TEST_ASSERT(set1.size() == set0.size());
+	for (int i = 0; i < n * 2; ++i)
+	{
+		const auto str = std::to_string(i);
+		TEST_ASSERT(set1.template contains<1>(i) == set0.template contains<0>(str));
+		TEST_ASSERT(set1.template find<0>(str) == set1.template find<1>(i));
+	}
+}
+
 template<template<typename...> typename T, typename set_t = T<std::string>>
 static void test_node_set() noexcept
 {
@@ -0,0 +1,521 @@
+/*
+ * Created by switchblade on 2023-01-25.
+ */
+
+#include "tests.hpp"
+
+#include <functional>
+#include <sstream>
+#include <fstream>
+#include <utility>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <string>
+
+#include <tpp/sparse_map.hpp>
+#include <tpp/sparse_set.hpp>
+#include <tpp/mapped_sparse_map_view.hpp>
+#include <tpp/cow_map.hpp>
+#include <tpp/dense_multimap.hpp>
+#include <tpp/dense_map.hpp>
+#include <tpp/dense_set.hpp>
+
+/* Tables that do not support snapshots do not store dirty-block tracking state. */
+static_assert(sizeof(tpp::sparse_map<std::string, int>) + sizeof(void *) == sizeof(tpp::sparse_map<int, int>));
+
+/* Hash with a configurable seed, used to produce snapshots incompatible with the default hash. */
+struct seeded_int_hash
+{
+	std::size_t operator()(int value) const noexcept { return std::hash<int>{}(value) ^ seed; }
+
+	std::size_t seed = 0;
+};
+
+template<typename T, typename E = tpp::snapshot_error>
+static bool throws(T &&f)
+{
+	try { f(); }
+	catch (const E &) { return true; }
+	return false;
+}
+
+void test_swiss_snapshot() noexcept
+{
+	{
+		auto map = tpp::sparse_map<int, double, seeded_int_hash>{};
+		for (int i = 0; i < 10000; ++i) map.emplace(i, i * 0.5);
+		for (int i = 0; i < 10000; i += 3) map.erase(i);
+
+		std::stringstream ss;
+		map.save(ss);
+
+		auto loaded = tpp::sparse_map<int, double, seeded_int_hash>{};
+		loaded.emplace(-1, 0.0);
+		loaded.load(ss);
+		TEST_ASSERT(loaded.size() == map.size());
+		TEST_ASSERT(loaded.bucket_count() == map.bucket_count());
+		TEST_ASSERT(!loaded.contains(-1));
+		for (int i = 0; i < 10000; ++i)
+		{
+			TEST_ASSERT(loaded.contains(i) == (i % 3 != 0));
+			if (i % 3 != 0) TEST_ASSERT(loaded.at(i) == i * 0.5);
+		}
+
+		/* Loaded map must remain fully functional. */
+		for (int i = 0; i < 20000; i += 3) TEST_ASSERT(loaded.emplace(i, 1.0).second);
+		const auto loaded_size = loaded.size();
+		TEST_ASSERT(loaded_size == 13333);
+		TEST_ASSERT(loaded.at(9999) == 1.0);
+
+		/* Snapshot of a different hash function must be rejected, leaving the map unchanged. */
+		auto other = tpp::sparse_map<int, double, seeded_int_hash>{0, seeded_int_hash{42}};
+		other.emplace(1, 1.0);
+		ss.clear();
+		ss.seekg(0);
+		TEST_ASSERT(throws([&]() { other.load(ss); }));
+		TEST_ASSERT(other.size() == 1 && other.at(1) == 1.0);
+
+		/* Corrupted metadata must be rejected. */
+		auto data = ss.str();
+		for (std::size_t i = 64; i < data.size(); ++i)
+			if (static_cast<signed char>(data[i]) >= 0)
+			{
+				data[i] = static_cast<char>(data[i] ^ 1);
+				break;
+			}
+		std::stringstream corrupted{data};
+		TEST_ASSERT(throws([&]() { loaded.load(corrupted); }));
+		TEST_ASSERT(loaded.size() == loaded_size);
+
+		/* Snapshot that claims more empty slots than there are in the metadata must be rejected. */
+		auto header = tpp::_detail::snapshot_header{};
+		data = ss.str();
+		std::memcpy(&header, data.data(), sizeof(header));
+		header.extra[0] += 1;
+		std::memcpy(data.data(), &header, sizeof(header));
+		std::stringstream overfull{data};
+		TEST_ASSERT(throws([&]() { loaded.load(overfull); }));
+		TEST_ASSERT(loaded.size() == loaded_size);
+
+		/* Truncated snapshot must be rejected. */
+		std::stringstream truncated{ss.str().substr(0, ss.str().size() / 2)};
+		TEST_ASSERT(throws([&]() { loaded.load(truncated); }));
+		TEST_ASSERT(loaded.contains(9999));
+	}
+	{
+		auto set = tpp::sparse_set<int>{};
+		std::stringstream ss;
+		set.save(ss);
+
+		set.emplace(1);
+		set.load(ss);
+		TEST_ASSERT(set.empty());
+		TEST_ASSERT(set.emplace(1).second);
+
+		for (int i = 0; i < 1000; ++i) set.emplace(i);
+		ss = {};
+		set.save(ss);
+
+		auto loaded = tpp::sparse_set<int>{};
+		loaded.load(ss);
+		TEST_ASSERT(loaded.size() == 1000);
+		for (int i = 0; i < 1000; ++i) TEST_ASSERT(loaded.contains(i));
+		TEST_ASSERT(!loaded.contains(1000));
+	}
+}
+
+void test_swiss_delta() noexcept
+{
+	using Map = tpp::sparse_map<int, double>;
+	const auto equal = [](const Map &a, const Map &b)
+	{
+		if (a.size() != b.size() || a.bucket_count() != b.bucket_count()) return false;
+		for (const auto &value: a)
+			if (!b.contains(value.first) || b.at(value.first) != value.second) return false;
+		return true;
+	};
+
+	auto map = Map{};
+	for (int i = 0; i < 10000; ++i) map.emplace(i, i * 0.5);
+	map.set_dirty_tracking(true);
+	TEST_ASSERT(map.dirty_tracking());
+
+	std::stringstream ss;
+	map.save(ss);
+	const auto snapshot_size = ss.str().size();
+	auto replica = Map{};
+	replica.load(ss);
+
+	/* Delta of an unmodified map contains no blocks. */
+	ss = {};
+	map.checkpoint_delta(ss);
+	const auto empty_size = ss.str().size();
+	replica.apply_delta(ss);
+	TEST_ASSERT(equal(map, replica));
+
+	/* Only the modified blocks are written. Modifications through references must be marked explicitly. */
+	map.erase(10);
+	map.emplace(20000, 1.0);
+	map.insert_or_assign(30, 2.0);
+	map.find(40)->second = 3.0;
+	map.mark_dirty(map.find(40));
+	ss = {};
+	map.checkpoint_delta(ss);
+	TEST_ASSERT(ss.str().size() > empty_size && ss.str().size() < snapshot_size / 64);
+	replica.apply_delta(ss);
+	TEST_ASSERT(equal(map, replica));
+	TEST_ASSERT(!replica.contains(10) && replica.at(20000) == 1.0 && replica.at(30) == 2.0 && replica.at(40) == 3.0);
+
+	/* Capacity changes produce a delta of the entire map. */
+	for (int i = 10000; i < 20000; ++i) map.emplace(i, i * 0.5);
+	ss = {};
+	map.checkpoint_delta(ss);
+	const auto full_delta = ss.str();
+	replica.apply_delta(ss);
+	TEST_ASSERT(equal(map, replica));
+
+	/* Partial delta can not be applied to a map of a different capacity, and deltas are not snapshots. */
+	map.erase(1);
+	ss = {};
+	map.checkpoint_delta(ss);
+	auto other = Map{};
+	other.emplace(1, 1.0);
+	TEST_ASSERT(throws([&]() { other.apply_delta(ss); }));
+	TEST_ASSERT(other.size() == 1 && other.at(1) == 1.0);
+	ss.clear();
+	ss.seekg(0);
+	TEST_ASSERT(throws([&]() { other.load(ss); }));
+	std::stringstream snapshot;
+	map.save(snapshot);
+	TEST_ASSERT(throws([&]() { other.apply_delta(snapshot); }));
+	TEST_ASSERT(other.size() == 1);
+
+	/* Deltas that do not match the base map must be rejected, leaving the map unchanged. */
+	ss.clear();
+	ss.seekg(0);
+	auto stale = Map{};
+	std::stringstream full_ss{full_delta};
+	stale.apply_delta(full_ss);
+	stale.erase(15000);
+	TEST_ASSERT(throws([&]() { stale.apply_delta(ss); }));
+	TEST_ASSERT(stale.size() == 19999 && stale.contains(1));
+	ss.clear();
+	ss.seekg(0);
+	replica.apply_delta(ss);
+	TEST_ASSERT(equal(map, replica));
+
+	/* Deltas that claim more empty slots than there are in the metadata must be rejected. */
+	{
+		auto header = tpp::_detail::snapshot_header{};
+		auto data = full_delta;
+		std::memcpy(&header, data.data(), sizeof(header));
+		header.extra[0] += 1;
+		std::memcpy(data.data(), &header, sizeof(header));
+		std::stringstream overfull{data};
+		auto target = Map{};
+		TEST_ASSERT(throws([&]() { target.apply_delta(overfull); }));
+		TEST_ASSERT(target.empty());
+	}
+
+	/* Without tracking, deltas contain the entire map. */
+	auto untracked = Map{};
+	for (int i = 0; i < 100; ++i) untracked.emplace(i, 0.0);
+	ss = {};
+	untracked.checkpoint_delta(ss);
+	replica.apply_delta(ss);
+	TEST_ASSERT(equal(untracked, replica));
+
+	map.set_dirty_tracking(false);
+	TEST_ASSERT(!map.dirty_tracking());
+}
+
+/* Mapped value that counts it's copies, used to check that only modified pages are copied. */
+struct copy_counter
+{
+	copy_counter(int value) noexcept : value(value) {}
+	copy_counter(const copy_counter &other) noexcept : value(other.value) { ++copies; }
+	copy_counter &operator=(const copy_counter &) noexcept = default;
+
+	int value;
+
+	static inline std::size_t copies = 0;
+};
+
+void test_cow_map() noexcept
+{
+	using map_t = tpp::cow_map<int, std::string>;
+	const auto contains_all = [](const map_t &map, int n)
+	{
+		for (int i = 0; i < n; ++i)
+			if (map.contains(i) != (i % 3 != 0) || (i % 3 != 0 && map.at(i) != std::to_string(i))) return false;
+		return true;
+	};
+
+	auto map = map_t{};
+	for (int i = 0; i < 1000; ++i) map.emplace(i, std::to_string(i));
+	for (int i = 0; i < 1000; i += 3) map.erase(i);
+	TEST_ASSERT(map.size() == 666 && contains_all(map, 1000));
+
+	/* Snapshots share elements of the map until either is modified. */
+	auto snapshot = map.snapshot();
+	TEST_ASSERT(snapshot.size() == map.size() && snapshot.bucket_count() == map.bucket_count());
+	TEST_ASSERT(&std::as_const(snapshot).at(1) == &std::as_const(map).at(1));
+	TEST_ASSERT(&std::as_const(snapshot).at(2) == &std::as_const(map).at(2));
+	TEST_ASSERT(contains_all(snapshot, 1000) && contains_all(map, 1000));
+
+	map.at(1) = "one";
+	TEST_ASSERT(&std::as_const(snapshot).at(1) != &std::as_const(map).at(1));
+	TEST_ASSERT(snapshot.at(1) == "1" && map.at(1) == "one");
+	for (int i = 0; i < 1000; i += 3) map.emplace(i, std::to_string(i));
+	for (int i = 1000; i < 5000; ++i) map.emplace(i, std::to_string(i));
+	TEST_ASSERT(snapshot.size() == 666 && map.size() == 5000);
+	TEST_ASSERT(contains_all(snapshot, 1000) && !snapshot.contains(1000));
+
+	/* Snapshots of snapshots share the same pages, and remain valid after the original is destroyed. */
+	{
+		auto other = snapshot.snapshot();
+		auto copy = snapshot;
+		snapshot = map_t{};
+		TEST_ASSERT(snapshot.empty() && snapshot.begin() == snapshot.end());
+		TEST_ASSERT(contains_all(other, 1000) && contains_all(copy, 1000));
+
+		other.erase(other.find(1));
+		TEST_ASSERT(!other.contains(1) && copy.contains(1) && other.size() == 665);
+		other.insert_or_assign(2, "two");
+		other[4] = "four";
+		TEST_ASSERT(other.at(2) == "two" && other.at(4) == "four" && copy.at(2) == "2" && copy.at(4) == "4");
+
+		auto moved = std::move(copy);
+		TEST_ASSERT(contains_all(moved, 1000));
+		moved.swap(other);
+		TEST_ASSERT(contains_all(other, 1000) && !moved.contains(1));
+		other.clear();
+		TEST_ASSERT(other.empty() && moved.size() == 665);
+	}
+
+	/* Erasing via `erase_if` only affects the map it was called on. */
+	snapshot = map.snapshot();
+	{
+		TEST_ASSERT(tpp::erase_if(map, [](const auto &value) { return value.first % 2 == 0; }) == 2500);
+		TEST_ASSERT(map.size() == 2500 && snapshot.size() == 5000);
+		for (int i = 0; i < 5000; ++i)
+			TEST_ASSERT(map.contains(i) == (i % 2 != 0) && snapshot.contains(i));
+
+		std::size_t count = 0;
+		for (const auto &value: map)
+		{
+			TEST_ASSERT(value.first % 2 != 0);
+			++count;
+		}
+		TEST_ASSERT(count == map.size());
+		count = 0;
+		for (auto iter = snapshot.begin(); iter != snapshot.end(); ++iter, ++count)
+			TEST_ASSERT(iter->second == (iter->first == 1 ? "one" : std::to_string(iter->first)));
+		TEST_ASSERT(count == snapshot.size());
+	}
+
+	/* Rehashing does not affect pages shared with snapshots. */
+	map.rehash(map.bucket_count() * 4);
+	TEST_ASSERT(map.size() == 2500 && map.at(1) == "one" && map.at(4999) == "4999");
+	TEST_ASSERT(snapshot.size() == 5000 && snapshot.at(1) == "one" && snapshot.at(4998) == "4998");
+
+	/* Snapshots can be read while the map is modified from another thread. */
+	snapshot = map.snapshot();
+	{
+		auto writer = std::thread{[&]()
+		{
+			for (int i = 0; i < 5000; ++i) map.erase(i);
+			for (int i = 5000; i < 10000; ++i) map.emplace(i, std::to_string(i));
+		}};
+		for (int i = 1; i < 5000; i += 2) TEST_ASSERT(snapshot.at(i) == (i == 1 ? "one" : std::to_string(i)));
+		writer.join();
+	}
+	TEST_ASSERT(snapshot.size() == 2500 && map.size() == 5000 && !map.contains(1) && map.contains(9999));
+
+	/* Modification of a snapshot only copies pages that are modified. */
+	{
+		using counted_t = tpp::cow_map<int, copy_counter>;
+		auto counted = counted_t{};
+		for (int i = 0; i < 10000; ++i) counted.emplace(i, i);
+
+		copy_counter::copies = 0;
+		auto counted_snapshot = counted.snapshot();
+		TEST_ASSERT(copy_counter::copies == 0);
+
+		counted.at(0).value = -1;
+		counted.erase(1);
+		TEST_ASSERT(copy_counter::copies > 0 && copy_counter::copies < counted.size() / 16);
+		TEST_ASSERT(counted.at(0).value == -1 && counted_snapshot.at(0).value == 0 && counted_snapshot.contains(1));
+	}
+}
+
+void test_mapped_snapshot() noexcept
+{
+	const auto path = std::string{"tpp_mapped_snapshot_test.bin"};
+	auto map = tpp::sparse_map<int, double>{};
+	for (int i = 0; i < 10000; ++i) map.emplace(i, i * 0.5);
+	for (int i = 0; i < 10000; i += 7) map.erase(i);
+	{
+		std::ofstream os{path, std::ios::binary | std::ios::trunc};
+		map.save(os);
+	}
+
+	{
+		auto view = tpp::mapped_sparse_map_view<int, double>{path};
+		TEST_ASSERT(view.size() == map.size());
+		TEST_ASSERT(view.bucket_count() == map.bucket_count());
+		for (int i = 0; i < 10000; ++i)
+		{
+			TEST_ASSERT(view.contains(i) == (i % 7 != 0));
+			if (i % 7 != 0)
+			{
+				TEST_ASSERT(view.find(i) != view.end());
+				TEST_ASSERT(view.find(i)->second == i * 0.5);
+				TEST_ASSERT(view.at(i) == i * 0.5);
+			}
+			else
+				TEST_ASSERT(view.find(i) == view.end());
+		}
+		TEST_ASSERT(!view.contains(-1));
+
+		std::size_t count = 0;
+		for (auto &value: view)
+		{
+			TEST_ASSERT(map.at(value.first) == value.second);
+			++count;
+		}
+		TEST_ASSERT(count == map.size());
+
+		auto moved = std::move(view);
+		TEST_ASSERT(view.empty() && view.begin() == view.end());
+		TEST_ASSERT(moved.size() == map.size() && moved.contains(1));
+	}
+
+	/* Views of a different layout must be rejected. */
+	TEST_ASSERT(throws([&]() { tpp::mapped_sparse_map_view<int, float>{path}; }));
+	TEST_ASSERT((throws<void (*)(), std::system_error>([]() { tpp::mapped_sparse_map_view<int, double>{"tpp_missing_snapshot.bin"}; })));
+
+	/* Empty maps produce empty views. */
+	{
+		std::ofstream os{path, std::ios::binary | std::ios::trunc};
+		tpp::sparse_map<int, double>{}.save(os);
+	}
+	{
+		auto view = tpp::mapped_sparse_map_view<int, double>{path};
+		TEST_ASSERT(view.empty() && view.begin() == view.end());
+		TEST_ASSERT(!view.contains(0));
+	}
+	std::remove(path.c_str());
+}
+
+template<typename P, typename... Ks>
+struct multikey_policy_hash : tpp::_detail::multikey_hash<tpp::multikey<Ks...>> { using bucket_policy = P; };
+
+template<typename Map>
+static void test_dense_multimap_snapshot() noexcept
+{
+	/* Large enough for the indices to be re-built in parallel. */
+	constexpr int value_count = 100000;
+
+	auto map = Map{};
+	for (int i = 0; i < value_count; ++i) map.emplace(std::make_tuple(i, static_cast<std::uint64_t>(i) * 3), i * 0.5);
+	for (int i = 0; i < value_count; i += 5) map.template erase<0>(i);
+
+	const auto check = [&](const Map &loaded)
+	{
+		TEST_ASSERT(loaded.size() == map.size());
+		for (int i = 0; i < value_count; i += 3)
+		{
+			const auto pos = loaded.template find<0>(i);
+			TEST_ASSERT((pos != loaded.end()) == (i % 5 != 0));
+			TEST_ASSERT(loaded.template find<1>(static_cast<std::uint64_t>(i) * 3) == pos);
+			if (pos != loaded.end()) TEST_ASSERT(pos->second == i * 0.5);
+		}
+	};
+
+	for (const auto with_index: {true, false})
+	{
+		std::stringstream ss;
+		map.save(ss, with_index);
+
+		auto loaded = Map{};
+		loaded.emplace(std::make_tuple(-1, std::uint64_t{}), 0.0);
+		loaded.load(ss);
+		check(loaded);
+		TEST_ASSERT(!loaded.template contains<0>(-1));
+
+		/* Loaded map must remain fully functional. */
+		TEST_ASSERT(loaded.emplace(std::make_tuple(value_count, std::uint64_t{1}), 1.0).second);
+		TEST_ASSERT(!loaded.emplace(std::make_tuple(value_count + 1, std::uint64_t{3}), 1.0).second);
+		loaded.template erase<0>(1);
+		TEST_ASSERT(!loaded.template contains<0>(1) && loaded.template contains<0>(2));
+	}
+
+	/* Index referring to invalid positions must be rejected, leaving the map unchanged. */
+	std::stringstream ss;
+	map.save(ss);
+	auto data = ss.str();
+	for (std::size_t i = data.size() - 8; i < data.size(); ++i) data[i] = 1;
+
+	auto other = Map{};
+	other.emplace(std::make_tuple(1, std::uint64_t{1}), 1.0);
+	std::stringstream corrupted{data};
+	TEST_ASSERT(throws([&]() { other.load(corrupted); }));
+	TEST_ASSERT(other.size() == 1 && other.template contains<1>(1));
+}
+
+void test_dense_snapshot() noexcept
+{
+	test_dense_multimap_snapshot<tpp::dense_multimap<tpp::multikey<int, std::uint64_t>, double>>();
+	using open_hash = multikey_policy_hash<tpp::open_bucket_policy, int, std::uint64_t>;
+	test_dense_multimap_snapshot<tpp::dense_multimap<tpp::multikey<int, std::uint64_t>, double, open_hash>>();
+	using prime_hash = multikey_policy_hash<tpp::prime_bucket_policy, int, std::uint64_t>;
+	test_dense_multimap_snapshot<tpp::dense_multimap<tpp::multikey<int, std::uint64_t>, double, prime_hash>>();
+
+	{
+		/* Lazy indices are restored as not yet built. */
+		using Map = tpp::dense_multimap<tpp::multikey<int, tpp::lazy_key<std::uint64_t>>, double>;
+		auto map = Map{};
+		for (int i = 0; i < 1000; ++i) map.emplace(std::make_tuple(i, static_cast<std::uint64_t>(i)), 0.0);
+
+		std::stringstream ss;
+		map.save(ss);
+		auto loaded = Map{};
+		loaded.load(ss);
+		TEST_ASSERT(loaded.template contains<1>(999));
+		TEST_ASSERT(loaded.template find<1>(10) == loaded.template find<0>(10));
+
+		ss = {};
+		loaded.save(ss, false);
+		map.load(ss);
+		TEST_ASSERT(map.template find<1>(10) == map.template find<0>(10));
+	}
+	{
+		auto map = tpp::dense_map<int, double>{};
+		for (int i = 0; i < 1000; ++i) map.emplace(i, i * 2.0);
+
+		std::stringstream ss;
+		map.save(ss);
+		auto loaded = tpp::dense_map<int, double>{};
+		loaded.load(ss);
+		TEST_ASSERT(loaded == map);
+
+		/* Snapshots of a different layout must be rejected. */
+		ss.clear();
+		ss.seekg(0);
+		auto set = tpp::dense_set<int>{};
+		TEST_ASSERT(throws([&]() { set.load(ss); }));
+		TEST_ASSERT(set.empty());
+	}
+	{
+		auto set = tpp::dense_set<int>{};
+		std::stringstream ss;
+		set.save(ss);
+		set.emplace(1);
+		set.load(ss);
+		TEST_ASSERT(set.empty());
+		TEST_ASSERT(set.emplace(1).second && set.contains(1));
+	}
+}
@@ -0,0 +1,97 @@
+/*
+ * Created by switchblade on 2023-01-29.
+ */
+
+#include "tests.hpp"
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <array>
+
+#include <tpp/static_map.hpp>
+#include <tpp/static_set.hpp>
+
+using namespace std::literals;
+
+enum class method { get, head, post, put, del };
+
+constexpr auto methods = tpp::make_static_map<std::string_view, method>({
+		{"GET", method::get},
+		{"HEAD", method::head},
+		{"POST", method::post},
+		{"PUT", method::put},
+		{"DELETE", method::del},
+});
+static_assert(methods.size() == 5);
+static_assert(methods.at("GET") == method::get && methods.at("DELETE") == method::del);
+static_assert(methods.contains("PUT") && !methods.contains("PATCH") && !methods.contains(""));
+static_assert(methods.begin()->second == method::get);
+
+constexpr auto method_names = tpp::make_static_map<method, std::string_view>({
+		{method::get, "GET"},
+		{method::head, "HEAD"},
+		{method::post, "POST"},
+		{method::put, "PUT"},
+		{method::del, "DELETE"},
+});
+static_assert(method_names.at(method::post) == "POST");
+static_assert(method_names.find(static_cast<method>(5)) == method_names.end());
+
+constexpr auto single = tpp::make_static_set<int>({42});
+static_assert(single.contains(42) && !single.contains(0));
+
+/* Larger tables built from generated arrays. */
+template<std::size_t N>
+constexpr std::array<std::pair<int, int>, N> make_elements()
+{
+	std::array<std::pair<int, int>, N> result = {};
+	for (std::size_t i = 0; i < N; ++i)
+	{
+		const auto key = static_cast<int>(i * 7919 % 100003);
+		/* Assignment of pairs is not constexpr in C++17. */
+		result[i].first = key;
+		result[i].second = key * 2;
+	}
+	return result;
+}
+constexpr auto elements = tpp::static_map{make_elements<200>()};
+static_assert(elements.at(7919) == 7919 * 2);
+
+void test_static_map() noexcept
+{
+	/* Lookups of run-time keys. */
+	const std::string_view names[] = {"GET", "HEAD", "POST", "PUT", "DELETE"};
+	for (std::size_t i = 0; i < 5; ++i)
+	{
+		TEST_ASSERT(methods.at(names[i]) == static_cast<method>(i));
+		TEST_ASSERT(method_names.at(static_cast<method>(i)) == names[i]);
+		TEST_ASSERT(!methods.contains(std::string{names[i]} + "X"));
+	}
+	bool thrown = false;
+	try { static_cast<void>(methods.at("OPTIONS")); }
+	catch (const std::out_of_range &) { thrown = true; }
+	TEST_ASSERT(thrown);
+
+	std::size_t count = 0;
+	for (auto &value: elements)
+	{
+		TEST_ASSERT(elements.find(value.first) == &value);
+		TEST_ASSERT(value.second == value.first * 2);
+		++count;
+	}
+	TEST_ASSERT(count == elements.size());
+	std::vector<bool> expected(100003);
+	for (auto &value: elements) expected[static_cast<std::size_t>(value.first)] = true;
+	for (int i = -1; i < 100003; ++i)
+		TEST_ASSERT(elements.contains(i) == (i >= 0 && expected[static_cast<std::size_t>(i)]));
+
+	/* Duplicate keys are rejected when constructed at run-time. */
+	thrown = false;
+	try { static_cast<void>(tpp::make_static_set<std::string_view>({"a"sv, "b"sv, "a"sv})); }
+	catch (const std::invalid_argument &) { thrown = true; }
+	TEST_ASSERT(thrown);
+
+	const auto set = tpp::make_static_set<std::string_view>({"if", "else", "for", "while", "do", "return"});
+	TEST_ASSERT(set.contains("while") && !set.contains("goto"));
+}
@@ -22,17 +22,97 @@ static_assert(std::is_same_v<decltype(tpp::ordered_sparse_set{std::declval<std::
 static_assert(std::is_same_v<decltype(tpp::sparse_map{std::declval<std::pair<std::string, int>>()}), tpp::sparse_map<std::string, int>>);
 static_assert(std::is_same_v<decltype(tpp::ordered_sparse_map{std::declval<std::pair<std::string, int>>()}), tpp::ordered_sparse_map<std::string, int>>);
 
+/* Hash that places small integer keys into the same metadata block, so that their probe sequences overlap. */
+struct colliding_hash
+{
+	std::size_t operator()(int key) const noexcept { return static_cast<std::size_t>(key); }
+};
+
+/* Copies of a table with erased elements must preserve probe sequences of the remaining elements. */
+template<template<typename...> typename T, typename map_t = T<int, int, colliding_hash>>
+static void test_copy_erased_map() noexcept
+{
+	const auto check = [](const map_t &map)
+	{
+		TEST_ASSERT(map.size() == 60);
+		for (int i = 0; i < 100; ++i) TEST_ASSERT(map.contains(i) == (i >= 40));
+	};
+
+	auto map = map_t{};
+	for (int i = 0; i < 100; ++i) map.emplace(i, i);
+	for (int i = 0; i < 40; ++i) map.erase(i);
+	check(map);
+
+	auto copy = map_t{map};
+	check(copy);
+	copy.clear();
+	copy = map;
+	check(copy);
+}
+
+/* Positions of copied elements depend on the capacity, thus assigning a smaller table must not keep the larger buffer. */
+template<template<typename...> typename T, typename map_t = T<int, int, colliding_hash>>
+static void test_assign_smaller_map() noexcept
+{
+	/* Keys are placed into the same block of the small table, but into different blocks of the large one. */
+	auto small = map_t{};
+	for (int i = 0; i < 20; ++i) small.emplace(i << 14, i);
+	auto large = map_t{};
+	for (int i = 0; i < 1000; ++i) large.emplace(i, i);
+	TEST_ASSERT(large.bucket_count() > small.bucket_count());
+
+	large = small;
+	for (int i = 0; i < 20; ++i) TEST_ASSERT(large.contains(i << 14) && large.at(i << 14) == i);
+	for (int i = 1; i < 1000; ++i) TEST_ASSERT(!large.contains(i));
+	TEST_ASSERT(large.size() == 20 && large.bucket_count() == small.bucket_count());
+}
+
+/* Assigning an empty table must not leave elements of the previous contents behind. */
+template<template<typename...> typename T, typename map_t = T<std::string, int>>
+static void test_assign_empty_map() noexcept
+{
+	const auto check = [](map_t &map)
+	{
+		TEST_ASSERT(map.empty() && map.begin() == map.end());
+		TEST_ASSERT(!map.contains("0") && map.find("0") == map.end());
+		TEST_ASSERT(map.emplace("0", 0).second && map.size() == 1 && map.at("0") == 0);
+	};
+
+	const auto empty = map_t{};
+	auto map = map_t{};
+	for (int i = 0; i < 100; ++i) map.emplace(std::to_string(i), i);
+	map = empty;
+	check(map);
+
+	map.clear();
+	for (int i = 0; i < 100; ++i) map.emplace(std::to_string(i), i);
+	map = map_t{};
+	check(map);
+}
+
 void test_sparse_set() noexcept { test_set<tpp::sparse_set>(); }
-void test_sparse_map() noexcept { test_map<tpp::sparse_map>(); }
+void test_sparse_map() noexcept
+{
+	test_map<tpp::sparse_map>();
+	test_emplace_map<tpp::sparse_map>();
+	test_copy_erased_map<tpp::sparse_map>();
+	test_assign_smaller_map<tpp::sparse_map>();
+	test_assign_empty_map<tpp::sparse_map>();
+}
 void test_ordered_sparse_set() noexcept
 {
 	test_set<tpp::ordered_sparse_set>();
 	test_ordered_set<tpp::ordered_sparse_set>();
+	test_compact_set<tpp::ordered_sparse_set>();
 }
 void test_ordered_sparse_map() noexcept
 {
 	test_map<tpp::ordered_sparse_map>();
 	test_ordered_map<tpp::ordered_sparse_map>();
+	test_compact_map<tpp::ordered_sparse_map>();
+	test_copy_erased_map<tpp::ordered_sparse_map>();
+	test_assign_smaller_map<tpp::ordered_sparse_map>();
+	test_assign_empty_map<tpp::ordered_sparse_map>();
 }
 
 #include <tpp/stable_set.hpp>
@@ -52,6 +132,10 @@ void test_stable_map() noexcept
 {
 	test_map<tpp::stable_map>();
 	test_node_map<tpp::stable_map>();
+	test_emplace_map<tpp::stable_map>();
+	test_copy_erased_map<tpp::stable_map>();
+	test_assign_smaller_map<tpp::stable_map>();
+	test_assign_empty_map<tpp::stable_map>();
 }
 void test_ordered_stable_set() noexcept
 {
@@ -64,4 +148,8 @@ void test_ordered_stable_map() noexcept
 	test_map<tpp::ordered_stable_map>();
 	test_ordered_map<tpp::ordered_stable_map>();
 	test_node_map<tpp::ordered_stable_map>();
+	test_emplace_map<tpp::ordered_stable_map>();
+	test_copy_erased_map<tpp::ordered_stable_map>();
+	test_assign_smaller_map<tpp::ordered_stable_map>();
+	test_assign_empty_map<tpp::ordered_stable_map>();
 }
\ No newline at end of file
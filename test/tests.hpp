@@ -25,6 +25,26 @@ void test_stable_map() noexcept;
 void test_ordered_stable_set() noexcept;
 void test_ordered_stable_map() noexcept;
 
+void test_sharded_map() noexcept;
+void test_concurrent_read_map() noexcept;
+void test_concurrent_insert_set() noexcept;
+void test_parallel_build() noexcept;
+void test_parallel_scan() noexcept;
+
+void test_swiss_snapshot() noexcept;
+void test_swiss_delta() noexcept;
+void test_cow_map() noexcept;
+void test_mapped_snapshot() noexcept;
+void test_dense_snapshot() noexcept;
+
+void test_fancy_pointer() noexcept;
+
+void test_frozen() noexcept;
+void test_static_map() noexcept;
+
+void test_fast_hash() noexcept;
+void test_seeded_hash() noexcept;
+
 static constexpr std::pair<std::string_view, void (*)()> tests[] = {
 		{"dense_set", test_dense_set},
 		{"dense_map", test_dense_map},
@@ -42,4 +62,24 @@ static constexpr std::pair<std::string_view, void (*)()> tests[] = {
 		{"stable_map", test_stable_map},
 		{"ordered_stable_set", test_ordered_stable_set},
 		{"ordered_stable_map", test_ordered_stable_map},
+
+		{"sharded_map", test_sharded_map},
+		{"concurrent_read_map", test_concurrent_read_map},
+		{"concurrent_insert_set", test_concurrent_insert_set},
+		{"parallel_build", test_parallel_build},
+		{"parallel_scan", test_parallel_scan},
+
+		{"swiss_snapshot", test_swiss_snapshot},
+		{"swiss_delta", test_swiss_delta},
+		{"cow_map", test_cow_map},
+		{"mapped_snapshot", test_mapped_snapshot},
+		{"dense_snapshot", test_dense_snapshot},
+
+		{"fancy_pointer", test_fancy_pointer},
+
+		{"frozen", test_frozen},
+		{"static_map", test_static_map},
+
+		{"fast_hash", test_fast_hash},
+		{"seeded_hash", test_seeded_hash},
 };
\ No newline at end of file
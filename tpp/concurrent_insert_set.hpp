@@ -0,0 +1,230 @@
+/*
+ * Created by switchblade on 2023-01-22.
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <thread>
+
+#include "detail/table_common.hpp"
+#include "detail/meta_block.hpp"
+
+namespace tpp
+{
+	/** @brief Fixed-capacity, insert-only SwissHash set that supports concurrent insertion and lookup without locks.
+	 *
+	 * The set is intended for deduplication of large streams of values by multiple threads, where the upper bound of the
+	 * amount of unique values is known in advance. Capacity of the set is allocated on construction and is never changed,
+	 * and elements can not be erased, which allows insertion to proceed without locks:
+	 * <ul>
+	 * <li>An empty slot is claimed by a compare-exchange of it's metadata byte from `empty` to a reserved value.</li>
+	 * <li>The value is then constructed in the claimed slot, after which the final 7-bit hash tag is published with release semantics.</li>
+	 * <li>Inserting threads that encounter a reserved slot within the probed block spin-wait (yielding after a few attempts) for
+	 * it's tag to be published, as the slot may be receiving an equal value. Lookups treat reserved slots as not yet inserted and never wait.</li>
+	 * </ul>
+	 * Insertion is therefore blocking rather than lock-free: an inserting thread that is stalled between claiming a slot and
+	 * publishing it's tag blocks other inserts probing the same block until it resumes. Lookups are not affected.
+	 *
+	 * Operations other than `insert`, `contains`, `size` & `visit_all` must not be called concurrently with any other operation.
+	 *
+	 * @tparam T Value type stored by the set.
+	 * @tparam Hash Hash functor used by the set.
+	 * @tparam Cmp Compare functor used by the set.
+	 * @tparam Alloc Allocator used by the set. */
+	template<typename T, typename Hash = std::hash<T>, typename Cmp = std::equal_to<T>, typename Alloc = std::allocator<T>>
+	class concurrent_insert_set : _detail::empty_base<Hash>, _detail::empty_base<Cmp>, _detail::empty_base<Alloc>
+	{
+	public:
+		using value_type = T;
+
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using hasher = Hash;
+		using key_equal = Cmp;
+		using allocator_type = Alloc;
+
+	private:
+		using hash_base = _detail::empty_base<Hash>;
+		using cmp_base = _detail::empty_base<Cmp>;
+		using alloc_base = _detail::empty_base<Alloc>;
+
+		using meta_byte = _detail::meta_byte;
+		using meta_block = _detail::meta_block;
+
+		struct slot_t { alignas(T) unsigned char bytes[sizeof(T)]; };
+
+		using meta_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::atomic<meta_byte>>;
+		using slot_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<slot_t>;
+		using value_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+		/* Since elements are never erased, the `deleted` metadata value is free to mark slots that are claimed, but not yet published. */
+		constexpr static meta_byte reserved = meta_byte::deleted;
+
+	public:
+		/** Initializes the set with enough capacity for at least `n` elements, using the specified hasher, comparator & allocator. */
+		explicit concurrent_insert_set(size_type n, const hasher &hash = {}, const key_equal &cmp = {}, const allocator_type &alloc = {})
+				: hash_base(hash), cmp_base(cmp), alloc_base(alloc)
+		{
+			/* Keep the load factor at or below 7/8 to keep probe sequences short. */
+			m_capacity = sizeof(meta_block);
+			while (m_capacity - m_capacity / 8 < n) m_capacity *= 2;
+
+			auto m_alloc = meta_alloc{alloc_base::value()};
+			auto s_alloc = slot_alloc{alloc_base::value()};
+			m_meta = _detail::to_address(std::allocator_traits<meta_alloc>::allocate(m_alloc, m_capacity));
+			try { m_slots = _detail::to_address(std::allocator_traits<slot_alloc>::allocate(s_alloc, m_capacity)); }
+			catch (...)
+			{
+				std::allocator_traits<meta_alloc>::deallocate(m_alloc, m_meta, m_capacity);
+				throw;
+			}
+			for (size_type i = 0; i < m_capacity; ++i)
+				new(m_meta + i) std::atomic<meta_byte>(meta_byte::empty);
+		}
+
+		concurrent_insert_set(const concurrent_insert_set &) = delete;
+		concurrent_insert_set &operator=(const concurrent_insert_set &) = delete;
+
+		~concurrent_insert_set()
+		{
+			clear();
+
+			auto m_alloc = meta_alloc{alloc_base::value()};
+			auto s_alloc = slot_alloc{alloc_base::value()};
+			std::allocator_traits<meta_alloc>::deallocate(m_alloc, m_meta, m_capacity);
+			std::allocator_traits<slot_alloc>::deallocate(s_alloc, m_slots, m_capacity);
+		}
+
+		/** Returns the amount of elements within the set.
+		 * @note If called concurrently with `insert`, the result may be stale. */
+		[[nodiscard]] size_type size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+		/** Checks if the set is empty. */
+		[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+		/** Returns the total amount of slots of the set. This is the hard limit of the amount of elements. */
+		[[nodiscard]] size_type capacity() const noexcept { return m_capacity; }
+
+		/** Inserts `value` into the set if it is not present yet. Safe to call concurrently with other `insert` and lookup operations.
+		 * May spin-wait for concurrent inserts into the probed blocks to complete.
+		 * @return `true` if the value was inserted, `false` if an equal value is already present.
+		 * @throw std::length_error If the value is not present, and there are no free slots left. */
+		bool insert(const value_type &value) { return do_insert(value); }
+		/** @copydoc insert */
+		bool insert(value_type &&value) { return do_insert(std::move(value)); }
+
+		/** Checks if the specified value is present within the set. Values that are concurrently being inserted may be reported as not present. */
+		[[nodiscard]] bool contains(const value_type &value) const
+		{
+			const auto h = hash(value);
+			const auto [h1, h2] = _detail::decompose_hash(h);
+			for (size_type pos = h1 & (m_capacity - 1), idx = 0; idx < m_capacity; idx += sizeof(meta_block), pos = (pos + idx) & (m_capacity - 1))
+			{
+				const auto block = _detail::load_block(m_meta, pos, m_capacity);
+				for (auto match = block.match_eq(h2); !match.empty(); ++match)
+					TPP_IF_LIKELY(cmp(slot_value(pos + match.lsb_index()), value))
+						return true;
+				TPP_IF_UNLIKELY(!block.match_empty().empty())
+					break;
+			}
+			return false;
+		}
+		/** Invokes `f` with a const reference to every element of the set. Elements inserted concurrently with the call may or may not be visited. */
+		template<typename F>
+		void visit_all(F &&f) const
+		{
+			for (size_type i = 0; i < m_capacity; ++i)
+				if (_detail::is_occupied(m_meta[i].load(std::memory_order_acquire)))
+					f(std::as_const(slot_value(i)));
+		}
+
+		/** Removes all elements from the set.
+		 * @note This function must not be called concurrently with any other operation. */
+		void clear()
+		{
+			auto alloc = value_alloc{alloc_base::value()};
+			for (size_type i = 0; i < m_capacity; ++i)
+			{
+				auto &meta = m_meta[i];
+				if (_detail::is_occupied(meta.load(std::memory_order_relaxed)))
+					std::allocator_traits<value_alloc>::destroy(alloc, &slot_value(i));
+				meta.store(meta_byte::empty, std::memory_order_relaxed);
+			}
+			m_size.store(0, std::memory_order_relaxed);
+		}
+
+		/** Returns copy of the hash function used by the set. */
+		[[nodiscard]] hasher hash_function() const { return hash_base::value(); }
+		/** Returns copy of the key comparator used by the set. */
+		[[nodiscard]] key_equal key_eq() const { return cmp_base::value(); }
+		/** Returns copy of the allocator used by the set. */
+		[[nodiscard]] allocator_type get_allocator() const { return alloc_base::value(); }
+
+	private:
+		[[nodiscard]] std::size_t hash(const value_type &value) const { return hash_base::value()(value); }
+		[[nodiscard]] bool cmp(const value_type &a, const value_type &b) const { return cmp_base::value()(a, b); }
+
+		[[nodiscard]] value_type &slot_value(size_type i) const noexcept
+		{
+			return *std::launder(reinterpret_cast<value_type *>(m_slots[i & (m_capacity - 1)].bytes));
+		}
+
+		/* Waits until none of the slots of the block at `pos` are reserved and returns the resulting block. */
+		[[nodiscard]] meta_block wait_block(size_type pos) const noexcept
+		{
+			for (std::size_t spins = 0;; ++spins)
+			{
+				const auto block = _detail::load_block(m_meta, pos, m_capacity);
+				TPP_IF_LIKELY(block.match_eq(reserved).empty())
+					return block;
+				if (spins >= 64) std::this_thread::yield();
+			}
+		}
+
+		template<typename U>
+		bool do_insert(U &&value)
+		{
+			const auto h = hash(value);
+			const auto [h1, h2] = _detail::decompose_hash(h);
+			for (size_type pos = h1 & (m_capacity - 1), idx = 0; idx < m_capacity; idx += sizeof(meta_block), pos = (pos + idx) & (m_capacity - 1))
+			{
+				for (;;)
+				{
+					/* Reserved slots of the block may be receiving an equal value, so wait for them to be published before comparing. */
+					const auto block = wait_block(pos);
+					for (auto match = block.match_eq(h2); !match.empty(); ++match)
+						TPP_IF_LIKELY(cmp(slot_value(pos + match.lsb_index()), value))
+							return false;
+
+					/* Continue to the next block if there are no empty slots. Since slots never become empty again, no equal value can be inserted into this block later. */
+					const auto empty = block.match_empty();
+					if (empty.empty()) break;
+
+					/* Claim the first empty slot. If another thread claims it first, re-check the block, as it may have inserted an equal value. */
+					const auto slot = (pos + empty.lsb_index()) & (m_capacity - 1);
+					if (auto expected = meta_byte::empty; m_meta[slot].compare_exchange_strong(expected, reserved, std::memory_order_acquire, std::memory_order_relaxed))
+					{
+						auto alloc = value_alloc{alloc_base::value()};
+						try { std::allocator_traits<value_alloc>::construct(alloc, &slot_value(slot), std::forward<U>(value)); }
+						catch (...)
+						{
+							/* No other thread could have observed a value in the slot, so it is safe to release it. */
+							m_meta[slot].store(meta_byte::empty, std::memory_order_release);
+							throw;
+						}
+
+						m_meta[slot].store(h2, std::memory_order_release);
+						m_size.fetch_add(1, std::memory_order_relaxed);
+						return true;
+					}
+				}
+			}
+			throw std::length_error("Concurrent insert set capacity exceeded");
+		}
+
+		std::atomic<meta_byte> *m_meta = nullptr;
+		slot_t *m_slots = nullptr;
+		size_type m_capacity = 0;
+		std::atomic<size_type> m_size = 0;
+	};
+}
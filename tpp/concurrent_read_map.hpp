@@ -0,0 +1,453 @@
+/*
+ * Created by switchblade on 2023-01-21.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "detail/table_common.hpp"
+#include "detail/meta_block.hpp"
+#include "detail/epoch.hpp"
+
+namespace tpp
+{
+	/** @brief SwissHash-based map that allows a single writer thread to run concurrently with any number of reader threads.
+	 *
+	 * Readers never take locks and never block - every read operation is wait-free (except for the very first read of
+	 * every thread, which registers the thread within the reclamation domain). To make this possible:
+	 * <ul>
+	 * <li>Elements are allocated individually, and the table stores atomic pointers to the element nodes together with atomic metadata bytes.</li>
+	 * <li>New nodes are fully constructed before their pointer and metadata tag are published with release semantics.</li>
+	 * <li>Rehash never modifies the published buffers in-place. A new buffer is built and published instead, and the old one is retired.</li>
+	 * <li>Erased nodes, nodes replaced by `insert_or_assign` and old buffers are retired through epoch-based reclamation,
+	 * and are destroyed only once every reader that could observe them has finished.</li>
+	 * </ul>
+	 * Element values are never modified in-place once published. As such, readers only get const access to elements and
+	 * modification is done by replacing the element node. Write operations must be externally synchronized with each other
+	 * (i.e. only one thread may write at a time), but not with reads. Destruction of the map must not overlap with any other operation.
+	 *
+	 * @tparam Key Key type stored by the map.
+	 * @tparam Mapped Mapped type associated with map keys.
+	 * @tparam KeyHash Hash functor used by the map.
+	 * @tparam KeyCmp Compare functor used by the map.
+	 * @tparam Alloc Allocator used by the map. Must use raw pointers, as node pointers are published atomically. */
+	template<typename Key, typename Mapped, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<const Key, Mapped>>>
+	class concurrent_read_map : _detail::empty_base<KeyHash>, _detail::empty_base<KeyCmp>, _detail::empty_base<Alloc>
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Mapped;
+		using value_type = std::pair<const key_type, mapped_type>;
+
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using hasher = KeyHash;
+		using key_equal = KeyCmp;
+		using allocator_type = Alloc;
+
+	private:
+		using hash_base = _detail::empty_base<KeyHash>;
+		using cmp_base = _detail::empty_base<KeyCmp>;
+		using alloc_base = _detail::empty_base<Alloc>;
+
+		using meta_byte = _detail::meta_byte;
+		using meta_block = _detail::meta_block;
+
+		struct node_t
+		{
+			template<typename... Args>
+			node_t(std::size_t hash, Args &&...args) : value(std::forward<Args>(args)...), hash(hash) {}
+
+			value_type value;
+			std::size_t hash;
+		};
+		/* Table buffer. Capacity is always a power of two no less than the size of a metadata block. */
+		struct buffer_t
+		{
+			size_type capacity;
+			std::atomic<meta_byte> *meta;
+			std::atomic<node_t *> *nodes;
+		};
+		struct retired_t
+		{
+			std::uint64_t epoch;
+			node_t *node;
+			buffer_t *buffer;
+		};
+
+		using node_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<node_t>;
+		using buffer_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<buffer_t>;
+		using meta_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::atomic<meta_byte>>;
+		using slot_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::atomic<node_t *>>;
+
+		static_assert(std::is_same_v<typename std::allocator_traits<node_alloc>::pointer, node_t *>, "Allocator must use raw pointers");
+
+		/* Amount of retired objects after which the writer attempts to reclaim them. */
+		constexpr static std::size_t reclaim_threshold = 64;
+		constexpr static size_type min_capacity = sizeof(meta_block);
+
+		[[nodiscard]] static _detail::epoch_domain &domain() noexcept { return _detail::epoch_domain::instance(); }
+
+	public:
+		/** Initializes an empty map. */
+		concurrent_read_map() = default;
+		/** Initializes an empty map using the specified hasher, comparator & allocator. */
+		explicit concurrent_read_map(const hasher &hash, const key_equal &cmp = {}, const allocator_type &alloc = {})
+				: hash_base(hash), cmp_base(cmp), alloc_base(alloc) {}
+
+		concurrent_read_map(const concurrent_read_map &) = delete;
+		concurrent_read_map &operator=(const concurrent_read_map &) = delete;
+
+		~concurrent_read_map()
+		{
+			if (auto *buffer = m_buffer.load(std::memory_order_relaxed); buffer)
+			{
+				for (size_type i = 0; i < buffer->capacity; ++i)
+					if (_detail::is_occupied(buffer->meta[i].load(std::memory_order_relaxed)))
+						destroy_node(buffer->nodes[i].load(std::memory_order_relaxed));
+				destroy_buffer(buffer);
+			}
+			for (auto &retired: m_retired) destroy_retired(retired);
+		}
+
+		/** Returns the amount of elements within the map.
+		 * @note If called concurrently with a write operation, the result may be stale. */
+		[[nodiscard]] size_type size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+		/** Checks if the map is empty. */
+		[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+		/** Returns the current capacity of the map (amount of slots of it's buffer). */
+		[[nodiscard]] size_type capacity() const
+		{
+			const auto guard = domain().pin();
+			return buffer_capacity(m_buffer.load(std::memory_order_acquire));
+		}
+
+		/** Returns a copy of the mapped value at the specified key, or an empty optional if no such element exists.
+		 * @note This function is safe to call concurrently with a write operation. */
+		[[nodiscard]] std::optional<mapped_type> find(const key_type &key) const
+		{
+			std::optional<mapped_type> result;
+			visit(key, [&](const value_type &value) { result.emplace(value.second); });
+			return result;
+		}
+		/** Checks if the specified element is present within the map.
+		 * @note This function is safe to call concurrently with a write operation. */
+		[[nodiscard]] bool contains(const key_type &key) const
+		{
+			const auto guard = domain().pin();
+			return find_node(m_buffer.load(std::memory_order_acquire), key, hash(key)) != nullptr;
+		}
+		/** Invokes `f` with a const reference to the element at the specified key. The element is guaranteed to stay alive for the duration of the call.
+		 * @return `true` if the element was found, `false` otherwise.
+		 * @note This function is safe to call concurrently with a write operation. */
+		template<typename F>
+		bool visit(const key_type &key, F &&f) const
+		{
+			const auto guard = domain().pin();
+			if (const auto *node = find_node(m_buffer.load(std::memory_order_acquire), key, hash(key)); node)
+			{
+				f(std::as_const(node->value));
+				return true;
+			}
+			return false;
+		}
+		/** Invokes `f` with a const reference to every element of the map. Elements inserted or erased concurrently with the call may or may not be visited.
+		 * @note This function is safe to call concurrently with a write operation. */
+		template<typename F>
+		void visit_all(F &&f) const
+		{
+			const auto guard = domain().pin();
+			if (const auto *buffer = m_buffer.load(std::memory_order_acquire); buffer)
+				for (size_type i = 0; i < buffer->capacity; ++i)
+				{
+					if (!_detail::is_occupied(buffer->meta[i].load(std::memory_order_acquire)))
+						continue;
+					if (const auto *node = buffer->nodes[i].load(std::memory_order_acquire); node)
+						f(std::as_const(node->value));
+				}
+		}
+
+		/** Inserts a mapped value constructed from `args` at the specified key, if the key does not exist yet.
+		 * @return `true` if the element was inserted, `false` otherwise.
+		 * @note Write operations must not be called concurrently with each other. */
+		template<typename... Args>
+		bool try_emplace(const key_type &key, Args &&...args)
+		{
+			const auto h = hash(key);
+			if (const auto [node, slot] = find_slot(key, h); node != nullptr)
+				return false;
+			else
+				insert_node(slot, h, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+			return true;
+		}
+		/** Inserts a mapped value at the specified key, or replaces the element at the key if it already exists.
+		 * The replaced element is retired, and is destroyed once no readers can observe it.
+		 * @return `true` if the element was inserted, `false` if it was replaced.
+		 * @note Write operations must not be called concurrently with each other. */
+		template<typename M>
+		bool insert_or_assign(const key_type &key, M &&value)
+		{
+			const auto h = hash(key);
+			if (const auto [node, slot] = find_slot(key, h); node == nullptr)
+			{
+				insert_node(slot, h, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<M>(value)));
+				return true;
+			}
+			else
+			{
+				auto *buffer = m_buffer.load(std::memory_order_relaxed);
+				auto *replacement = make_node(h, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<M>(value)));
+				buffer->nodes[slot].store(replacement, std::memory_order_release);
+				retire(node, nullptr);
+				return false;
+			}
+		}
+		/** Removes the element at the specified key. The removed element is retired, and is destroyed once no readers can observe it.
+		 * @return `1` if the element was removed, `0` otherwise.
+		 * @note Write operations must not be called concurrently with each other. */
+		size_type erase(const key_type &key)
+		{
+			const auto [node, slot] = find_slot(key, hash(key));
+			if (node == nullptr) return 0;
+
+			auto *buffer = m_buffer.load(std::memory_order_relaxed);
+			buffer->meta[slot].store(meta_byte::deleted, std::memory_order_release);
+			buffer->nodes[slot].store(nullptr, std::memory_order_release);
+			m_size.store(size() - 1, std::memory_order_relaxed);
+			++m_num_deleted;
+
+			retire(node, nullptr);
+			return 1;
+		}
+		/** Removes all elements from the map. The removed elements are retired, and are destroyed once no readers can observe them.
+		 * @note Write operations must not be called concurrently with each other. */
+		void clear()
+		{
+			if (auto *buffer = m_buffer.exchange(nullptr, std::memory_order_acq_rel); buffer)
+			{
+				for (size_type i = 0; i < buffer->capacity; ++i)
+					if (_detail::is_occupied(buffer->meta[i].load(std::memory_order_relaxed)))
+						retire(buffer->nodes[i].load(std::memory_order_relaxed), nullptr);
+				retire(nullptr, buffer);
+			}
+			m_size.store(0, std::memory_order_relaxed);
+			m_num_deleted = 0;
+		}
+
+		/** Rehashes the map for at least `n` elements.
+		 * @note Write operations must not be called concurrently with each other. */
+		void reserve(size_type n)
+		{
+			if (n > _detail::capacity_to_max_size(buffer_capacity(m_buffer.load(std::memory_order_relaxed))))
+			{
+				auto cap = min_capacity;
+				while (_detail::capacity_to_max_size(cap) < n) cap *= 2;
+				do_rehash(cap);
+			}
+		}
+		/** Attempts to destroy retired elements and buffers that are no longer observable by readers.
+		 * Retired objects are also reclaimed automatically by write operations.
+		 * @note Write operations must not be called concurrently with each other. */
+		void reclaim()
+		{
+			const auto min_epoch = domain().min_active();
+			const auto pred = [&](const retired_t &retired) { return retired.epoch < min_epoch; };
+			for (auto &retired: m_retired)
+				if (pred(retired)) destroy_retired(retired);
+			m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), pred), m_retired.end());
+		}
+
+		/** Returns copy of the hash function used by the map. */
+		[[nodiscard]] hasher hash_function() const { return hash_base::value(); }
+		/** Returns copy of the key comparator used by the map. */
+		[[nodiscard]] key_equal key_eq() const { return cmp_base::value(); }
+		/** Returns copy of the allocator used by the map. */
+		[[nodiscard]] allocator_type get_allocator() const { return alloc_base::value(); }
+
+	private:
+		[[nodiscard]] static size_type buffer_capacity(const buffer_t *buffer) noexcept { return buffer ? buffer->capacity : 0; }
+
+		[[nodiscard]] std::size_t hash(const key_type &key) const { return hash_base::value()(key); }
+		[[nodiscard]] bool cmp(const key_type &a, const key_type &b) const { return cmp_base::value()(a, b); }
+
+		[[nodiscard]] static meta_block load_block(const buffer_t *buffer, size_type pos) noexcept
+		{
+			return _detail::load_block(buffer->meta, pos, buffer->capacity);
+		}
+
+		/* Probes `buffer` for the node of `key`, and returns it together with the first available slot of the probe sequence. */
+		template<bool Writer>
+		[[nodiscard]] std::pair<node_t *, size_type> probe(const buffer_t *buffer, const key_type &key, std::size_t h) const
+		{
+			auto slot = std::numeric_limits<size_type>::max();
+			if (buffer != nullptr)
+			{
+				const auto [h1, h2] = _detail::decompose_hash(h);
+				const auto mask = buffer->capacity - 1;
+				for (size_type pos = h1 & mask, idx = 0; idx < buffer->capacity; idx += sizeof(meta_block), pos = (pos + idx) & mask)
+				{
+					const auto block = load_block(buffer, pos);
+					for (auto match = block.match_eq(h2); !match.empty(); ++match)
+					{
+						const auto offset = (pos + match.lsb_index()) & mask;
+						auto *node = buffer->nodes[offset].load(std::memory_order_acquire);
+
+						/* The node may be null if the slot was erased after it's metadata was read. */
+						TPP_IF_LIKELY(node != nullptr && node->hash == h && cmp(node->value.first, key))
+							return {node, offset};
+					}
+
+					if constexpr (Writer)
+						if (slot == std::numeric_limits<size_type>::max())
+							if (const auto available = block.match_available(); !available.empty())
+								slot = (pos + available.lsb_index()) & mask;
+					TPP_IF_UNLIKELY(!block.match_empty().empty())
+						break;
+				}
+			}
+			return {nullptr, slot};
+		}
+		[[nodiscard]] const node_t *find_node(const buffer_t *buffer, const key_type &key, std::size_t h) const
+		{
+			return probe<false>(buffer, key, h).first;
+		}
+		[[nodiscard]] std::pair<node_t *, size_type> find_slot(const key_type &key, std::size_t h) const
+		{
+			return probe<true>(m_buffer.load(std::memory_order_relaxed), key, h);
+		}
+
+		template<typename... Args>
+		void insert_node(size_type slot, std::size_t h, Args &&...args)
+		{
+			if (const auto cap = _detail::rehash_capacity(buffer_capacity(m_buffer.load(std::memory_order_relaxed)), size(), m_num_deleted, min_capacity); cap != 0)
+			{
+				do_rehash(cap);
+				slot = find_available(m_buffer.load(std::memory_order_relaxed), h);
+			}
+
+			auto *buffer = m_buffer.load(std::memory_order_relaxed);
+			auto *node = make_node(h, std::piecewise_construct, std::forward<Args>(args)...);
+
+			/* Publish the node before the metadata, so that readers matching the tag see the constructed node. */
+			m_num_deleted -= buffer->meta[slot].load(std::memory_order_relaxed) == meta_byte::deleted;
+			buffer->nodes[slot].store(node, std::memory_order_release);
+			buffer->meta[slot].store(_detail::decompose_hash(h).second, std::memory_order_release);
+			m_size.store(size() + 1, std::memory_order_relaxed);
+		}
+		[[nodiscard]] static size_type find_available(const buffer_t *buffer, std::size_t h) noexcept
+		{
+			const auto mask = buffer->capacity - 1;
+			for (size_type pos = _detail::decompose_hash(h).first & mask, idx = 0;; idx += sizeof(meta_block), pos = (pos + idx) & mask)
+			{
+				const auto block = load_block(buffer, pos);
+				if (const auto match = block.match_available(); !match.empty())
+					return (pos + match.lsb_index()) & mask;
+				TPP_ASSERT(idx < buffer->capacity, "Probe must not exceed table capacity");
+			}
+		}
+
+		void do_rehash(size_type cap)
+		{
+			/* Build the new buffer, and only then publish it. Nodes are shared between the old & new buffers. */
+			auto *old_buffer = m_buffer.load(std::memory_order_relaxed);
+			auto *new_buffer = make_buffer(cap);
+			if (old_buffer != nullptr)
+				for (size_type i = 0; i < old_buffer->capacity; ++i)
+				{
+					if (!_detail::is_occupied(old_buffer->meta[i].load(std::memory_order_relaxed)))
+						continue;
+
+					auto *node = old_buffer->nodes[i].load(std::memory_order_relaxed);
+					const auto slot = find_available(new_buffer, node->hash);
+					new_buffer->nodes[slot].store(node, std::memory_order_relaxed);
+					new_buffer->meta[slot].store(_detail::decompose_hash(node->hash).second, std::memory_order_relaxed);
+				}
+
+			m_buffer.store(new_buffer, std::memory_order_release);
+			m_num_deleted = 0;
+			if (old_buffer != nullptr) retire(nullptr, old_buffer);
+		}
+
+		void retire(node_t *node, buffer_t *buffer)
+		{
+			m_retired.push_back({domain().retire_epoch(), node, buffer});
+			if (m_retired.size() >= reclaim_threshold) reclaim();
+		}
+		void destroy_retired(const retired_t &retired)
+		{
+			if (retired.node) destroy_node(retired.node);
+			if (retired.buffer) destroy_buffer(retired.buffer);
+		}
+
+		template<typename... Args>
+		[[nodiscard]] node_t *make_node(std::size_t h, Args &&...args)
+		{
+			auto alloc = node_alloc{alloc_base::value()};
+			auto *node = std::allocator_traits<node_alloc>::allocate(alloc, 1);
+			try { std::allocator_traits<node_alloc>::construct(alloc, node, h, std::forward<Args>(args)...); }
+			catch (...)
+			{
+				std::allocator_traits<node_alloc>::deallocate(alloc, node, 1);
+				throw;
+			}
+			return node;
+		}
+		void destroy_node(node_t *node)
+		{
+			auto alloc = node_alloc{alloc_base::value()};
+			std::allocator_traits<node_alloc>::destroy(alloc, node);
+			std::allocator_traits<node_alloc>::deallocate(alloc, node, 1);
+		}
+
+		[[nodiscard]] buffer_t *make_buffer(size_type cap)
+		{
+			auto b_alloc = buffer_alloc{alloc_base::value()};
+			auto m_alloc = meta_alloc{alloc_base::value()};
+			auto s_alloc = slot_alloc{alloc_base::value()};
+
+			auto *buffer = _detail::to_address(std::allocator_traits<buffer_alloc>::allocate(b_alloc, 1));
+			buffer->capacity = cap;
+			buffer->meta = nullptr;
+			buffer->nodes = nullptr;
+			try
+			{
+				buffer->meta = _detail::to_address(std::allocator_traits<meta_alloc>::allocate(m_alloc, cap));
+				buffer->nodes = _detail::to_address(std::allocator_traits<slot_alloc>::allocate(s_alloc, cap));
+			}
+			catch (...)
+			{
+				destroy_buffer(buffer);
+				throw;
+			}
+			for (size_type i = 0; i < cap; ++i)
+			{
+				new(buffer->meta + i) std::atomic<meta_byte>(meta_byte::empty);
+				new(buffer->nodes + i) std::atomic<node_t *>(nullptr);
+			}
+			return buffer;
+		}
+		void destroy_buffer(buffer_t *buffer)
+		{
+			auto b_alloc = buffer_alloc{alloc_base::value()};
+			auto m_alloc = meta_alloc{alloc_base::value()};
+			auto s_alloc = slot_alloc{alloc_base::value()};
+
+			if (buffer->meta) std::allocator_traits<meta_alloc>::deallocate(m_alloc, buffer->meta, buffer->capacity);
+			if (buffer->nodes) std::allocator_traits<slot_alloc>::deallocate(s_alloc, buffer->nodes, buffer->capacity);
+			std::allocator_traits<buffer_alloc>::deallocate(b_alloc, buffer, 1);
+		}
+
+		std::atomic<buffer_t *> m_buffer = nullptr;
+		std::atomic<size_type> m_size = 0;
+
+		/* State below is only accessed by the writer. */
+		size_type m_num_deleted = 0;
+		std::vector<retired_t> m_retired;
+	};
+}
@@ -0,0 +1,688 @@
+/*
+ * Created by switchblade on 2023-01-30.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <atomic>
+#include <tuple>
+#include <cmath>
+#include <new>
+
+#include "detail/table_common.hpp"
+#include "detail/meta_block.hpp"
+
+namespace tpp
+{
+	/** @brief SwissHash-based map with O(1) copy-on-write snapshots.
+	 *
+	 * Internally, the map splits it's metadata & element buffers into pages, each of which holds a fixed amount of metadata
+	 * blocks together with their elements. Pages, as well as the directory of pages, are reference-counted and shared between
+	 * a map and it's copies (snapshots). To make this possible:
+	 * <ul>
+	 * <li>Probe sequences move between whole metadata blocks, and blocks never span multiple pages.</li>
+	 * <li>Shared pages are never modified. Before a page is modified (or a mutable reference to it's element is returned),
+	 * the map copies the page together with the directory if either of them is shared.</li>
+	 * </ul>
+	 * Copying the map (ex. via `snapshot`) is therefore O(1), and the first modification of the map or the copy afterwards costs
+	 * a copy of the directory (one pointer per page) and of the modified page. Every page modified later on is copied once.<br><br>
+	 * Elements are only accessed via const references, except for `at` and `operator[]`, which copy the page of the element if it is shared.
+	 * Different copies of the map may be used by different threads concurrently (including modification), as shared pages are never modified.
+	 * A single map object must not be accessed concurrently with it's modification.
+	 *
+	 * @tparam Key Key type stored by the map.
+	 * @tparam Mapped Mapped type associated with map keys.
+	 * @tparam KeyHash Hash functor used by the map.
+	 * @tparam KeyCmp Compare functor used by the map.
+	 * @tparam Alloc Allocator used by the map. */
+	template<typename Key, typename Mapped, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<const Key, Mapped>>>
+	class cow_map : _detail::empty_base<KeyHash>, _detail::empty_base<KeyCmp>, _detail::empty_base<Alloc>
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Mapped;
+		using value_type = std::pair<const key_type, mapped_type>;
+
+		using reference = const value_type &;
+		using const_reference = const value_type &;
+		using pointer = const value_type *;
+		using const_pointer = const value_type *;
+
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using hasher = KeyHash;
+		using key_equal = KeyCmp;
+		using allocator_type = Alloc;
+
+	private:
+		using hash_base = _detail::empty_base<KeyHash>;
+		using cmp_base = _detail::empty_base<KeyCmp>;
+		using alloc_base = _detail::empty_base<Alloc>;
+
+		using meta_byte = _detail::meta_byte;
+		using meta_block = _detail::meta_block;
+
+		/* Amount of metadata blocks per page. Larger pages make the directory smaller, at the cost of larger copies. */
+		constexpr static size_type page_blocks = 4;
+		constexpr static size_type page_size = page_blocks * sizeof(meta_block);
+
+		struct slot_t { alignas(value_type) unsigned char bytes[sizeof(value_type)]; };
+		struct page_t
+		{
+			page_t() noexcept { std::fill_n(meta, page_size, meta_byte::empty); }
+
+			std::atomic<std::size_t> refs = 1;
+			meta_byte meta[page_size];
+			slot_t slots[page_size];
+		};
+
+		using page_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<page_t>;
+		using page_ptr = typename std::allocator_traits<page_alloc>::pointer;
+		using page_ptr_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<page_ptr>;
+		using page_array = typename std::allocator_traits<page_ptr_alloc>::pointer;
+		using value_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+
+		struct directory_t
+		{
+			directory_t(size_type num_pages, page_array pages) noexcept : num_pages(num_pages), pages(pages) {}
+
+			std::atomic<std::size_t> refs = 1;
+			size_type num_pages;
+			page_array pages;
+		};
+
+		using directory_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<directory_t>;
+		using directory_ptr = typename std::allocator_traits<directory_alloc>::pointer;
+
+		[[nodiscard]] static value_type &slot_value(page_t *page, size_type i) noexcept
+		{
+			return *std::launder(reinterpret_cast<value_type *>(page->slots[i].bytes));
+		}
+		[[nodiscard]] static page_t *get_page(const directory_t *dir, size_type i) noexcept { return _detail::to_address(dir->pages[i]); }
+
+	public:
+		/** Forward iterator to elements of the map, who's `operator->` returns `const_pointer`, and `operator*` returns `const_reference`.
+		 * @note Iterators are invalidated by any modification of the map, as well as by `at` and `operator[]`. */
+		class const_iterator
+		{
+			friend class cow_map;
+
+		public:
+			using value_type = typename cow_map::value_type;
+			using reference = typename cow_map::const_reference;
+			using pointer = typename cow_map::const_pointer;
+			using size_type = typename cow_map::size_type;
+			using difference_type = typename cow_map::difference_type;
+			using iterator_category = std::forward_iterator_tag;
+
+		private:
+			const_iterator(const directory_t *dir, size_type pos) noexcept : m_dir(dir), m_pos(pos) {}
+
+		public:
+			constexpr const_iterator() noexcept = default;
+
+			const_iterator operator++(int) noexcept
+			{
+				auto tmp = *this;
+				operator++();
+				return tmp;
+			}
+			const_iterator &operator++() noexcept
+			{
+				m_pos = next_occupied(m_dir, m_pos + 1);
+				return *this;
+			}
+
+			[[nodiscard]] pointer operator->() const noexcept { return &operator*(); }
+			[[nodiscard]] reference operator*() const noexcept { return slot_value(get_page(m_dir, m_pos / page_size), m_pos % page_size); }
+
+			[[nodiscard]] constexpr bool operator==(const const_iterator &other) const noexcept { return m_pos == other.m_pos; }
+#if (__cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L))
+			[[nodiscard]] constexpr bool operator!=(const const_iterator &other) const noexcept { return m_pos != other.m_pos; }
+#endif
+
+		private:
+			const directory_t *m_dir = nullptr;
+			size_type m_pos = 0;
+		};
+		using iterator = const_iterator;
+
+	public:
+		/** Initializes an empty map. */
+		cow_map() = default;
+		/** Initializes an empty map using the specified allocator. */
+		explicit cow_map(const allocator_type &alloc) : alloc_base(alloc) {}
+		/** Initializes the map with the specified bucket count, hasher, comparator and allocator. */
+		explicit cow_map(size_type bucket_count, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+				: hash_base(hash), cmp_base(cmp), alloc_base(alloc)
+		{
+			if (bucket_count != 0) rehash(bucket_count);
+		}
+
+		/** Copy-constructs the map. The copy shares all pages with \p other, and copies them on modification (see `snapshot`). */
+		cow_map(const cow_map &other) noexcept(std::is_nothrow_copy_constructible_v<hasher> && std::is_nothrow_copy_constructible_v<key_equal>)
+				: hash_base(other), cmp_base(other), alloc_base(other), m_dir(other.m_dir), m_size(other.m_size), m_num_deleted(other.m_num_deleted)
+		{
+			if (m_dir != nullptr) m_dir->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+		/** Move-constructs the map. */
+		cow_map(cow_map &&other) noexcept(std::is_nothrow_move_constructible_v<hasher> && std::is_nothrow_move_constructible_v<key_equal>)
+				: hash_base(std::move(other)), cmp_base(std::move(other)), alloc_base(std::move(other)),
+				  m_dir(std::exchange(other.m_dir, nullptr)), m_size(std::exchange(other.m_size, 0)), m_num_deleted(std::exchange(other.m_num_deleted, 0)) {}
+
+		/** Copy-assigns the map. Pages of \p other are shared with the map, as if by copy-construction. */
+		cow_map &operator=(const cow_map &other)
+		{
+			if (this != &other)
+			{
+				auto tmp = cow_map{other};
+				swap(tmp);
+			}
+			return *this;
+		}
+		/** Move-assigns the map. */
+		cow_map &operator=(cow_map &&other) noexcept(std::is_nothrow_swappable_v<hasher> && std::is_nothrow_swappable_v<key_equal>)
+		{
+			if (this != &other)
+			{
+				auto tmp = cow_map{std::move(other)};
+				swap(tmp);
+			}
+			return *this;
+		}
+
+		~cow_map() { release_directory(m_dir); }
+
+		/** Returns a copy-on-write snapshot of the map.
+		 *
+		 * Taking a snapshot is O(1), as the snapshot shares pages of the map instead of copying it's elements. Shared pages are never
+		 * modified, instead the map (or the snapshot) copies a page before the first modification of it's elements. Snapshots can be
+		 * read and modified by other threads while the map is modified, which allows to use them for consistent reads (ex. reporting)
+		 * of a continuously updated map.
+		 * @note Taking a snapshot must not be done concurrently with modification of the map. */
+		[[nodiscard]] cow_map snapshot() const { return *this; }
+
+		/** Returns iterator to the first element of the map.
+		 * @note Elements are stored in no particular order. */
+		[[nodiscard]] const_iterator begin() const noexcept { return {directory(), next_occupied(directory(), 0)}; }
+		/** @copydoc begin */
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		/** Returns iterator one past the last element of the map. */
+		[[nodiscard]] const_iterator end() const noexcept { return {directory(), bucket_count()}; }
+		/** @copydoc end */
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		/** Returns the total number of elements within the map. */
+		[[nodiscard]] size_type size() const noexcept { return m_size; }
+		/** Checks if the map is empty (`size() == 0`). */
+		[[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+		/** Returns the current capacity of the map (taking into account the maximum load factor). */
+		[[nodiscard]] size_type capacity() const noexcept { return _detail::capacity_to_max_size(bucket_count()); }
+		/** Returns the current amount of buckets of the map. */
+		[[nodiscard]] size_type bucket_count() const noexcept { return m_dir != nullptr ? m_dir->num_pages * page_size : 0; }
+		/** Returns the current load factor of the map as if via `size() / bucket_count()`. */
+		[[nodiscard]] float load_factor() const noexcept { return m_dir != nullptr ? static_cast<float>(size()) / static_cast<float>(bucket_count()) : 0.0f; }
+		/** Returns the maximum load factor. */
+		[[nodiscard]] constexpr float max_load_factor() const noexcept { return 0.875f; }
+
+		/** Erases all elements from the map. Pages shared with snapshots of the map are left intact. */
+		void clear()
+		{
+			release_directory(std::exchange(m_dir, nullptr));
+			m_size = 0;
+			m_num_deleted = 0;
+		}
+
+		/** @brief Inserts an element (of `value_type`) into the map if it does not exist yet.
+		 * @param value Value of the to-be inserted element.
+		 * @return Pair where `first` is the iterator to the inserted or existing element, and `second` is a boolean
+		 * indicating whether insertion took place (`true` if element was inserted, `false` otherwise). */
+		std::pair<iterator, bool> insert(const value_type &value) { return try_emplace(value.first, value.second); }
+		/** @copydoc insert */
+		std::pair<iterator, bool> insert(value_type &&value) { return try_emplace(value.first, std::move(value.second)); }
+
+		/** @brief Inserts an element constructed from `args` into the map if it does not exist yet.
+		 * @param args Arguments passed to constructor of `std::pair<key_type, mapped_type>`.
+		 * @return Pair where `first` is the iterator to the inserted or existing element, and `second` is a boolean
+		 * indicating whether insertion took place (`true` if element was inserted, `false` otherwise). */
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args &&...args)
+		{
+			auto tmp = std::pair<key_type, mapped_type>(std::forward<Args>(args)...);
+			return try_emplace(std::move(tmp.first), std::move(tmp.second));
+		}
+
+		/** Attempts to emplace piecewise constructed element (of `value_type`) at the specified key into the map if it does not exist yet.
+		 * @param key Key of the element to insert.
+		 * @param args Arguments passed to constructor of `mapped_type`.
+		 * @return Pair where `first` is the iterator to the inserted or existing element, and `second` is a boolean
+		 * indicating whether insertion took place (`true` if element was inserted, `false` otherwise). */
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const key_type &key, Args &&...args)
+		{
+			const auto [pos, inserted] = do_try_emplace(key, std::forward<Args>(args)...);
+			return {to_iter(pos), inserted};
+		}
+		/** @copydoc try_emplace */
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(key_type &&key, Args &&...args)
+		{
+			const auto [pos, inserted] = do_try_emplace(std::move(key), std::forward<Args>(args)...);
+			return {to_iter(pos), inserted};
+		}
+
+		/** @brief If the specified key is not present within the map, inserts a new element. Otherwise, assigns value of the existing element.
+		 * @param key Key of the element to insert or assign.
+		 * @param value Value to be assigned to the key.
+		 * @return Pair where `first` is the iterator to the inserted or existing element, and `second` is a boolean
+		 * indicating whether insertion took place (`true` if element was inserted, `false` otherwise). */
+		template<typename T>
+		std::pair<iterator, bool> insert_or_assign(const key_type &key, T &&value)
+		{
+			const auto [pos, inserted] = do_try_emplace(key, std::forward<T>(value));
+			if (!inserted) mutable_value(pos).second = std::forward<T>(value);
+			return {to_iter(pos), inserted};
+		}
+		/** @copydoc insert_or_assign */
+		template<typename T>
+		std::pair<iterator, bool> insert_or_assign(key_type &&key, T &&value)
+		{
+			const auto [pos, inserted] = do_try_emplace(std::move(key), std::forward<T>(value));
+			if (!inserted) mutable_value(pos).second = std::forward<T>(value);
+			return {to_iter(pos), inserted};
+		}
+
+		/** Removes the specified element from the map.
+		 * @param key Key of the element to remove.
+		 * @return `1` if the element was removed, `0` otherwise. */
+		size_type erase(const key_type &key)
+		{
+			if (const auto pos = find_pos(key, hash(key)); pos != bucket_count())
+			{
+				erase_at(pos);
+				return 1;
+			}
+			return 0;
+		}
+		/** Removes the specified element from the map.
+		 * @param where Iterator pointing to the element to remove.
+		 * @return Iterator to the element following the erased one, or `end()`. */
+		iterator erase(const_iterator where)
+		{
+			erase_at(where.m_pos);
+			return to_iter(next_occupied(directory(), where.m_pos + 1));
+		}
+		/** @brief Erases all elements of the map that satisfy the predicate \p pred.
+		 *
+		 * The predicate is invoked with a const reference to every element. Only pages that contain erased elements are copied.
+		 * @return Amount of elements erased.
+		 * @note Invalidates all iterators and references if any element was erased. */
+		template<typename P>
+		size_type erase_if(P pred)
+		{
+			size_type result = 0;
+			for (auto pos = next_occupied(directory(), 0); pos != bucket_count(); pos = next_occupied(directory(), pos + 1))
+			{
+				/* Erasing may copy the page, so the element is always accessed through the current directory. */
+				if (pred(std::as_const(slot_value(get_page(directory(), pos / page_size), pos % page_size))))
+				{
+					erase_at(pos);
+					++result;
+				}
+			}
+			return result;
+		}
+
+		/** Searches for the specified element within the map.
+		 * @param key Key of the element to search for.
+		 * @return Iterator to the specified element, or `end()`. */
+		[[nodiscard]] const_iterator find(const key_type &key) const { return to_iter(find_pos(key, hash(key))); }
+		/** Checks if the specified element is present within the map as if by `find(key) != end()`.
+		 * @param key Key of the element to search for.
+		 * @return `true` if the element is present within the map, `false` otherwise. */
+		[[nodiscard]] bool contains(const key_type &key) const { return find_pos(key, hash(key)) != bucket_count(); }
+
+		/** Returns reference to the specified element.
+		 * @param key Key of the element to search for.
+		 * @return Reference to the specified element.
+		 * @throw std::out_of_range If no such element exists within the map. */
+		[[nodiscard]] const mapped_type &at(const key_type &key) const { return guard_at(find(key))->second; }
+		/** @copydoc at
+		 * @note Copies the page of the element if it is shared with a snapshot. */
+		[[nodiscard]] mapped_type &at(const key_type &key) { return mutable_value(guard_at(find(key)).m_pos).second; }
+
+		/** Returns reference to the specified element. If the element is not present within the map, inserts a default-constructed instance.
+		 * @param key Key of the element to search for.
+		 * @return Reference to the specified element.
+		 * @note Copies the page of the element if it is shared with a snapshot. */
+		[[nodiscard]] mapped_type &operator[](const key_type &key) { return mutable_value(do_try_emplace(key).first).second; }
+		/** @copydoc operator[] */
+		[[nodiscard]] mapped_type &operator[](key_type &&key) { return mutable_value(do_try_emplace(std::move(key)).first).second; }
+
+		/** Reserves space for at least `n` elements. */
+		void reserve(size_type n)
+		{
+			if (n > capacity()) rehash(static_cast<size_type>(std::ceil(static_cast<float>(n) / max_load_factor())));
+		}
+		/** Reserves space for at least `n` buckets and rehashes the map if necessary. All pages of the map are re-allocated.
+		 * @note The new amount of buckets is clamped to be at least `size() / max_load_factor()`. */
+		void rehash(size_type n)
+		{
+			auto cap = page_size;
+			while (cap < n || _detail::capacity_to_max_size(cap) < size()) cap *= 2;
+			do_rehash(cap);
+		}
+
+		/** Returns copy of the hash function used by the map. */
+		[[nodiscard]] hasher hash_function() const { return hash_base::value(); }
+		/** Returns copy of the key comparator used by the map. */
+		[[nodiscard]] key_equal key_eq() const { return cmp_base::value(); }
+		/** Returns copy of the allocator used by the map. */
+		[[nodiscard]] allocator_type get_allocator() const { return alloc_base::value(); }
+
+		void swap(cow_map &other) noexcept(std::is_nothrow_swappable_v<hasher> && std::is_nothrow_swappable_v<key_equal>)
+		{
+			/* Pages are deallocated by whichever map releases them last, so the allocator is always exchanged with the pages. */
+			hash_base::swap(other);
+			cmp_base::swap(other);
+			alloc_base::swap(other);
+
+			using std::swap;
+			swap(m_dir, other.m_dir);
+			swap(m_size, other.m_size);
+			swap(m_num_deleted, other.m_num_deleted);
+		}
+
+	private:
+		[[nodiscard]] std::size_t hash(const key_type &key) const { return hash_base::value()(key); }
+		[[nodiscard]] bool cmp(const key_type &a, const key_type &b) const { return cmp_base::value()(a, b); }
+
+		[[nodiscard]] directory_t *directory() const noexcept { return _detail::to_address(m_dir); }
+		[[nodiscard]] const_iterator to_iter(size_type pos) const noexcept { return {directory(), pos}; }
+
+		[[nodiscard]] const_iterator guard_at(const_iterator iter) const
+		{
+			if (iter == end())
+				throw std::out_of_range("`cow_map::at` - invalid key");
+			else
+				return iter;
+		}
+
+		/* Returns position of the first occupied slot at or after `pos`, or the bucket count. */
+		[[nodiscard]] static size_type next_occupied(const directory_t *dir, size_type pos) noexcept
+		{
+			if (dir == nullptr) return 0;
+			for (const auto cap = dir->num_pages * page_size; pos < cap; ++pos)
+				if (_detail::is_occupied(get_page(dir, pos / page_size)->meta[pos % page_size]))
+					return pos;
+			return pos;
+		}
+
+		/* Probes the table for the slot of `key`, and returns it together with the first available slot of the probe sequence.
+		 * Probe sequence moves between whole blocks, so that every block lies within a single page. */
+		template<bool Insert>
+		[[nodiscard]] std::pair<size_type, size_type> probe(const key_type &key, std::size_t h) const
+		{
+			const auto cap = bucket_count();
+			auto slot = cap;
+			if (cap != 0)
+			{
+				const auto [h1, h2] = _detail::decompose_hash(h);
+				const auto mask = cap / sizeof(meta_block) - 1;
+				for (size_type block = h1 & mask, idx = 0; idx <= mask; block = (block + ++idx) & mask)
+				{
+					const auto pos = block * sizeof(meta_block);
+					auto *page = get_page(directory(), pos / page_size);
+					const auto offset = pos % page_size;
+
+					const auto meta = meta_block{page->meta + offset};
+					for (auto match = meta.match_eq(h2); !match.empty(); ++match)
+						TPP_IF_LIKELY(cmp(slot_value(page, offset + match.lsb_index()).first, key))
+							return {pos + match.lsb_index(), slot};
+
+					if constexpr (Insert)
+						if (slot == cap)
+							if (const auto available = meta.match_available(); !available.empty())
+								slot = pos + available.lsb_index();
+					TPP_IF_UNLIKELY(!meta.match_empty().empty())
+						break;
+				}
+			}
+			return {cap, slot};
+		}
+		[[nodiscard]] size_type find_pos(const key_type &key, std::size_t h) const { return probe<false>(key, h).first; }
+
+		template<typename K, typename... Args>
+		std::pair<size_type, bool> do_try_emplace(K &&key, Args &&...args)
+		{
+			const auto h = hash(key);
+			auto [pos, slot] = probe<true>(key, h);
+			if (pos != bucket_count()) return {pos, false};
+
+			if (const auto cap = _detail::rehash_capacity(bucket_count(), size(), m_num_deleted, page_size); cap != 0)
+			{
+				do_rehash(cap);
+				slot = probe<true>(key, h).second;
+			}
+
+			auto *page = unshare_page(slot / page_size);
+			const auto offset = slot % page_size;
+
+			auto alloc = value_alloc{alloc_base::value()};
+			std::allocator_traits<value_alloc>::construct(alloc, &slot_value(page, offset), std::piecewise_construct,
+			                                              std::forward_as_tuple(std::forward<K>(key)),
+			                                              std::forward_as_tuple(std::forward<Args>(args)...));
+			m_num_deleted -= page->meta[offset] == meta_byte::deleted;
+			page->meta[offset] = _detail::decompose_hash(h).second;
+			++m_size;
+			return {slot, true};
+		}
+		void erase_at(size_type pos)
+		{
+			auto *page = unshare_page(pos / page_size);
+			const auto offset = pos % page_size;
+
+			auto alloc = value_alloc{alloc_base::value()};
+			std::allocator_traits<value_alloc>::destroy(alloc, &slot_value(page, offset));
+
+			/* If the block has empty slots, no probe sequence could have passed through it, thus the slot can be made empty. */
+			const auto block = offset / sizeof(meta_block) * sizeof(meta_block);
+			if (!meta_block{page->meta + block}.match_empty().empty())
+				page->meta[offset] = meta_byte::empty;
+			else
+			{
+				page->meta[offset] = meta_byte::deleted;
+				++m_num_deleted;
+			}
+			--m_size;
+		}
+
+		/* Returns mutable reference to the element at `pos`, copying it's page if it is shared. */
+		[[nodiscard]] value_type &mutable_value(size_type pos) { return slot_value(unshare_page(pos / page_size), pos % page_size); }
+
+		/* Makes the directory exclusively owned by the map, copying it if it is shared. Pages of the copied directory remain shared. */
+		directory_t *unshare_directory()
+		{
+			/* Acquire pairs with the release of other owners, so that their reads of the directory happen before it is modified. */
+			if (auto *dir = directory(); dir->refs.load(std::memory_order_acquire) != 1)
+			{
+				auto copy = make_directory(dir->num_pages);
+				for (size_type i = 0; i < dir->num_pages; ++i)
+				{
+					get_page(dir, i)->refs.fetch_add(1, std::memory_order_relaxed);
+					_detail::to_address(copy)->pages[i] = dir->pages[i];
+				}
+				release_directory(std::exchange(m_dir, copy));
+			}
+			return directory();
+		}
+		/* Makes the page at index `i` exclusively owned by the map, copying it (and the directory) if it is shared. */
+		page_t *unshare_page(size_type i)
+		{
+			auto *dir = unshare_directory();
+			if (auto *page = get_page(dir, i); page->refs.load(std::memory_order_acquire) != 1)
+			{
+				auto copy = make_page();
+				auto *dst = _detail::to_address(copy);
+				try
+				{
+					auto alloc = value_alloc{alloc_base::value()};
+					for (size_type j = 0; j < page_size; ++j)
+						if (_detail::is_occupied(page->meta[j]))
+						{
+							std::allocator_traits<value_alloc>::construct(alloc, &slot_value(dst, j), std::as_const(slot_value(page, j)));
+							dst->meta[j] = page->meta[j];
+						}
+					std::copy_n(page->meta, page_size, dst->meta);
+				}
+				catch (...)
+				{
+					release_page(copy);
+					throw;
+				}
+				release_page(std::exchange(dir->pages[i], copy));
+			}
+			return get_page(dir, i);
+		}
+
+		void do_rehash(size_type cap)
+		{
+			auto dir = make_directory(cap / page_size);
+			try
+			{
+				for (size_type i = 0; i < cap / page_size; ++i)
+					_detail::to_address(dir)->pages[i] = make_page();
+				if (m_dir != nullptr)
+				{
+					/* Elements of pages owned exclusively by the map are moved, as long as it can not fail half-way.
+					 * Elements of shared pages are copied first, so that a failed copy leaves the map unchanged. */
+					const auto can_move = std::is_nothrow_move_constructible_v<value_type> && std::is_nothrow_invocable_v<const hasher &, const key_type &> &&
+					                      m_dir->refs.load(std::memory_order_acquire) == 1;
+					for (const auto move_pass: {false, true})
+						for (size_type i = 0; i < m_dir->num_pages; ++i)
+						{
+							auto *page = get_page(directory(), i);
+							if (move_pass != (can_move && page->refs.load(std::memory_order_acquire) == 1))
+								continue;
+
+							for (size_type j = 0; j < page_size; ++j)
+								if (!_detail::is_occupied(page->meta[j]))
+									continue;
+								else if (move_pass)
+									insert_rehashed(_detail::to_address(dir), std::move(slot_value(page, j)));
+								else
+									insert_rehashed(_detail::to_address(dir), std::as_const(slot_value(page, j)));
+						}
+				}
+			}
+			catch (...)
+			{
+				release_directory(dir);
+				throw;
+			}
+
+			release_directory(std::exchange(m_dir, dir));
+			m_num_deleted = 0;
+		}
+		template<typename V>
+		void insert_rehashed(directory_t *dir, V &&value)
+		{
+			const auto h = hash(value.first);
+			const auto [h1, h2] = _detail::decompose_hash(h);
+			const auto mask = dir->num_pages * page_blocks - 1;
+			for (size_type block = h1 & mask, idx = 0;; block = (block + ++idx) & mask)
+			{
+				const auto pos = block * sizeof(meta_block);
+				auto *page = get_page(dir, pos / page_size);
+				const auto offset = pos % page_size;
+				if (const auto available = meta_block{page->meta + offset}.match_available(); !available.empty())
+				{
+					auto alloc = value_alloc{alloc_base::value()};
+					const auto slot = offset + available.lsb_index();
+					std::allocator_traits<value_alloc>::construct(alloc, &slot_value(page, slot), std::forward<V>(value));
+					page->meta[slot] = h2;
+					return;
+				}
+				TPP_ASSERT(idx <= mask, "Probe must not exceed table capacity");
+			}
+		}
+
+		[[nodiscard]] directory_ptr make_directory(size_type num_pages)
+		{
+			auto d_alloc = directory_alloc{alloc_base::value()};
+			auto p_alloc = page_ptr_alloc{alloc_base::value()};
+
+			auto dir = std::allocator_traits<directory_alloc>::allocate(d_alloc, 1);
+			page_array pages;
+			try { pages = std::allocator_traits<page_ptr_alloc>::allocate(p_alloc, num_pages); }
+			catch (...)
+			{
+				std::allocator_traits<directory_alloc>::deallocate(d_alloc, dir, 1);
+				throw;
+			}
+			for (size_type i = 0; i < num_pages; ++i)
+				std::allocator_traits<page_ptr_alloc>::construct(p_alloc, _detail::to_address(pages + i), nullptr);
+			std::allocator_traits<directory_alloc>::construct(d_alloc, _detail::to_address(dir), num_pages, pages);
+			return dir;
+		}
+		void release_directory(directory_ptr dir)
+		{
+			/* Release pairs with the acquire of the last owner, so that reads of other owners happen before the directory is destroyed. */
+			if (dir == nullptr || _detail::to_address(dir)->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+
+			auto d_alloc = directory_alloc{alloc_base::value()};
+			auto p_alloc = page_ptr_alloc{alloc_base::value()};
+			auto *ptr = _detail::to_address(dir);
+			for (size_type i = 0; i < ptr->num_pages; ++i)
+			{
+				if (ptr->pages[i] != nullptr) release_page(ptr->pages[i]);
+				std::allocator_traits<page_ptr_alloc>::destroy(p_alloc, _detail::to_address(ptr->pages + i));
+			}
+			std::allocator_traits<page_ptr_alloc>::deallocate(p_alloc, ptr->pages, ptr->num_pages);
+			std::allocator_traits<directory_alloc>::destroy(d_alloc, ptr);
+			std::allocator_traits<directory_alloc>::deallocate(d_alloc, dir, 1);
+		}
+
+		[[nodiscard]] page_ptr make_page()
+		{
+			auto alloc = page_alloc{alloc_base::value()};
+			auto page = std::allocator_traits<page_alloc>::allocate(alloc, 1);
+			std::allocator_traits<page_alloc>::construct(alloc, _detail::to_address(page));
+			return page;
+		}
+		void release_page(page_ptr page)
+		{
+			auto *ptr = _detail::to_address(page);
+			if (ptr->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+
+			auto p_alloc = page_alloc{alloc_base::value()};
+			auto v_alloc = value_alloc{alloc_base::value()};
+			for (size_type i = 0; i < page_size; ++i)
+				if (_detail::is_occupied(ptr->meta[i]))
+					std::allocator_traits<value_alloc>::destroy(v_alloc, &slot_value(ptr, i));
+			std::allocator_traits<page_alloc>::destroy(p_alloc, ptr);
+			std::allocator_traits<page_alloc>::deallocate(p_alloc, page, 1);
+		}
+
+		directory_ptr m_dir = nullptr;
+		size_type m_size = 0;
+		size_type m_num_deleted = 0; /* Amount of deleted entries that are not yet reclaimed by rehashing. */
+	};
+
+	template<typename K, typename M, typename H, typename C, typename A>
+	inline void swap(cow_map<K, M, H, C, A> &a, cow_map<K, M, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+	/** Erases all elements from the map \p map that satisfy the predicate \p pred.
+	 * @return Amount of elements erased. */
+	template<typename K, typename M, typename H, typename C, typename A, typename P>
+	inline typename cow_map<K, M, H, C, A>::size_type erase_if(cow_map<K, M, H, C, A> &map, P pred)
+	{
+		return map.erase_if(pred);
+	}
+}
@@ -23,6 +23,8 @@ namespace tpp
 	 * @tparam Key Key type stored by the map.
 	 * @tparam Mapped Mapped type associated with map keys.
 	 * @tparam KeyHash Hash functor used by the map.
+	 * Bucket policy of the map can be selected via a `bucket_policy` member type of the functor (`tpp::pow2_bucket_policy` by default).
+	 * Width of bucket indices can be narrowed via an `index_type` member type of the functor (ex. `std::uint32_t` for tables with less than 4G elements).
 	 * @tparam KeyCmp Compare functor used by the map.
 	 * @tparam Alloc Allocator used by the map. */
 	template<typename Key, typename Mapped, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<Key, Mapped>>>
@@ -172,6 +174,14 @@ namespace tpp
 		/** @copydoc end */
 		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
 
+		/** Splits the map into at most `n` disjoint sub-ranges that together cover all of it's elements.
+		 * Sub-ranges are contiguous ranges of the dense element buffer of (nearly) equal size.
+		 * Sub-ranges are intended to be processed in parallel (see `tpp::parallel_for_each`).
+		 * @note Sub-ranges are invalidated together with iterators of the map. */
+		[[nodiscard]] std::vector<iterator_range<iterator>> split(size_type n) { return m_table.split(n); }
+		/** @copydoc split */
+		[[nodiscard]] std::vector<iterator_range<const_iterator>> split(size_type n) const { return m_table.split(n); }
+
 		/** Returns reverse iterator to the last element of the map.
 		 * @note Elements are stored in no particular order. */
 		[[nodiscard]] reverse_iterator rbegin() noexcept { return m_table.rbegin(); }
@@ -187,6 +197,15 @@ namespace tpp
 		/** @copydoc rend */
 		[[nodiscard]] const_reverse_iterator crend() const noexcept { return rend(); }
 
+		/** Returns a strided view of keys of the map, in the same order as the map's elements.
+		 * @note The view is invalidated by any operation that invalidates references to elements of the map. */
+		[[nodiscard]] strided_view<const key_type> keys() const noexcept { return m_table.view([](auto &node) -> auto & { return node.template key<0>(); }); }
+		/** Returns a strided view of mapped values of the map, in the same order as the map's elements.
+		 * @note The view is invalidated by any operation that invalidates references to elements of the map. */
+		[[nodiscard]] strided_view<mapped_type> values() noexcept { return m_table.view([](auto &node) -> auto & { return node.mapped(); }); }
+		/** @copydoc values */
+		[[nodiscard]] strided_view<const mapped_type> values() const noexcept { return m_table.view([](auto &node) -> auto & { return node.mapped(); }); }
+
 		/** Returns the total number of elements within the map. */
 		[[nodiscard]] constexpr size_type size() const noexcept { return m_table.size(); }
 		/** Checks if the map is empty (`size() == 0`). */
@@ -501,6 +520,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the to-be removed range.
 		 * @return Iterator to the element following the erased range, or `end()`. */
 		iterator erase(const_iterator first, const_iterator last) { return m_table.erase(first, last); }
+		/** @brief Erases all elements of the map that satisfy the predicate \p pred.
+		 *
+		 * Remaining elements are compacted in a single pass, after which the bucket index is rebuilt once.
+		 * Unlike erasing elements one-by-one, relative order of the remaining elements within the map is preserved.
+		 * @return Amount of elements erased.
+		 * @note Invalidates all iterators and references if any element was erased. */
+		template<typename P>
+		size_type erase_if(P pred) { return m_table.erase_if(pred); }
 
 		/** Searches for the specified element within the map.
 		 * @param key Key of the element to search for.
@@ -540,6 +567,24 @@ namespace tpp
 		template<typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
 		[[nodiscard]] const mapped_type &at(const K &key) const { return guard_at(find(key))->second; }
 
+		/** @brief Prehashed overloads of `find`, `contains`, `erase` & `try_emplace`.
+		 *
+		 * These overloads accept a precomputed hash of the key and skip hashing the key internally, allowing the hash to be
+		 * shared with external routing logic (ex. `sharded_map`). The behavior is undefined unless `hash == hash_function()(key)`. */
+		[[nodiscard]] iterator find_hashed(const key_type &key, size_type hash) { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] const_iterator find_hashed(const key_type &key, size_type hash) const { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] bool contains_hashed(const key_type &key, size_type hash) const { return m_table.contains_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		iterator erase_hashed(const key_type &key, size_type hash) { return m_table.erase_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace_hashed(const key_type &key, size_type hash, Args &&...args)
+		{
+			return m_table.try_emplace_hashed(std::forward_as_tuple(key), hash, std::forward<Args>(args)...);
+		}
+
 		/** Returns reference to the specified element. If the element is not present within the map, inserts a default-constructed instance.
 		 * @param key Key of the element to search for.
 		 * @return Reference to the specified element. */
@@ -591,6 +636,19 @@ namespace tpp
 		/** Sets the current maximum load factor. */
 		constexpr void max_load_factor(float f) noexcept { m_table.max_load_factor(f); }
 
+		/** Writes a binary snapshot of the map to output stream `os`. Snapshot contains the raw dense element array and,
+		 * if `with_index` is set, the bucket index of the map. Otherwise, the index is re-built when the snapshot is loaded.
+		 * @note Only available if the key & mapped types are trivially copyable.
+		 * @note Snapshots use native byte order & layout, and are only compatible with maps of the same type and hash function.
+		 * @throw snapshot_error If the snapshot could not be written. */
+		template<typename S>
+		void save(S &os, bool with_index = true) const { m_table.save(os, with_index); }
+		/** Replaces contents of the map with a snapshot read from input stream `is`. If the snapshot is not compatible
+		 * with the map or is corrupted, the map is left unchanged.
+		 * @throw snapshot_error If the snapshot could not be read or validated. */
+		template<typename S>
+		void load(S &is) { m_table.load(is); }
+
 		[[nodiscard]] allocator_type get_allocator() const { return allocator_type{m_table.get_allocator()}; }
 		[[nodiscard]] hasher hash_function() const { return m_table.get_hash(); }
 		[[nodiscard]] key_equal key_eq() const { return m_table.get_cmp(); }
@@ -622,25 +680,14 @@ namespace tpp
 	};
 
 	template<typename K, typename M, typename H, typename C, typename A>
-	inline void swap(dense_map<K, M, H, C, A> &a, dense_map<K, M, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<dense_map<K, H, C, A>>) { a.swap(b); }
+	inline void swap(dense_map<K, M, H, C, A> &a, dense_map<K, M, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the map \p map that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
 	template<typename K, typename M, typename H, typename C, typename A, typename P>
 	inline typename dense_map<K, M, H, C, A>::size_type erase_if(dense_map<K, M, H, C, A> &map, P pred)
 	{
-		typename dense_map<K, M, H, C, A>::size_type result = 0;
-		for (auto i = map.cbegin(), last = map.cend(); i != last;)
-		{
-			if (pred(*i))
-			{
-				i = map.erase(i);
-				++result;
-			}
-			else
-				++i;
-		}
-		return result;
+		return map.erase_if(pred);
 	}
 
 	template<typename I, typename Key = _detail::iter_key_t<I>, typename Mapped = _detail::iter_mapped_t<I>, typename Hash = std::hash<Key>, typename Cmp = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<Key, Mapped>>>
@@ -676,6 +723,8 @@ namespace tpp
 	 * @tparam Key Key type stored by the map.
 	 * @tparam Mapped Mapped type associated with map keys.
 	 * @tparam KeyHash Hash functor used by the map.
+	 * Bucket policy of the map can be selected via a `bucket_policy` member type of the functor (`tpp::pow2_bucket_policy` by default).
+	 * Width of bucket indices can be narrowed via an `index_type` member type of the functor (ex. `std::uint32_t` for tables with less than 4G elements).
 	 * @tparam KeyCmp Compare functor used by the map.
 	 * @tparam Alloc Allocator used by the map. */
 	template<typename Key, typename Mapped, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<Key, Mapped>>>
@@ -828,6 +877,17 @@ namespace tpp
 		/** @copydoc rend */
 		[[nodiscard]] const_reverse_iterator crend() const noexcept { return rend(); }
 
+		/** Returns a strided view of keys of the map, in order of the internal element buffer.
+		 * @note Buffer order matches insertion order only after `compact()`.
+		 * @note The view is invalidated by any operation that invalidates references to elements of the map. */
+		[[nodiscard]] strided_view<const key_type> keys() const noexcept { return m_table.view([](auto &node) -> auto & { return node.template key<0>(); }); }
+		/** Returns a strided view of mapped values of the map, in order of the internal element buffer.
+		 * @note Buffer order matches insertion order only after `compact()`.
+		 * @note The view is invalidated by any operation that invalidates references to elements of the map. */
+		[[nodiscard]] strided_view<mapped_type> values() noexcept { return m_table.view([](auto &node) -> auto & { return node.mapped(); }); }
+		/** @copydoc values */
+		[[nodiscard]] strided_view<const mapped_type> values() const noexcept { return m_table.view([](auto &node) -> auto & { return node.mapped(); }); }
+
 		/** Returns reference to the first element of the map. */
 		[[nodiscard]] reference front() noexcept { return m_table.front(); }
 		/** @copydoc front */
@@ -1151,6 +1211,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the to-be removed range.
 		 * @return Iterator to the element following the erased range, or `end()`. */
 		iterator erase(const_iterator first, const_iterator last) { return m_table.erase(first, last); }
+		/** @brief Erases all elements of the map that satisfy the predicate \p pred.
+		 *
+		 * Remaining elements are compacted in a single pass, after which the bucket index is rebuilt once.
+		 * Unlike erasing elements one-by-one, relative order of the remaining elements within the map is preserved.
+		 * @return Amount of elements erased.
+		 * @note Invalidates all iterators and references if any element was erased. */
+		template<typename P>
+		size_type erase_if(P pred) { return m_table.erase_if(pred); }
 
 		/** Searches for the specified element within the map.
 		 * @param key Key of the element to search for.
@@ -1190,6 +1258,24 @@ namespace tpp
 		template<typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
 		[[nodiscard]] const mapped_type &at(const K &key) const { return guard_at(find(key))->second; }
 
+		/** @brief Prehashed overloads of `find`, `contains`, `erase` & `try_emplace`.
+		 *
+		 * These overloads accept a precomputed hash of the key and skip hashing the key internally, allowing the hash to be
+		 * shared with external routing logic (ex. `sharded_map`). The behavior is undefined unless `hash == hash_function()(key)`. */
+		[[nodiscard]] iterator find_hashed(const key_type &key, size_type hash) { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] const_iterator find_hashed(const key_type &key, size_type hash) const { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] bool contains_hashed(const key_type &key, size_type hash) const { return m_table.contains_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		iterator erase_hashed(const key_type &key, size_type hash) { return m_table.erase_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace_hashed(const key_type &key, size_type hash, Args &&...args)
+		{
+			return m_table.try_emplace_hashed(std::forward_as_tuple(key), hash, std::forward<Args>(args)...);
+		}
+
 		/** Returns reference to the specified element. If the element is not present within the map, inserts a default-constructed instance.
 		 * @param key Key of the element to search for.
 		 * @return Reference to the specified element. */
@@ -1236,6 +1322,10 @@ namespace tpp
 		/** Reserves space for at least `n` buckets and rehashes the map if necessary.
 		 * @note The new amount of buckets is clamped to be at least `size() / max_load_factor()`. */
 		void rehash(size_type n) { m_table.rehash(n); }
+		/** Rewrites the internal element buffer so that physical order of the elements matches insertion order.
+		 * After compaction, iteration over the map is a sequential scan of the element buffer.
+		 * @note Invalidates all iterators and references. */
+		void compact() { m_table.compact(); }
 		/** Returns the current maximum load factor. */
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return m_table.max_load_factor(); }
 		/** Sets the current maximum load factor. */
@@ -1272,25 +1362,14 @@ namespace tpp
 	};
 
 	template<typename K, typename M, typename H, typename C, typename A>
-	inline void swap(ordered_dense_map<K, M, H, C, A> &a, ordered_dense_map<K, M, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<ordered_dense_map<K, M, H, C, A>>) { a.swap(b); }
+	inline void swap(ordered_dense_map<K, M, H, C, A> &a, ordered_dense_map<K, M, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the map \p map that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
 	template<typename K, typename M, typename H, typename C, typename A, typename P>
 	inline typename ordered_dense_map<K, M, H, C, A>::size_type erase_if(ordered_dense_map<K, M, H, C, A> &map, P pred)
 	{
-		typename dense_map<K, M, H, C, A>::size_type result = 0;
-		for (auto i = map.cbegin(), last = map.cend(); i != last;)
-		{
-			if (pred(*i))
-			{
-				i = map.erase(i);
-				++result;
-			}
-			else
-				++i;
-		}
-		return result;
+		return map.erase_if(pred);
 	}
 
 	template<typename I, typename Key = _detail::iter_key_t<I>, typename Mapped = _detail::iter_mapped_t<I>, typename Hash = std::hash<Key>, typename Cmp = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<Key, Mapped>>>
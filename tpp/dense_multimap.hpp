@@ -26,15 +26,18 @@ namespace tpp
 	 * is returned instead.
 	 *
 	 * @tparam Keys Key types of the multimap.
+	 * Secondary keys can be wrapped in `tpp::lazy_key` to defer construction of their index until the first non-const lookup by that key.
 	 * @tparam Mapped Mapped type associated with multimap keys.
 	 * @tparam KeyHash Hash functor used by the multimap. The functor must be invocable for all key types.
+	 * Bucket policy of the multimap can be selected via a `bucket_policy` member type of the functor (`tpp::pow2_bucket_policy` by default).
+	 * Width of bucket indices can be narrowed via an `index_type` member type of the functor (ex. `std::uint32_t` for tables with less than 4G elements).
 	 * @tparam KeyCmp Compare functor used by the multimap. The functor must be invocable for all key types.
 	 * @tparam Alloc Allocator used by the multimap. */
 	template<typename... Keys, typename Mapped, typename KeyHash, typename KeyCmp, typename Alloc>
 	class dense_multimap<multikey<Keys...>, Mapped, KeyHash, KeyCmp, Alloc>
 	{
 	public:
-		using key_type = std::tuple<Keys...>;
+		using key_type = std::tuple<_detail::unwrap_key_t<Keys>...>;
 		using mapped_type = Mapped;
 		using insert_type = std::pair<key_type, mapped_type>;
 		using value_type = std::pair<const key_type, mapped_type>;
@@ -58,6 +61,7 @@ namespace tpp
 			static constexpr auto &get_mapped(T &value) noexcept { return value.second; }
 
 			static constexpr std::size_t key_size = std::tuple_size_v<key_type>;
+			static constexpr std::size_t lazy_mask = _detail::lazy_mask_v<Keys...>;
 		};
 
 		using table_t = _detail::dense_table<insert_type, value_type, key_type, KeyHash, KeyCmp, Alloc, traits_t>;
@@ -340,6 +344,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the to-be removed range.
 		 * @return Iterator to the element following the erased range, or `end()`. */
 		iterator erase(const_iterator first, const_iterator last) { return m_table.erase(first, last); }
+		/** @brief Erases all elements of the multimap that satisfy the predicate \p pred.
+		 *
+		 * Remaining elements are compacted in a single pass, after which the bucket index is rebuilt once.
+		 * Unlike erasing elements one-by-one, relative order of the remaining elements within the multimap is preserved.
+		 * @return Amount of elements erased.
+		 * @note Invalidates all iterators and references if any element was erased. */
+		template<typename P>
+		size_type erase_if(P pred) { return m_table.erase_if(pred); }
 
 		/** Searches for the specified element within the multimap.
 		 * @tparam I Index of the key.
@@ -363,10 +375,16 @@ namespace tpp
 		 * @param key `I`th key of the element to search for.
 		 * @return `true` if the element is present within the multimap, `false` otherwise. */
 		template<std::size_t I>
+		[[nodiscard]] bool contains(const std::tuple_element_t<I, key_type> &key) { return m_table.template contains<I>(key); }
+		/** @copydoc contains */
+		template<std::size_t I>
 		[[nodiscard]] bool contains(const std::tuple_element_t<I, key_type> &key) const { return m_table.template contains<I>(key); }
 		/** @copydoc contains
 		 * @note This overload is available only if the hash & compare functors are transparent. */
 		template<std::size_t I, typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
+		[[nodiscard]] bool contains(const K &key) { return m_table.template contains<I>(key); }
+		/** @copydoc contains */
+		template<std::size_t I, typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
 		[[nodiscard]] bool contains(const K &key) const { return m_table.template contains<I>(key); }
 
 		/** Returns reference to the specified element.
@@ -425,6 +443,19 @@ namespace tpp
 		/** Sets the current maximum load factor. */
 		constexpr void max_load_factor(float f) noexcept { m_table.max_load_factor(f); }
 
+		/** Writes a binary snapshot of the map to output stream `os`. Snapshot contains the raw dense element array and,
+		 * if `with_index` is set, the bucket indices of the map. Otherwise, the indices is re-built when the snapshot is loaded.
+		 * @note Only available if the key & mapped types are trivially copyable.
+		 * @note Snapshots use native byte order & layout, and are only compatible with maps of the same type and hash function.
+		 * @throw snapshot_error If the snapshot could not be written. */
+		template<typename S>
+		void save(S &os, bool with_index = true) const { m_table.save(os, with_index); }
+		/** Replaces contents of the map with a snapshot read from input stream `is`. If the snapshot is not compatible
+		 * with the map or is corrupted, the map is left unchanged.
+		 * @throw snapshot_error If the snapshot could not be read or validated. */
+		template<typename S>
+		void load(S &is) { m_table.load(is); }
+
 		[[nodiscard]] allocator_type get_allocator() const { return allocator_type{m_table.get_allocator()}; }
 		[[nodiscard]] hasher hash_function() const { return m_table.get_hash(); }
 		[[nodiscard]] key_equal key_eq() const { return m_table.get_cmp(); }
@@ -456,24 +487,13 @@ namespace tpp
 	};
 
 	template<typename Mk, typename M, typename H, typename C, typename A>
-	inline void swap(dense_multimap<Mk, M, H, C, A> &a, dense_multimap<Mk, M, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<dense_multimap<Mk, H, C, A>>) { a.swap(b); }
+	inline void swap(dense_multimap<Mk, M, H, C, A> &a, dense_multimap<Mk, M, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the map \p map that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
 	template<typename Mk, typename M, typename H, typename C, typename A, typename P>
 	inline typename dense_multimap<Mk, M, H, C, A>::size_type erase_if(dense_multimap<Mk, M, H, C, A> &map, P pred)
 	{
-		typename dense_multimap<Mk, M, H, C, A>::size_type result = 0;
-		for (auto i = map.cbegin(), last = map.cend(); i != last;)
-		{
-			if (pred(*i))
-			{
-				i = map.erase(i);
-				++result;
-			}
-			else
-				++i;
-		}
-		return result;
+		return map.erase_if(pred);
 	}
 }
\ No newline at end of file
@@ -19,14 +19,17 @@ namespace tpp
 	 * dense multiset may invalidate references to it's elements due to the internal element vector being reordered.
 	 *
 	 * @tparam Keys Key types of the multiset.
+	 * Secondary keys can be wrapped in `tpp::lazy_key` to defer construction of their index until the first non-const lookup by that key.
 	 * @tparam KeyHash Hash functor used by the multiset. The functor must be invocable for both all types.
+	 * Bucket policy of the multiset can be selected via a `bucket_policy` member type of the functor (`tpp::pow2_bucket_policy` by default).
+	 * Width of bucket indices can be narrowed via an `index_type` member type of the functor (ex. `std::uint32_t` for tables with less than 4G elements).
 	 * @tparam KeyCmp Compare functor used by the multiset. The functor must be invocable for both all types.
 	 * @tparam Alloc Allocator used by the multiset. */
 	template<typename... Keys, typename KeyHash, typename KeyCmp, typename Alloc>
 	class dense_multiset<multikey<Keys...>, KeyHash, KeyCmp, Alloc>
 	{
 	public:
-		using key_type = std::tuple<Keys...>;
+		using key_type = std::tuple<_detail::unwrap_key_t<Keys>...>;
 
 	private:
 		struct traits_t
@@ -44,6 +47,7 @@ namespace tpp
 			static constexpr auto &get_key(T &value) noexcept { return value; }
 
 			static constexpr std::size_t key_size = std::tuple_size_v<key_type>;
+			static constexpr std::size_t lazy_mask = _detail::lazy_mask_v<Keys...>;
 		};
 
 		using table_t = _detail::dense_table<key_type, key_type, key_type, KeyHash, KeyCmp, Alloc, traits_t>;
@@ -252,26 +256,46 @@ namespace tpp
 		 * @param last Iterator one past the last element of the to-be removed range.
 		 * @return Iterator to the element following the erased range, or `end()`. */
 		iterator erase(const_iterator first, const_iterator last) { return m_table.erase(first, last); }
+		/** @brief Erases all elements of the multiset that satisfy the predicate \p pred.
+		 *
+		 * Remaining elements are compacted in a single pass, after which the bucket index is rebuilt once.
+		 * Unlike erasing elements one-by-one, relative order of the remaining elements within the multiset is preserved.
+		 * @return Amount of elements erased.
+		 * @note Invalidates all iterators and references if any element was erased. */
+		template<typename P>
+		size_type erase_if(P pred) { return m_table.erase_if(pred); }
 
 		/** Searches for the specified element within the multiset.
 		 * @tparam I Index of the key.
 		 * @param key `I`th key of the element to search for.
 		 * @return Iterator to the specified element, or `end()`. */
 		template<std::size_t I>
+		[[nodiscard]] iterator find(const std::tuple_element_t<I, key_type> &key) { return m_table.template find<I>(key); }
+		/** @copydoc find */
+		template<std::size_t I>
 		[[nodiscard]] iterator find(const std::tuple_element_t<I, key_type> &key) const { return m_table.template find<I>(key); }
 		/** @copydoc find
 		 * @note This overload is available only if the hash & compare functors are transparent. */
 		template<std::size_t I, typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
+		[[nodiscard]] iterator find(const K &key) { return m_table.template find<I>(key); }
+		/** @copydoc find */
+		template<std::size_t I, typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
 		[[nodiscard]] iterator find(const K &key) const { return m_table.template find<I>(key); }
 		/** Checks if the specified element is present within the multiset as if by `find(key) != end()`.
 		 * @tparam I Index of the key.
 		 * @param key `I`th key of the element to search for.
 		 * @return `true` if the element is present within the multiset, `false` otherwise. */
 		template<std::size_t I>
+		[[nodiscard]] bool contains(const std::tuple_element_t<I, key_type> &key) { return m_table.template contains<I>(key); }
+		/** @copydoc contains */
+		template<std::size_t I>
 		[[nodiscard]] bool contains(const std::tuple_element_t<I, key_type> &key) const { return m_table.template contains<I>(key); }
 		/** @copydoc contains
 		 * @note This overload is available only if the hash & compare functors are transparent. */
 		template<std::size_t I, typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
+		[[nodiscard]] bool contains(const K &key) { return m_table.template contains<I>(key); }
+		/** @copydoc contains */
+		template<std::size_t I, typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
 		[[nodiscard]] bool contains(const K &key) const { return m_table.template contains<I>(key); }
 
 		/** Returns forward iterator to the first element of the specified bucket. */
@@ -308,6 +332,19 @@ namespace tpp
 		/** Sets the current maximum load factor. */
 		constexpr void max_load_factor(float f) noexcept { m_table.max_load_factor(f); }
 
+		/** Writes a binary snapshot of the set to output stream `os`. Snapshot contains the raw dense element array and,
+		 * if `with_index` is set, the bucket indices of the set. Otherwise, the indices is re-built when the snapshot is loaded.
+		 * @note Only available if the value type are trivially copyable.
+		 * @note Snapshots use native byte order & layout, and are only compatible with sets of the same type and hash function.
+		 * @throw snapshot_error If the snapshot could not be written. */
+		template<typename S>
+		void save(S &os, bool with_index = true) const { m_table.save(os, with_index); }
+		/** Replaces contents of the set with a snapshot read from input stream `is`. If the snapshot is not compatible
+		 * with the set or is corrupted, the set is left unchanged.
+		 * @throw snapshot_error If the snapshot could not be read or validated. */
+		template<typename S>
+		void load(S &is) { m_table.load(is); }
+
 		[[nodiscard]] allocator_type get_allocator() const { return allocator_type{m_table.get_allocator()}; }
 		[[nodiscard]] hasher hash_function() const { return m_table.get_hash(); }
 		[[nodiscard]] key_equal key_eq() const { return m_table.get_cmp(); }
@@ -330,24 +367,13 @@ namespace tpp
 	};
 
 	template<typename Mk, typename H, typename C, typename A>
-	inline void swap(dense_multiset<Mk, H, C, A> &a, dense_multiset<Mk, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<dense_multiset<Mk, H, C, A>>) { a.swap(b); }
+	inline void swap(dense_multiset<Mk, H, C, A> &a, dense_multiset<Mk, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the set \p set that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
 	template<typename Mk, typename H, typename C, typename A, typename P>
 	inline typename dense_multiset<Mk, H, C, A>::size_type erase_if(dense_multiset<Mk, H, C, A> &set, P pred)
 	{
-		typename dense_multiset<Mk, H, C, A>::size_type result = 0;
-		for (auto i = set.cbegin(), last = set.cend(); i != last;)
-		{
-			if (pred(*i))
-			{
-				i = set.erase(i);
-				++result;
-			}
-			else
-				++i;
-		}
-		return result;
+		return set.erase_if(pred);
 	}
 }
\ No newline at end of file
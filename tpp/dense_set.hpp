@@ -16,6 +16,8 @@ namespace tpp
 	 *
 	 * @tparam Key Key type stored by the set.
 	 * @tparam KeyHash Hash functor used by the set.
+	 * Bucket policy of the set can be selected via a `bucket_policy` member type of the functor (`tpp::pow2_bucket_policy` by default).
+	 * Width of bucket indices can be narrowed via an `index_type` member type of the functor (ex. `std::uint32_t` for tables with less than 4G elements).
 	 * @tparam KeyCmp Compare functor used by the set.
 	 * @tparam Alloc Allocator used by the set. */
 	template<typename Key, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<Key>>
@@ -163,6 +165,12 @@ namespace tpp
 		/** @copydoc end */
 		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
 
+		/** Splits the set into at most `n` disjoint sub-ranges that together cover all of it's elements.
+		 * Sub-ranges are contiguous ranges of the dense element buffer of (nearly) equal size.
+		 * Sub-ranges are intended to be processed in parallel (see `tpp::parallel_for_each`).
+		 * @note Sub-ranges are invalidated together with iterators of the set. */
+		[[nodiscard]] std::vector<iterator_range<const_iterator>> split(size_type n) const { return m_table.split(n); }
+
 		/** Returns reverse iterator to the last element of the set.
 		 * @note Elements are stored in no particular order. */
 		[[nodiscard]] const_reverse_iterator rbegin() const noexcept { return m_table.rbegin(); }
@@ -174,6 +182,10 @@ namespace tpp
 		/** @copydoc rend */
 		[[nodiscard]] const_reverse_iterator crend() const noexcept { return rend(); }
 
+		/** Returns a strided view of elements of the set, in the same order as iteration over the set.
+		 * @note The view is invalidated by any operation that invalidates references to elements of the set. */
+		[[nodiscard]] strided_view<const value_type> keys() const noexcept { return m_table.view([](auto &node) -> auto & { return node.template key<0>(); }); }
+
 		/** Returns the total number of elements within the set. */
 		[[nodiscard]] constexpr size_type size() const noexcept { return m_table.size(); }
 		/** Checks if the set is empty (`size() == 0`). */
@@ -258,6 +270,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the to-be removed range.
 		 * @return Iterator to the element following the erased range, or `end()`. */
 		iterator erase(const_iterator first, const_iterator last) { return m_table.erase(first, last); }
+		/** @brief Erases all elements of the set that satisfy the predicate \p pred.
+		 *
+		 * Remaining elements are compacted in a single pass, after which the bucket index is rebuilt once.
+		 * Unlike erasing elements one-by-one, relative order of the remaining elements within the set is preserved.
+		 * @return Amount of elements erased.
+		 * @note Invalidates all iterators and references if any element was erased. */
+		template<typename P>
+		size_type erase_if(P pred) { return m_table.erase_if(pred); }
 
 		/** Searches for the specified element within the set.
 		 * @param key Key of the element to search for.
@@ -309,6 +329,19 @@ namespace tpp
 		/** Sets the current maximum load factor. */
 		constexpr void max_load_factor(float f) noexcept { m_table.max_load_factor(f); }
 
+		/** Writes a binary snapshot of the set to output stream `os`. Snapshot contains the raw dense element array and,
+		 * if `with_index` is set, the bucket index of the set. Otherwise, the index is re-built when the snapshot is loaded.
+		 * @note Only available if the value type are trivially copyable.
+		 * @note Snapshots use native byte order & layout, and are only compatible with sets of the same type and hash function.
+		 * @throw snapshot_error If the snapshot could not be written. */
+		template<typename S>
+		void save(S &os, bool with_index = true) const { m_table.save(os, with_index); }
+		/** Replaces contents of the set with a snapshot read from input stream `is`. If the snapshot is not compatible
+		 * with the set or is corrupted, the set is left unchanged.
+		 * @throw snapshot_error If the snapshot could not be read or validated. */
+		template<typename S>
+		void load(S &is) { m_table.load(is); }
+
 		[[nodiscard]] allocator_type get_allocator() const { return allocator_type{m_table.get_allocator()}; }
 		[[nodiscard]] hasher hash_function() const { return m_table.get_hash(); }
 		[[nodiscard]] key_equal key_eq() const { return m_table.get_cmp(); }
@@ -331,25 +364,14 @@ namespace tpp
 	};
 
 	template<typename K, typename H, typename C, typename A>
-	inline void swap(dense_set<K, H, C, A> &a, dense_set<K, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<dense_set<K, H, C, A>>) { a.swap(b); }
+	inline void swap(dense_set<K, H, C, A> &a, dense_set<K, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the set \p set that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
 	template<typename K, typename H, typename C, typename A, typename P>
 	inline typename dense_set<K, H, C, A>::size_type erase_if(dense_set<K, H, C, A> &set, P pred)
 	{
-		typename dense_set<K, H, C, A>::size_type result = 0;
-		for (auto i = set.cbegin(), last = set.cend(); i != last;)
-		{
-			if (pred(*i))
-			{
-				i = set.erase(i);
-				++result;
-			}
-			else
-				++i;
-		}
-		return result;
+		return set.erase_if(pred);
 	}
 
 	template<typename I, typename Key = _detail::iter_key_t<I>, typename Hash = std::hash<Key>, typename Cmp = std::equal_to<Key>, typename Alloc = std::allocator<Key>>
@@ -378,6 +400,8 @@ namespace tpp
 	 *
 	 * @tparam Key Key type stored by the set.
 	 * @tparam KeyHash Hash functor used by the set.
+	 * Bucket policy of the set can be selected via a `bucket_policy` member type of the functor (`tpp::pow2_bucket_policy` by default).
+	 * Width of bucket indices can be narrowed via an `index_type` member type of the functor (ex. `std::uint32_t` for tables with less than 4G elements).
 	 * @tparam KeyCmp Compare functor used by the set.
 	 * @tparam Alloc Allocator used by the set. */
 	template<typename Key, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<Key>>
@@ -532,6 +556,11 @@ namespace tpp
 		/** @copydoc rend */
 		[[nodiscard]] const_reverse_iterator crend() const noexcept { return rend(); }
 
+		/** Returns a strided view of elements of the set, in order of the internal element buffer.
+		 * @note Buffer order matches insertion order only after `compact()`.
+		 * @note The view is invalidated by any operation that invalidates references to elements of the set. */
+		[[nodiscard]] strided_view<const value_type> keys() const noexcept { return m_table.view([](auto &node) -> auto & { return node.template key<0>(); }); }
+
 		/** Returns reference to the first element of the set. */
 		[[nodiscard]] const_reference front() const noexcept { return m_table.front(); }
 		/** Returns reference to the last element of the set. */
@@ -619,6 +648,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the to-be removed range.
 		 * @return Iterator to the element following the erased range, or `end()`. */
 		iterator erase(const_iterator first, const_iterator last) { return m_table.erase(first, last); }
+		/** @brief Erases all elements of the set that satisfy the predicate \p pred.
+		 *
+		 * Remaining elements are compacted in a single pass, after which the bucket index is rebuilt once.
+		 * Unlike erasing elements one-by-one, relative order of the remaining elements within the set is preserved.
+		 * @return Amount of elements erased.
+		 * @note Invalidates all iterators and references if any element was erased. */
+		template<typename P>
+		size_type erase_if(P pred) { return m_table.erase_if(pred); }
 
 		/** Searches for the specified element within the set.
 		 * @param key Key of the element to search for.
@@ -665,6 +702,10 @@ namespace tpp
 		/** Reserves space for at least `n` buckets and rehashes the set if necessary.
 		 * @note The new amount of buckets is clamped to be at least `size() / max_load_factor()`. */
 		void rehash(size_type n) { m_table.rehash(n); }
+		/** Rewrites the internal element buffer so that physical order of the elements matches insertion order.
+		 * After compaction, iteration over the set is a sequential scan of the element buffer.
+		 * @note Invalidates all iterators and references. */
+		void compact() { m_table.compact(); }
 		/** Returns the current maximum load factor. */
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return m_table.max_load_factor(); }
 		/** Sets the current maximum load factor. */
@@ -692,25 +733,14 @@ namespace tpp
 	};
 
 	template<typename K, typename H, typename C, typename A>
-	inline void swap(ordered_dense_set<K, H, C, A> &a, ordered_dense_set<K, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<ordered_dense_set<K, H, C, A>>) { a.swap(b); }
+	inline void swap(ordered_dense_set<K, H, C, A> &a, ordered_dense_set<K, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the set \p set that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
 	template<typename K, typename H, typename C, typename A, typename P>
 	inline typename ordered_dense_set<K, H, C, A>::size_type erase_if(ordered_dense_set<K, H, C, A> &set, P pred)
 	{
-		typename dense_set<K, H, C, A>::size_type result = 0;
-		for (auto i = set.cbegin(), last = set.cend(); i != last;)
-		{
-			if (pred(*i))
-			{
-				i = set.erase(i);
-				++result;
-			}
-			else
-				++i;
-		}
-		return result;
+		return set.erase_if(pred);
 	}
 
 	template<typename I, typename Key = _detail::iter_key_t<I>, typename Hash = std::hash<Key>, typename Cmp = std::equal_to<Key>, typename Alloc = std::allocator<Key>>
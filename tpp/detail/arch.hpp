@@ -6,6 +6,9 @@
 
 #if defined(i386) || defined(__i386__) || defined(__i386) || defined(_M_X86) || defined(_M_IX86) || defined(__x86_64__) || defined(_M_X64)
 #define TPP_ARCH_X86
+#if defined(__x86_64__) || defined(_M_X64)
+#define TPP_ARCH_X64
+#endif
 #endif
 
 #ifndef TPP_NO_SIMD
@@ -23,6 +26,14 @@
 #define TPP_HAS_SSSE3
 #endif
 
+#ifdef __SSE4_2__
+#define TPP_HAS_SSE4_2
+#endif
+
+#ifdef __AES__
+#define TPP_HAS_AES
+#endif
+
 #ifdef _M_IX86_FP
 #if !defined(TPP_HAS_SSE) && (_M_IX86_FP >= 1 || defined(_M_AMD64) || defined(_M_X64))
 #define TPP_HAS_SSE
@@ -0,0 +1,161 @@
+/*
+ * Created by switchblade on 2023-01-14.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include "meta_block.hpp"
+
+namespace tpp
+{
+	/** @brief Bucket policy used to map hashes to buckets of a power-of-two sized bucket array.
+	 *
+	 * The hash is first mixed with a multiplicative (Fibonacci) step, after which the top bits of the product are used as bucket index.
+	 * Mixing makes sure that poorly distributed hashes (ex. identity hash of integers) still spread across the whole bucket array. */
+	class pow2_bucket_policy
+	{
+		static constexpr std::size_t digits = std::numeric_limits<std::size_t>::digits;
+
+	public:
+		/** Returns the smallest power of two that is not less than `n`. */
+		[[nodiscard]] static constexpr std::size_t round_count(std::size_t n) noexcept
+		{
+			std::size_t result = 2;
+			while (result < n) result <<= 1;
+			return result;
+		}
+
+		/** Updates the policy for a bucket array of size `n`. */
+		void set_count(std::size_t n) noexcept
+		{
+			TPP_ASSERT(n >= 2, "Bucket count must be at least 2");
+			m_shift = digits - _detail::log2(n);
+		}
+		/** Returns index of the bucket for hash `h`. */
+		[[nodiscard]] constexpr std::size_t operator()(std::size_t h) const noexcept { return (h * _detail::golden_ratio) >> m_shift; }
+
+	private:
+		std::size_t m_shift = digits - 1;
+	};
+
+	/** @brief Bucket policy using Lemire's multiply-shift range reduction.
+	 *
+	 * Bucket index is computed as the high half of the product of the mixed hash and the bucket count.
+	 * Unlike `pow2_bucket_policy`, bucket arrays of any size are supported. */
+	class fastrange_bucket_policy
+	{
+	public:
+		/** Returns `n`, as any bucket count is supported by the policy. */
+		[[nodiscard]] static constexpr std::size_t round_count(std::size_t n) noexcept { return std::max<std::size_t>(n, 1); }
+
+		/** Updates the policy for a bucket array of size `n`. */
+		constexpr void set_count(std::size_t n) noexcept { m_count = n; }
+		/** Returns index of the bucket for hash `h`. */
+		[[nodiscard]] constexpr std::size_t operator()(std::size_t h) const noexcept { return _detail::mul_hi(h * _detail::golden_ratio, m_count); }
+
+	private:
+		std::size_t m_count = 1;
+	};
+
+	/** @brief Bucket policy used to map hashes to buckets of a prime-sized bucket array.
+	 *
+	 * Modulo of the bucket count is computed via a precomputed reciprocal (Lemire's fastmod), which avoids integer division.
+	 * Since the reciprocal is only exact for 32-bit operands, upper and lower halves of 64-bit hashes are folded together. */
+	class prime_bucket_policy
+	{
+		static constexpr std::uint32_t primes[] = {
+				5u, 7u, 13u, 31u, 61u, 127u, 251u, 509u, 1021u, 2039u, 4093u, 8191u, 16381u, 32749u, 65521u, 131071u,
+				262139u, 524287u, 1048573u, 2097143u, 4194301u, 8388593u, 16777213u, 33554393u, 67108859u, 134217689u,
+				268435399u, 536870909u, 1073741789u, 2147483647u, 4294967291u,
+		};
+
+	public:
+		/** Returns the smallest tabulated prime that is not less than `n`. */
+		[[nodiscard]] static std::size_t round_count(std::size_t n) noexcept
+		{
+			const auto last = std::end(primes) - 1;
+			return *std::lower_bound(std::begin(primes), last, n, [](std::uint32_t p, std::size_t value) { return p < value; });
+		}
+
+		/** Updates the policy for a bucket array of size `n`. */
+		void set_count(std::size_t n) noexcept
+		{
+			TPP_ASSERT(n != 0 && n <= std::numeric_limits<std::uint32_t>::max(), "Bucket count must be a non-zero 32-bit value");
+			m_recip = std::numeric_limits<std::uint64_t>::max() / n + 1;
+			m_count = static_cast<std::uint32_t>(n);
+		}
+		/** Returns index of the bucket for hash `h`. */
+		[[nodiscard]] constexpr std::size_t operator()(std::size_t h) const noexcept
+		{
+			const auto h64 = static_cast<std::uint64_t>(h);
+			const auto folded = static_cast<std::uint32_t>(h64 ^ (h64 >> 32));
+			return static_cast<std::size_t>(_detail::mul_hi<std::uint64_t>(m_recip * folded, m_count));
+		}
+
+	private:
+		std::uint64_t m_recip = 1;
+		std::uint32_t m_count = 1;
+	};
+
+	/** @brief Bucket policy that replaces bucket chains with an open-addressed index.
+	 *
+	 * Every slot of the index holds a dense element position and a 7-bit tag of the element's hash. The tags are probed
+	 * in blocks (using SIMD where available), so that misses and most collisions are resolved without reading the element
+	 * vector. Index size is always a power of two, and every bucket contains at most one element. */
+	class open_bucket_policy
+	{
+		static constexpr std::size_t digits = std::numeric_limits<std::size_t>::digits;
+
+	public:
+		/** Returns the smallest power of two that is not less than `n` and the size of a probe block. */
+		[[nodiscard]] static constexpr std::size_t round_count(std::size_t n) noexcept
+		{
+			std::size_t result = sizeof(_detail::meta_block);
+			while (result < n) result <<= 1;
+			return result;
+		}
+
+		/** Updates the policy for an index of size `n`. */
+		void set_count(std::size_t n) noexcept
+		{
+			TPP_ASSERT(n >= sizeof(_detail::meta_block) && (n & (n - 1)) == 0, "Index size must be a power of 2 no less than probe block size");
+			m_shift = digits - _detail::log2(n);
+		}
+		/** Returns the starting probe position for hash `h`. The position is taken from the top bits of the mixed hash,
+		 * leaving the low bits of the hash to be used as the tag. */
+		[[nodiscard]] constexpr std::size_t operator()(std::size_t h) const noexcept { return (h * _detail::golden_ratio) >> m_shift; }
+		/** Returns the 7-bit tag of hash `h`. */
+		[[nodiscard]] static constexpr _detail::meta_byte tag(std::size_t h) noexcept { return _detail::meta_byte(std::int8_t(h & 0x7f)); }
+
+	private:
+		std::size_t m_shift = digits - 1;
+	};
+
+	namespace _detail
+	{
+		template<typename, typename = void>
+		struct select_bucket_policy { using type = pow2_bucket_policy; };
+		template<typename T>
+		struct select_bucket_policy<T, std::void_t<typename T::bucket_policy>> { using type = typename T::bucket_policy; };
+
+		/* Hash functors may select the bucket policy of dense tables via a `bucket_policy` member type. */
+		template<typename T>
+		using bucket_policy_t = typename select_bucket_policy<T>::type;
+
+		template<typename T, typename D, typename = void>
+		struct select_index_type { using type = D; };
+		template<typename T, typename D>
+		struct select_index_type<T, D, std::void_t<typename T::index_type>>
+		{
+			static_assert(std::is_unsigned_v<typename T::index_type> && sizeof(typename T::index_type) <= sizeof(D), "Index type must be an unsigned integer no wider than size type");
+			using type = typename T::index_type;
+		};
+
+		/* Hash functors may narrow the type of positions stored by dense table indices via an `index_type` member type. */
+		template<typename T, typename D>
+		using index_type_t = typename select_index_type<T, D>::type;
+	}
+}
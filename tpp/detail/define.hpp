@@ -45,6 +45,13 @@
 #define TPP_FORCEINLINE
 #endif
 
+/* Enables instruction set extensions for a single function, so that it can be selected at run time. MSVC does not require it. */
+#if defined(__GNUC__) || defined(__clang__)
+#define TPP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define TPP_TARGET(isa)
+#endif
+
 #if (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
 #define TPP_IF_LIKELY(x) if (x) [[likely]]
 #define TPP_IF_UNLIKELY(x) if (x) [[unlikely]]
@@ -4,60 +4,92 @@
 
 #pragma once
 
+#include <stdexcept>
 #include <limits>
 #include <tuple>
 
+#include "bucket_policy.hpp"
+#include "strided_view.hpp"
 #include "table_common.hpp"
+#include "executor.hpp"
+#include "snapshot.hpp"
 
 namespace tpp::_detail
 {
+	template<typename T, typename = void>
+	struct lazy_key_mask : std::integral_constant<std::size_t, 0> {};
+	template<typename T>
+	struct lazy_key_mask<T, std::void_t<decltype(T::lazy_mask)>> : std::integral_constant<std::size_t, T::lazy_mask> {};
+
 	template<typename I, typename V, typename K, typename Kh, typename Kc, typename Alloc, typename ValueTraits>
 	struct dense_table_traits : table_traits<I, V, K, Kh, Kc, Alloc>
 	{
 		using size_type = typename table_traits<V, V, K, Kh, Kc, Alloc>::size_type;
 
+		/* Narrower index type reduces memory used by bucket chains. Maximum index value is reserved as the empty position. */
+		using index_type = index_type_t<Kh, size_type>;
+
 		static constexpr size_type key_size = ValueTraits::key_size;
-		static constexpr size_type npos = std::numeric_limits<size_type>::max();
+		static constexpr size_type npos = std::numeric_limits<index_type>::max();
+
+		/* Bit mask of keys, indices of which are built on first lookup. Primary key is always indexed, as it is used to detect conflicts. */
+		static constexpr std::size_t lazy_mask = lazy_key_mask<ValueTraits>::value;
+		static_assert((lazy_mask & 1) == 0, "Primary key cannot be lazy");
 
 		using is_transparent = std::conjunction<_detail::is_transparent<Kh>, _detail::is_transparent<Kc>>;
 		using is_ordered = _detail::is_ordered<typename ValueTraits::link_type>;
 
+		using bucket_policy = bucket_policy_t<Kh>;
+		using is_open = std::is_same<bucket_policy, open_bucket_policy>;
+
 		using bucket_link = typename ValueTraits::link_type;
 		using bucket_hash = std::array<std::size_t, ValueTraits::key_size>;
-		using bucket_pos = std::array<size_type, ValueTraits::key_size>;
+		using bucket_pos = std::array<index_type, ValueTraits::key_size>;
 
-		struct bucket_node : packed_node<I, Alloc, ValueTraits>
+		/* Open-addressed index does not chain the nodes, so chain links are only stored for chained indices. */
+		struct chained_links
+		{
+			void reset_chain() noexcept { chain = make_array<key_size, index_type>(npos); }
+			void copy_chain(const chained_links &other) noexcept { chain = other.chain; }
+
+			bucket_pos chain;
+		};
+		struct open_links
+		{
+			constexpr void reset_chain() noexcept {}
+			constexpr void copy_chain(const open_links &) noexcept {}
+		};
+
+		struct bucket_node : packed_node<I, Alloc, ValueTraits>, std::conditional_t<is_open::value, open_links, chained_links>
 		{
 			template<typename... Args, typename = std::enable_if_t<std::is_constructible_v<I, Args...>>>
 			void construct(Alloc &alloc, Args &&...args)
 			{
 				packed_node<I, Alloc, ValueTraits>::construct(alloc, std::forward<Args>(args)...);
-				next = make_array<key_size>(npos);
+				this->reset_chain();
 			}
 			void construct(Alloc &alloc, const bucket_node &other)
 			{
 				packed_node<I, Alloc, ValueTraits>::construct(alloc, other);
-				next = other.next;
+				this->copy_chain(other);
 			}
 			void construct(Alloc &alloc, bucket_node &&other)
 			{
 				packed_node<I, Alloc, ValueTraits>::construct(alloc, std::move(other));
-				next = other.next;
+				this->copy_chain(other);
 			}
 			void move_from(bucket_node &other)
 			{
 				packed_node<I, Alloc, ValueTraits>::move_from(other);
-				next = other.next;
+				this->copy_chain(other);
 			}
 
 			template<typename U>
 			void relocate(U &alloc_dst, U &alloc_src, bucket_node &src)
 			{
 				packed_node<I, Alloc, ValueTraits>::relocate(alloc_dst, alloc_src, src);
-				next = src.next;
+				this->copy_chain(src);
 			}
-
-			bucket_pos next;
 		};
 
 		using sparse_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<bucket_pos>;
@@ -90,6 +122,7 @@ namespace tpp::_detail
 
 		static constexpr size_type npos = traits_t::npos;
 		static constexpr size_type key_size = traits_t::key_size;
+		static constexpr std::size_t lazy_mask = traits_t::lazy_mask;
 
 		static constexpr float initial_load_factor = .875f;
 
@@ -100,11 +133,22 @@ namespace tpp::_detail
 
 		using sparse_allocator = typename traits_t::sparse_allocator;
 		using dense_allocator = typename traits_t::dense_allocator;
+		using meta_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<meta_byte>;
 		using sparse_ptr = typename std::allocator_traits<sparse_allocator>::pointer;
 		using dense_ptr = typename std::allocator_traits<dense_allocator>::pointer;
+		using meta_ptr = typename std::allocator_traits<meta_allocator>::pointer;
 
+		using index_type = typename traits_t::index_type;
 		using bucket_pos = typename traits_t::bucket_pos;
-		using chain_slice = std::array<size_type *, key_size>;
+		using bucket_policy = typename traits_t::bucket_policy;
+		using is_open = typename traits_t::is_open;
+
+		/* Chained indices refer to an entry of a bucket chain, open-addressed indices refer to a slot of the index. */
+		using index_ref = std::conditional_t<is_open::value, size_type, index_type *>;
+		using chain_slice = std::array<index_ref, key_size>;
+
+		/* Minimum amount of elements for which indices of multi-key tables are built in parallel. */
+		constexpr static size_type parallel_index_threshold = 1 << 16;
 
 		using hash_base = empty_base<hasher>;
 		using cmp_base = empty_base<key_equal>;
@@ -191,7 +235,14 @@ namespace tpp::_detail
 			[[nodiscard]] constexpr node_ptr node() const noexcept { return m_base + m_pos; }
 
 			template<std::size_t... Is>
-			constexpr void increment(std::index_sequence<Is...>) noexcept { ((m_pos[Is] = node()->next[Is]), ...); }
+			constexpr void increment(std::index_sequence<Is...>) noexcept
+			{
+				/* Buckets of an open-addressed index contain at most one node. */
+				if constexpr (is_open::value)
+					m_pos = make_array<key_size, index_type>(npos);
+				else
+					((m_pos[Is] = node()->chain[Is]), ...);
+			}
 
 			node_ptr m_base = {};
 			bucket_pos m_pos = 0;
@@ -219,8 +270,7 @@ namespace tpp::_detail
 			TPP_IF_LIKELY(bucket_count != 0)
 			{
 				m_dense = std::allocator_traits<dense_allocator>::allocate(dense_alloc(), m_dense_capacity = bucket_count);
-				m_sparse = std::allocator_traits<sparse_allocator>::allocate(sparse_alloc(), m_sparse_size = bucket_count);
-				std::fill_n(m_sparse, m_sparse_size, make_array<key_size>(npos));
+				realloc_sparse(static_cast<size_type>(bucket_policy::round_count(bucket_count)));
 			}
 		}
 
@@ -260,7 +310,7 @@ namespace tpp::_detail
 
 				if constexpr (std::allocator_traits<sparse_allocator>::propagate_on_container_copy_assignment::value)
 				{
-					std::allocator_traits<sparse_allocator>::deallocate(sparse_alloc(), std::exchange(m_sparse, sparse_ptr{}), std::exchange(m_sparse_size, 0));
+					free_sparse();
 					sparse_alloc_base::operator=(other);
 				}
 				if constexpr (std::allocator_traits<dense_allocator>::propagate_on_container_copy_assignment::value)
@@ -286,7 +336,7 @@ namespace tpp::_detail
 
 				if constexpr (std::allocator_traits<sparse_allocator>::propagate_on_container_move_assignment::value)
 				{
-					std::allocator_traits<sparse_allocator>::deallocate(sparse_alloc(), std::exchange(m_sparse, sparse_ptr{}), std::exchange(m_sparse_size, 0));
+					free_sparse();
 					sparse_alloc_base::operator=(std::move(other));
 				}
 				if constexpr (std::allocator_traits<dense_allocator>::propagate_on_container_move_assignment::value)
@@ -305,7 +355,7 @@ namespace tpp::_detail
 		{
 			clear_data();
 			if (m_dense) std::allocator_traits<dense_allocator>::deallocate(dense_alloc(), m_dense, m_dense_capacity);
-			if (m_sparse) std::allocator_traits<sparse_allocator>::deallocate(sparse_alloc(), m_sparse, m_sparse_size);
+			free_sparse();
 		}
 
 		template<typename Iter>
@@ -331,7 +381,7 @@ namespace tpp::_detail
 		[[nodiscard]] const_reference back() const noexcept { return *to_iter(back_node()); }
 
 		[[nodiscard]] constexpr size_type size() const noexcept { return m_dense_size; }
-		[[nodiscard]] constexpr size_type max_size() const noexcept { return to_load_factor(max_bucket_count()); }
+		[[nodiscard]] constexpr size_type max_size() const noexcept { return std::min(to_load_factor(max_bucket_count()), max_bucket_count()); }
 		[[nodiscard]] constexpr size_type capacity() const noexcept { return to_load_factor(bucket_count()); }
 		[[nodiscard]] constexpr float load_factor() const noexcept { return static_cast<float>(size()) / static_cast<float>(bucket_count()); }
 
@@ -344,7 +394,19 @@ namespace tpp::_detail
 		[[nodiscard]] constexpr size_type max_bucket_count() const noexcept { return npos - 1; }
 		[[nodiscard]] constexpr size_type bucket_size(size_type n) const noexcept { return static_cast<size_type>(std::distance(begin(n), end(n))); }
 		template<typename T>
-		[[nodiscard]] size_type bucket(const T &key) const { return hash(key) % bucket_count(); }
+		[[nodiscard]] size_type bucket(const T &key) const
+		{
+			/* Nodes of an open-addressed index may be displaced from their starting probe position. */
+			if constexpr (is_open::value)
+			{
+				const auto h = hash(key);
+				if (const auto [node, slot] = find_node<0>(key, h); node != end_node())
+					return slot;
+				return m_bucket_policy(h);
+			}
+			else
+				return m_bucket_policy(hash(key));
+		}
 
 		void clear()
 		{
@@ -352,22 +414,43 @@ namespace tpp::_detail
 			if constexpr (is_ordered::value) *header_link() = bucket_link{};
 
 			/* Reset buckets & destroy entries. */
-			std::fill_n(m_sparse, bucket_count(), make_array<key_size>(npos));
+			reset_sparse();
 			clear_data();
 		}
 		void reserve(size_type n)
 		{
+			check_size(n);
 			if (n > m_dense_capacity) resize_data(n);
 			rehash(static_cast<size_type>(static_cast<float>(n) / m_max_load_factor));
 		}
 
+		/* Lazy indices are only built by non-const lookups. Const lookups fall back to a linear search while the index is not built,
+		 * so that they never modify the table and remain safe to call concurrently. */
 		template<std::size_t J, typename T>
-		[[nodiscard]] bool contains(const T &key) const { return find_node<J>(key, hash(key)).first != end_node(); }
+		[[nodiscard]] bool contains(const T &key)
+		{
+			require_index<J>();
+			return find_node<J>(key, hash(key)).first != end_node();
+		}
+		template<std::size_t J, typename T>
+		[[nodiscard]] bool contains(const T &key) const { return find_const<J>(key) != end_node(); }
 
 		template<std::size_t J, typename T>
-		[[nodiscard]] iterator find(const T &key) { return to_iter(find_node<J>(key, hash(key)).first); }
+		[[nodiscard]] iterator find(const T &key)
+		{
+			require_index<J>();
+			return to_iter(find_node<J>(key, hash(key)).first);
+		}
 		template<std::size_t J, typename T>
-		[[nodiscard]] const_iterator find(const T &key) const { return to_iter(find_node<J>(key, hash(key)).first); }
+		[[nodiscard]] const_iterator find(const T &key) const { return to_iter(find_const<J>(key)); }
+
+		/* Overloads of lookup functions that accept a precomputed hash `h` of the key. Only available for tables with a single key. */
+		template<typename T>
+		[[nodiscard]] bool contains_hashed(const T &key, std::size_t h) const { return find_node<0>(key, h).first != end_node(); }
+		template<typename T>
+		[[nodiscard]] iterator find_hashed(const T &key, std::size_t h) { return to_iter(find_node<0>(key, h).first); }
+		template<typename T>
+		[[nodiscard]] const_iterator find_hashed(const T &key, std::size_t h) const { return to_iter(find_node<0>(key, h).first); }
 
 		std::pair<iterator, bool> insert(const insert_type &value) { return do_insert({}, ValueTraits::get_key(value), value); }
 		std::pair<iterator, bool> insert(insert_type &&value) { return do_insert({}, ValueTraits::get_key(value), std::move(value)); }
@@ -389,7 +472,14 @@ namespace tpp::_detail
 		void insert(Iter first, Iter last)
 		{
 			if constexpr (std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iter>::iterator_category>)
-				reserve(size() + static_cast<size_type>(std::distance(first, last)));
+			{
+				const auto n = static_cast<size_type>(std::distance(first, last));
+				reserve(size() + n);
+
+				using elem_t = std::decay_t<typename std::iterator_traits<Iter>::reference>;
+				if constexpr (key_size > 1 && (std::is_same_v<elem_t, insert_type> || std::is_same_v<elem_t, value_type>))
+					if (use_parallel_index(n)) return insert_hashed(std::make_index_sequence<key_size>{}, first, n);
+			}
 			for (; first != last; ++first) insert(*first);
 		}
 
@@ -420,17 +510,33 @@ namespace tpp::_detail
 			return do_try_emplace({}, std::move(keys), std::forward<Args>(args)...);
 		}
 		template<typename... Ks, typename... Args>
+		std::pair<iterator, bool> try_emplace_hashed(std::tuple<Ks...> keys, std::size_t h, Args &&...args) TPP_REQUIRES((std::is_constructible_v<V, std::piecewise_construct_t, std::tuple<Ks ...>, std::tuple<Args && ...>>))
+		{
+			static_assert(key_size == 1, "Precomputed hash can only be used with a single key");
+			return do_try_emplace(std::make_index_sequence<key_size>{}, {}, bucket_hash{h}, std::move(keys), std::forward<Args>(args)...);
+		}
+		template<typename... Ks, typename... Args>
 		iterator try_emplace(const_iterator hint, std::tuple<Ks...> keys, Args &&...args) TPP_REQUIRES((std::is_constructible_v<V, std::piecewise_construct_t, std::tuple<Ks ...>, std::tuple<Args && ...>>))
 		{
 			return do_try_emplace(to_underlying(hint), std::move(keys), std::forward<Args>(args)...).first;
 		}
 
 		template<std::size_t J, typename T, typename = std::enable_if_t<!std::is_convertible_v<T, const_iterator>>>
-		iterator erase(const T &key) { return do_erase<J>(key, hash(key)); }
+		iterator erase(const T &key)
+		{
+			require_index<J>();
+			return do_erase<J>(key, hash(key));
+		}
+		template<typename T>
+		iterator erase_hashed(const T &key, std::size_t h)
+		{
+			static_assert(key_size == 1, "Precomputed hash can only be used with a single key");
+			return do_erase<0>(key, h);
+		}
 		iterator erase(const_iterator where)
 		{
-			const auto pos = &(*to_underlying(where)) - m_dense;
-			return do_erase(pos, m_dense + pos);
+			const auto pos = &(*to_underlying(where)) - to_address(m_dense);
+			return do_erase(pos, to_address(m_dense + pos));
 		}
 		iterator erase(const_iterator first, const_iterator last)
 		{
@@ -439,6 +545,65 @@ namespace tpp::_detail
 			return result;
 		}
 
+		/* Returns a view of the member selected by `get` for every node, in storage order. */
+		template<typename F>
+		[[nodiscard]] auto view(F get) noexcept
+		{
+			using element_t = std::remove_reference_t<decltype(get(std::declval<bucket_node &>()))>;
+			using view_t = strided_view<element_t>;
+
+			TPP_IF_UNLIKELY(m_dense_size == 0)
+				return view_t{};
+			return view_t{&get(m_dense[0]), m_dense_size, static_cast<std::ptrdiff_t>(sizeof(bucket_node))};
+		}
+		template<typename F>
+		[[nodiscard]] auto view(F get) const noexcept
+		{
+			using element_t = std::remove_reference_t<decltype(get(std::declval<const bucket_node &>()))>;
+			using view_t = strided_view<element_t>;
+
+			TPP_IF_UNLIKELY(m_dense_size == 0)
+				return view_t{};
+			return view_t{&get(std::as_const(m_dense[0])), m_dense_size, static_cast<std::ptrdiff_t>(sizeof(bucket_node))};
+		}
+
+		template<typename P>
+		size_type erase_if(P pred)
+		{
+			auto alloc = allocator_type{dense_alloc()};
+			size_type dst = 0, src = 0;
+
+			/* Compact the dense buffer in a single pass, preserving relative order of the remaining nodes. */
+			const auto compact_to = [&](size_type i)
+			{
+				if (dst != i) m_dense[dst].relocate(alloc, alloc, m_dense[i]);
+				++dst;
+			};
+			try
+			{
+				for (; src < size(); ++src)
+				{
+					auto *node = to_address(m_dense + src);
+					if (!pred(*std::as_const(*this).to_iter(node)))
+					{
+						compact_to(src);
+						continue;
+					}
+
+					if constexpr (is_ordered::value) static_cast<bucket_link *>(node)->unlink();
+					node->destroy(alloc);
+				}
+			}
+			catch (...)
+			{
+				/* Keep the rest of the nodes if the predicate throws. */
+				while (src < size()) compact_to(src++);
+				finish_erase_if(dst);
+				throw;
+			}
+			return finish_erase_if(dst);
+		}
+
 		void rehash(size_type n)
 		{
 			/* Skip rehash if table is empty and requested size is 0. */
@@ -450,6 +615,103 @@ namespace tpp::_detail
 			if (!n || new_cap != m_sparse_size) do_rehash(new_cap);
 		}
 
+		[[nodiscard]] std::vector<iterator_range<iterator>> split(size_type n) { return split_nodes<iterator>(n); }
+		[[nodiscard]] std::vector<iterator_range<const_iterator>> split(size_type n) const { return split_nodes<const_iterator>(n); }
+
+		template<typename S>
+		void save(S &os, bool with_index) const
+		{
+			assert_snapshot();
+
+			with_index = with_index && m_sparse_size != 0;
+			const auto header = snapshot_header_for(m_sparse_size, size(), with_index);
+			const auto layout = snapshot_layout(header);
+			snapshot_write(os, &header, sizeof(header));
+			snapshot_write_zeros(os, layout.dense_offset - sizeof(header));
+			snapshot_write(os, to_address(m_dense), size() * sizeof(bucket_node));
+			if (!with_index) return;
+
+			snapshot_write_zeros(os, layout.sparse_offset - layout.dense_offset - size() * sizeof(bucket_node));
+			snapshot_write(os, to_address(m_sparse), m_sparse_size * sizeof(bucket_pos));
+			if constexpr (is_open::value)
+				snapshot_write(os, to_address(m_meta), meta_size() * key_size);
+		}
+		template<typename S>
+		void load(S &is)
+		{
+			assert_snapshot();
+
+			snapshot_header header;
+			snapshot_read(is, &header, sizeof(header));
+			header.validate(snapshot_header_for(0, 0, false));
+
+			const auto with_index = (header.flags & snapshot_index) != 0;
+			const auto buckets = static_cast<size_type>(header.capacity);
+			const auto lazy = static_cast<std::size_t>(header.extra[0]);
+			if (header.size >= npos || header.capacity > std::numeric_limits<size_type>::max() / sizeof(bucket_pos) / 2 || (lazy & ~lazy_mask) != 0 ||
+			    (buckets == 0 ? header.size != 0 || with_index : bucket_policy::round_count(buckets) != buckets) || header.extra[1] > header.capacity)
+				throw snapshot_error("Invalid table snapshot");
+
+			const auto layout = snapshot_layout(header);
+			snapshot_skip(is, layout.dense_offset - sizeof(header));
+
+			/* Read the snapshot into a temporary table, so that this table is left unchanged on failure. */
+			auto tmp = dense_table{0, get_hash(), get_cmp(), allocator_type{get_allocator()}};
+			const auto n = static_cast<size_type>(header.size);
+			if (n != 0)
+			{
+				realloc_buffer(tmp.dense_alloc(), tmp.m_dense, tmp.m_dense_capacity, n);
+				snapshot_read(is, to_address(tmp.m_dense), n * sizeof(bucket_node));
+				tmp.m_dense_size = n;
+			}
+			tmp.m_lazy = lazy;
+
+			if (buckets != 0) tmp.realloc_sparse(buckets);
+			if (with_index)
+			{
+				/* Saved index is used as-is after checking that it only refers to valid positions. */
+				snapshot_skip(is, layout.sparse_offset - layout.dense_offset - n * sizeof(bucket_node));
+				snapshot_read(is, to_address(tmp.m_sparse), buckets * sizeof(bucket_pos));
+				if constexpr (is_open::value)
+				{
+					snapshot_read(is, to_address(tmp.m_meta), tmp.meta_size() * key_size);
+					tmp.m_num_deleted = static_cast<size_type>(header.extra[1]);
+				}
+				tmp.verify_index(std::make_index_sequence<key_size>{});
+			}
+			else
+				tmp.index_nodes(0);
+
+			tmp.verify_hashes(std::make_index_sequence<key_size>{});
+			swap_buffers(tmp);
+		}
+
+		/* Rewrites the dense buffer so that physical order of the nodes matches insertion order. */
+		void compact()
+		{
+			static_assert(is_ordered::value, "compact is only available for ordered tables");
+
+			TPP_IF_UNLIKELY(m_dense_size == 0)
+				return;
+
+			auto &alloc = dense_alloc();
+			auto tmp_dense = std::allocator_traits<dense_allocator>::allocate(alloc, m_dense_capacity);
+
+			/* Relocate nodes in link order. Moving an ordered link re-links it's neighbors, so the insertion order chain stays intact. */
+			auto *node = begin_node();
+			for (size_type i = 0; i < m_dense_size; ++i)
+			{
+				auto *link = static_cast<bucket_link *>(node);
+				auto *next = static_cast<bucket_node *>(link->off(link->next));
+				tmp_dense[i].relocate(alloc, alloc, *node);
+				node = next;
+			}
+			std::allocator_traits<dense_allocator>::deallocate(alloc, std::exchange(m_dense, tmp_dense), m_dense_capacity);
+
+			/* Positions of all nodes have changed, re-build the bucket chains. */
+			do_rehash(m_sparse_size);
+		}
+
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return m_max_load_factor; }
 		constexpr void max_load_factor(float f) noexcept { m_max_load_factor = f; }
 
@@ -519,40 +781,275 @@ namespace tpp::_detail
 		[[nodiscard]] auto to_iter(bucket_node *node) noexcept { return iterator{node_iterator{node}}; }
 		[[nodiscard]] auto to_iter(bucket_node *node) const noexcept { return const_iterator{node_iterator{node}}; }
 
+		/* Splits the dense buffer into `n` contiguous index ranges of (nearly) equal size. */
+		template<typename It>
+		[[nodiscard]] std::vector<iterator_range<It>> split_nodes(size_type n) const
+		{
+			static_assert(!is_ordered::value, "split is only available for unordered tables");
+
+			n = std::clamp<size_type>(n, 1, std::max<size_type>(size(), 1));
+			std::vector<iterator_range<It>> result;
+			result.reserve(n);
+			for (size_type i = 0; i < n; ++i)
+				result.emplace_back(It{node_iterator{begin_node() + size() * i / n}}, It{node_iterator{begin_node() + size() * (i + 1) / n}});
+			return result;
+		}
+
+		/* Snapshots contain raw nodes & optionally the index of the table. Ordered tables are not supported, as their header link is not part of the buffers. */
+		constexpr static void assert_snapshot() noexcept
+		{
+			static_assert(!is_ordered::value, "Snapshots are only available for unordered tables");
+			static_assert(is_snapshot_compatible<I>::value, "Snapshots require trivially copyable elements");
+		}
+		[[nodiscard]] snapshot_header snapshot_header_for(size_type buckets, size_type size, bool with_index) const
+		{
+			using first_key = std::decay_t<decltype(std::declval<const bucket_node &>().template key<0>())>;
+
+			snapshot_header result;
+			result.kind = static_cast<std::uint32_t>(snapshot_kind::dense);
+			result.node_size = sizeof(bucket_node);
+			result.node_align = alignof(bucket_node);
+			result.block_size = sizeof(bucket_pos);
+			result.flags = with_index ? snapshot_index : 0;
+			result.capacity = buckets;
+			result.size = size;
+			result.extra[0] = m_lazy;
+			result.extra[1] = m_num_deleted;
+			result.fingerprint = snapshot_fingerprint<first_key>(get_hash());
+			return result;
+		}
+		[[nodiscard]] static constexpr dense_snapshot_layout snapshot_layout(const snapshot_header &header) noexcept
+		{
+			const auto buckets = (header.flags & snapshot_index) ? header.capacity : 0;
+			const auto meta_bytes = is_open::value && buckets ? (buckets + sizeof(meta_block) - 1) * key_size : 0;
+			return {header.size, sizeof(bucket_node), alignof(bucket_node), buckets, sizeof(bucket_pos), meta_bytes};
+		}
+		/* Checks that every entry of a loaded index refers to a valid position, and that chains of the index terminate. */
+		template<std::size_t... Is>
+		void verify_index(std::index_sequence<Is...>) const { (verify_index<Is>(), ...); }
+		template<std::size_t J>
+		void verify_index() const
+		{
+			const auto valid = [&](size_type pos) { return pos == npos || (pos < size() && is_indexed<J>()); };
+			if constexpr (is_open::value)
+			{
+				/* Probing terminates at empty slots, of which there must be at least one. */
+				const auto *meta = get_meta<J>();
+				size_type empty = 0;
+				for (size_type i = 0; i < m_sparse_size; ++i)
+				{
+					const auto pos = m_sparse[i][J];
+					if (!valid(pos) || is_occupied(meta[i]) != (pos != npos) || (!is_indexed<J>() && meta[i] != meta_byte::empty))
+						throw snapshot_error("Invalid table snapshot");
+					empty += meta[i] == meta_byte::empty;
+				}
+				for (size_type i = 0; i < sizeof(meta_block) - 1; ++i)
+					if (meta[m_sparse_size + i] != meta[i & (m_sparse_size - 1)])
+						throw snapshot_error("Invalid table snapshot");
+				if (is_indexed<J>() && empty == 0)
+					throw snapshot_error("Invalid table snapshot");
+			}
+			else
+			{
+				/* Every node must be referenced exactly once, either by a bucket or by another node, so that chains can not form cycles. */
+				std::vector<bool> referenced(size());
+				const auto reference = [&](size_type pos)
+				{
+					if (!valid(pos)) throw snapshot_error("Invalid table snapshot");
+					if (pos == npos) return;
+					if (referenced[pos]) throw snapshot_error("Invalid table snapshot");
+					referenced[pos] = true;
+				};
+				for (size_type i = 0; i < m_sparse_size; ++i) reference(m_sparse[i][J]);
+				if (!is_indexed<J>()) return;
+				for (size_type i = 0; i < size(); ++i) reference(m_dense[i].chain[J]);
+				if (std::find(referenced.begin(), referenced.end(), false) != referenced.end())
+					throw snapshot_error("Invalid table snapshot");
+			}
+		}
+		/* Checks that stored hashes of the (first few) elements match the hash function. */
+		template<std::size_t... Is>
+		void verify_hashes(std::index_sequence<Is...>) const
+		{
+			constexpr size_type max_rehashed = 64;
+			for (size_type i = 0; i < std::min(size(), max_rehashed); ++i)
+			{
+				const auto &node = m_dense[i];
+				if (((is_indexed<Is>() && hash(node.template key<Is>()) != node.template hash<Is>()) || ...))
+					throw snapshot_error("Table snapshot hash function mismatch");
+			}
+		}
+
+		[[nodiscard]] constexpr size_type meta_size() const noexcept { return m_sparse_size + sizeof(meta_block) - 1; }
+		template<std::size_t J>
+		[[nodiscard]] const meta_byte *get_meta() const noexcept { return to_address(m_meta) + J * meta_size(); }
 		template<std::size_t J>
-		[[nodiscard]] size_type *get_chain(std::size_t h) const noexcept
+		void set_meta(size_type slot, meta_byte value) noexcept
 		{
-			/* Same reason for `const_cast` as with `header_link` above. */
-			return m_sparse ? const_cast<size_type *>(m_sparse[h % bucket_count()].data() + J) : nullptr;
+			/* Mirror the head of the index past it's end, so that blocks can be loaded without wrapping. */
+			auto *meta = const_cast<meta_byte *>(get_meta<J>());
+			if (slot < sizeof(meta_block) - 1) meta[m_sparse_size + slot] = value;
+			meta[slot] = value;
+		}
+		/* Probes the open-addressed index of key `J` for hash `h`, until `pred(slot)` returns true or a block with an empty slot is reached. */
+		template<std::size_t J, typename P>
+		[[nodiscard]] size_type probe_index(std::size_t h, P pred) const
+		{
+			const auto *meta = get_meta<J>();
+			const auto tag = bucket_policy::tag(h);
+			const auto mask = m_sparse_size - 1;
+			for (size_type pos = m_bucket_policy(h), step = 0;;)
+			{
+				const auto block = meta_block(meta + pos);
+				for (auto match = block.match_eq(tag); !match.empty(); ++match)
+					if (const auto slot = (pos + match.lsb_index()) & mask; pred(slot))
+						return slot;
+				TPP_IF_UNLIKELY(!block.match_empty().empty())
+					return npos;
+
+				/* Triangular probing over blocks visits every block of a power-of-two index. */
+				step += sizeof(meta_block);
+				pos = (pos + step) & mask;
+				TPP_ASSERT(step <= m_sparse_size, "Probe must not exceed index size");
+			}
 		}
 		template<std::size_t J>
-		[[nodiscard]] size_type *find_chain_ptr(size_type *bucket, size_type pos) const noexcept
+		[[nodiscard]] size_type find_available(std::size_t h) const noexcept
 		{
-			while (*bucket != npos && *bucket != pos) bucket = &m_dense[*bucket].next[J];
-			return bucket;
+			const auto *meta = get_meta<J>();
+			const auto mask = m_sparse_size - 1;
+			for (size_type pos = m_bucket_policy(h), step = 0;;)
+			{
+				if (const auto match = meta_block(meta + pos).match_available(); !match.empty())
+					return (pos + match.lsb_index()) & mask;
+
+				step += sizeof(meta_block);
+				pos = (pos + step) & mask;
+				TPP_ASSERT(step <= m_sparse_size, "Probe must not exceed index size");
+			}
+		}
+
+		template<std::size_t J>
+		[[nodiscard]] constexpr bool is_indexed() const noexcept
+		{
+			if constexpr ((lazy_mask >> J) & 1)
+				return !((m_lazy >> J) & 1);
+			else
+				return true;
+		}
+		template<std::size_t J>
+		void require_index()
+		{
+			if constexpr ((lazy_mask >> J) & 1)
+				TPP_IF_UNLIKELY(!is_indexed<J>()) build_index<J>();
 		}
 		template<std::size_t J, typename T>
-		[[nodiscard]] std::pair<bucket_node *, size_type *> find_node(const T &key, std::size_t h) const
+		[[nodiscard]] bucket_node *find_const(const T &key) const
 		{
-			auto *idx = get_chain<J>(h);
-			if (idx)
-				while (*idx != npos)
+			if constexpr ((lazy_mask >> J) & 1)
+				TPP_IF_UNLIKELY(!is_indexed<J>())
 				{
-					auto &entry = m_dense[*idx];
-					if (entry.template hash<J>() == h && cmp(key, entry.template key<J>()))
-						return {const_cast<bucket_node *>(&entry), idx};
-					idx = const_cast<size_type *>(&entry.next[J]);
+					for (size_type i = 0; i < size(); ++i)
+						if (auto *node = to_address(m_dense + i); cmp(key, node->template key<J>())) return node;
+					return end_node();
 				}
-			return {end_node(), idx};
+			return find_node<J>(key, hash(key)).first;
+		}
+		template<std::size_t J>
+		void build_index()
+		{
+			/* Hash all keys before modifying the index, in case the hasher throws. */
+			for (size_type i = 0; i < size(); ++i)
+			{
+				auto &node = m_dense[i];
+				node.template hash<J>() = hash(node.template key<J>());
+			}
+			m_lazy &= ~(std::size_t{1} << J);
+			for (size_type i = 0; i < size(); ++i) insert_node<J>(m_dense[i], i);
+		}
+		/* Hashes of lazy keys are only computed once their index is built. */
+		template<std::size_t J, typename T>
+		[[nodiscard]] std::size_t hash_key(const T &key) const { return is_indexed<J>() ? hash(key) : 0; }
+		template<std::size_t J, typename T>
+		[[nodiscard]] std::pair<bucket_node *, index_ref> find_conflict(const T &key, std::size_t h) const
+		{
+			TPP_IF_UNLIKELY(!is_indexed<J>())
+				return {end_node(), index_ref{}};
+			return find_node<J>(key, h);
+		}
+
+		template<std::size_t J>
+		[[nodiscard]] index_type *get_chain(std::size_t h) const noexcept
+		{
+			/* Same reason for `const_cast` as with `header_link` above. */
+			return m_sparse ? const_cast<index_type *>(m_sparse[m_bucket_policy(h)].data() + J) : nullptr;
+		}
+		/* Returns reference to the index entry of key `J` pointing to node at `pos`. */
+		template<std::size_t J>
+		[[nodiscard]] index_ref find_index(std::size_t h, size_type pos) const noexcept
+		{
+			TPP_IF_UNLIKELY(!is_indexed<J>())
+				return index_ref{};
+
+			if constexpr (is_open::value)
+			{
+				const auto slot = probe_index<J>(h, [&](size_type i) { return m_sparse[i][J] == pos; });
+				TPP_ASSERT(slot != npos, "Node must be present within the index");
+				return slot;
+			}
+			else
+			{
+				auto *idx = get_chain<J>(h);
+				while (*idx != npos && *idx != pos) idx = &m_dense[*idx].chain[J];
+				return idx;
+			}
+		}
+		template<std::size_t J, typename T>
+		[[nodiscard]] std::pair<bucket_node *, index_ref> find_node(const T &key, std::size_t h) const
+		{
+			if constexpr (is_open::value)
+			{
+				TPP_IF_UNLIKELY(!m_sparse)
+					return {end_node(), npos};
+
+				const auto slot = probe_index<J>(h, [&](size_type i)
+				{
+					auto &entry = m_dense[m_sparse[i][J]];
+					return entry.template hash<J>() == h && cmp(key, entry.template key<J>());
+				});
+				if (slot != npos)
+					return {const_cast<bucket_node *>(to_address(m_dense + m_sparse[slot][J])), slot};
+				return {end_node(), npos};
+			}
+			else
+			{
+				auto *idx = get_chain<J>(h);
+				if (idx)
+					while (*idx != npos)
+					{
+						auto &entry = m_dense[*idx];
+						if (entry.template hash<J>() == h && cmp(key, entry.template key<J>()))
+							return {const_cast<bucket_node *>(&entry), idx};
+						idx = const_cast<index_type *>(&entry.chain[J]);
+					}
+				return {end_node(), idx};
+			}
 		}
 
+		/* Positions of nodes are stored as the index type, which thus limits the size of the table. */
+		void check_size(size_type n) const
+		{
+			if (n > max_size()) throw std::length_error("Table size exceeds the range of the index type");
+		}
 		template<typename... Args>
 		auto push_node(Args &&...args) -> std::pair<size_type, bucket_node *>
 		{
+			check_size(m_dense_size + 1);
+
 			const auto pos = m_dense_size++;
 			auto alloc = allocator_type{dense_alloc()};
 			m_dense[pos].construct(alloc, std::forward<Args>(args)...);
-			return {pos, m_dense + pos};
+			return {pos, to_address(m_dense + pos)};
 		}
 		void pop_node()
 		{
@@ -560,27 +1057,126 @@ namespace tpp::_detail
 			m_dense[--m_dense_size].destroy(alloc);
 		}
 
+		/* Indices of different keys occupy disjoint lanes of the bucket & metadata buffers, and disjoint `chain` entries of the nodes.
+		 * Bulk operations on large multi-key tables thus process every key on a separate thread. */
+		[[nodiscard]] static constexpr bool use_parallel_index([[maybe_unused]] size_type n) noexcept
+		{
+#ifndef TPP_NO_PARALLEL_INDEX
+			return key_size > 1 && n >= parallel_index_threshold;
+#else
+			return false;
+#endif
+		}
+		/* Invokes `f(std::integral_constant<std::size_t, J>{})` for every key `J`, on separate threads if `parallel` is set. */
+		template<typename F, std::size_t... Is>
+		static void for_each_key(std::index_sequence<Is...>, bool parallel, F &&f)
+		{
+			if (parallel)
+				thread_executor{key_size}.bulk(key_size, [&](std::size_t j) { ((j == Is ? f(std::integral_constant<std::size_t, Is>{}) : void()), ...); });
+			else
+				(f(std::integral_constant<std::size_t, Is>{}), ...);
+		}
+		/* Inserts nodes at `[first, size())` into the indices of all keys. */
+		void index_nodes(size_type first) noexcept
+		{
+			for_each_key(std::make_index_sequence<key_size>{}, use_parallel_index(size() - first), [&](auto j)
+			{
+				for (auto i = first; i < size(); ++i) insert_node<decltype(j)::value>(m_dense[i], i);
+			});
+		}
+		/* Bulk insertion hashes the keys of all elements up-front, one key per thread. Elements are then inserted in order,
+		 * since conflicts between the inserted elements depend on it. */
+		template<typename Iter, std::size_t... Is>
+		void insert_hashed(std::index_sequence<Is...>, Iter first, size_type n)
+		{
+			std::array<std::vector<std::size_t>, key_size> hashes;
+			for (auto &lane: hashes) lane.resize(n);
+			for_each_key(std::index_sequence<Is...>{}, true, [&](auto j)
+			{
+				constexpr auto J = decltype(j)::value;
+				for (size_type i = 0; i < n; ++i)
+					hashes[J][i] = hash_key<J>(ValueTraits::template get_key<J>(first[i]));
+			});
+
+			for (size_type i = 0; i < n; ++i)
+			{
+				const auto &value = first[i];
+				do_insert(std::index_sequence<Is...>{}, {}, bucket_hash{hashes[Is][i]...}, ValueTraits::get_key(value), value);
+			}
+		}
+
+		template<std::size_t J>
+		void insert_index(index_ref ref, std::size_t h, size_type pos) noexcept
+		{
+			TPP_IF_UNLIKELY(!is_indexed<J>())
+				return;
+
+			if constexpr (is_open::value)
+			{
+				/* Open-addressed index does not reserve a slot during lookup, find one now. */
+				const auto slot = find_available<J>(h);
+				set_meta<J>(slot, bucket_policy::tag(h));
+				m_sparse[slot][J] = pos;
+				static_cast<void>(ref);
+			}
+			else
+				*ref = pos; /* Node is always inserted at the end of the chain. */
+		}
+		template<std::size_t J>
+		void erase_index(index_ref ref, bucket_node *node) noexcept
+		{
+			TPP_IF_UNLIKELY(!is_indexed<J>())
+				return;
+
+			if constexpr (is_open::value)
+			{
+				set_meta<J>(ref, meta_byte::deleted);
+				m_sparse[ref][J] = npos;
+
+				/* Reused deleted slots are not accounted for, as they can differ between keys. This way the count is an upper bound for every key. */
+				m_num_deleted += J == 0;
+				static_cast<void>(node);
+			}
+			else
+				*ref = node->chain[J];
+		}
 		template<std::size_t J>
 		void insert_node(bucket_node &node, size_type pos) noexcept
 		{
-			auto *chain_idx = get_chain<J>(node.template hash<J>());
-			node.next[J] = *chain_idx;
-			*chain_idx = pos;
+			TPP_IF_UNLIKELY(!is_indexed<J>())
+				return;
+
+			if constexpr (is_open::value)
+				insert_index<J>(npos, node.template hash<J>(), pos);
+			else
+			{
+				auto *chain_idx = get_chain<J>(node.template hash<J>());
+				node.chain[J] = *chain_idx;
+				*chain_idx = pos;
+			}
 		}
 		template<std::size_t J>
 		void move_chain(size_type from, size_type to) noexcept
 		{
-			auto &target = *find_chain_ptr<J>(get_chain<J>(m_dense[from].template hash<J>()), from);
-			TPP_ASSERT(target != npos, "Cannot move to an empty node");
-			target = to;
+			TPP_IF_UNLIKELY(!is_indexed<J>())
+				return;
+
+			const auto ref = find_index<J>(m_dense[from].template hash<J>(), from);
+			if constexpr (is_open::value)
+				m_sparse[ref][J] = to;
+			else
+			{
+				TPP_ASSERT(*ref != npos, "Cannot move to an empty node");
+				*ref = to;
+			}
 		}
 
 		template<std::size_t... Is>
 		iterator commit_node(node_iterator hint, size_type pos, chain_slice slice, bucket_hash hashes, bucket_node *node)
 		{
 			/* Create the bucket and insertion order links. */
-			if constexpr (is_ordered::value) node->link(hint.link ? const_cast<bucket_link *>(hint.link) : back_node());
-			((*slice[Is] = pos), ...); /* Node is always inserted at the end of the chain. */
+			if constexpr (is_ordered::value) node->link(hint.link ? const_cast<bucket_link *>(to_address(hint.link)) : back_node());
+			(insert_index<Is>(slice[Is], hashes[Is], pos), ...);
 
 			((node->template hash<Is>() = hashes[Is]), ...);
 			return to_iter(node);
@@ -604,7 +1200,7 @@ namespace tpp::_detail
 				next = static_cast<bucket_node *>(link->off(link->next));
 				link->unlink();
 			}
-			((*slice[Is] = node->next[Is]), ...);
+			(erase_index<Is>(slice[Is], node), ...);
 
 			/* Swap the entry with the last if necessary. */
 			if (const auto end_pos = size() - 1; pos != end_pos)
@@ -625,10 +1221,10 @@ namespace tpp::_detail
 
 			/* Create a temporary object to check if it already exists within the table. */
 			const auto [pos, tmp] = push_node(std::forward<Args>(args)...);
-			const auto hs = bucket_hash{hash(tmp->template key<Is>())...};
-			const auto node_list = std::array{find_node<Is>(tmp->template key<Is>(), hs[Is])...};
+			const auto hs = bucket_hash{hash_key<Is>(tmp->template key<Is>())...};
+			const auto node_list = std::array{find_conflict<Is>(tmp->template key<Is>(), hs[Is])...};
 			for (auto [node, chain]: node_list)
-				if (chain && *chain != npos)
+				if (node != end_node())
 				{
 					/* Found a conflict, return the existing node. */
 					pop_node();
@@ -641,21 +1237,39 @@ namespace tpp::_detail
 		template<typename... Args>
 		std::pair<iterator, bool> do_emplace(node_iterator hint, Args &&...args)
 		{
-			return do_emplace(std::make_index_sequence<key_size>{}, hint, std::forward<Args>(args)...);
+			/* If the key can be obtained from the arguments, look it up before constructing the node. */
+			using extractor = key_extractor<I, K>;
+			if constexpr (is_key_extractable<extractor, std::tuple<Args...>>::value)
+				return do_insert(hint, key_pack(extractor::get(args...)), std::forward<Args>(args)...);
+			else
+				return do_emplace(std::make_index_sequence<key_size>{}, hint, std::forward<Args>(args)...);
+		}
+		/* Multikey traits use the key tuple itself as the key pack, while single-key traits wrap the key into a tuple. */
+		[[nodiscard]] static constexpr decltype(auto) key_pack(const key_type &key) noexcept
+		{
+			if constexpr (std::is_reference_v<decltype(ValueTraits::get_key(std::declval<insert_type &>()))>)
+				return key;
+			else
+				return std::forward_as_tuple(key);
 		}
 
 		/* NOTE: insert_or_assign is available only for containers where `value_type` is a pair. */
 		template<typename... Ks, typename... Args, std::size_t... Is>
 		std::pair<iterator, bool> do_try_emplace(std::index_sequence<Is...>, node_iterator hint, std::tuple<Ks...> ks, Args &&...args)
+		{
+			const auto hs = bucket_hash{hash_key<Is>(std::get<Is>(ks))...};
+			return do_try_emplace(std::index_sequence<Is...>{}, hint, hs, std::move(ks), std::forward<Args>(args)...);
+		}
+		template<typename... Ks, typename... Args, std::size_t... Is>
+		std::pair<iterator, bool> do_try_emplace(std::index_sequence<Is...>, node_iterator hint, const bucket_hash &hs, std::tuple<Ks...> ks, Args &&...args)
 		{
 			maybe_resize(hint);
 			maybe_rehash();
 
 			/* If a candidate was found, do nothing. Otherwise, emplace a new entry. */
-			const auto hs = bucket_hash{hash(std::get<Is>(ks))...};
-			const auto node_list = std::array{find_node<Is>(std::get<Is>(ks), hs[Is])...};
+			const auto node_list = std::array{find_conflict<Is>(std::get<Is>(ks), hs[Is])...};
 			for (auto [node, chain]: node_list)
-				if (*chain != npos)
+				if (node != end_node())
 				{
 					/* Found a conflict, return the existing node. */
 					return {to_iter(node), false};
@@ -673,15 +1287,20 @@ namespace tpp::_detail
 
 		template<typename... Ks, typename... Args, std::size_t... Is>
 		std::pair<iterator, bool> do_insert(std::index_sequence<Is...>, node_iterator hint, const std::tuple<Ks...> &ks, Args &&...args)
+		{
+			const auto hs = bucket_hash{hash_key<Is>(std::get<Is>(ks))...};
+			return do_insert(std::index_sequence<Is...>{}, hint, hs, ks, std::forward<Args>(args)...);
+		}
+		template<typename... Ks, typename... Args, std::size_t... Is>
+		std::pair<iterator, bool> do_insert(std::index_sequence<Is...>, node_iterator hint, const bucket_hash &hs, const std::tuple<Ks...> &ks, Args &&...args)
 		{
 			maybe_resize(hint);
 			maybe_rehash();
 
 			/* If a candidate was found, do nothing. Otherwise, emplace a new entry. */
-			const auto hs = bucket_hash{hash(std::get<Is>(ks))...};
-			const auto node_list = std::array{find_node<Is>(std::get<Is>(ks), hs[Is])...};
+			const auto node_list = std::array{find_conflict<Is>(std::get<Is>(ks), hs[Is])...};
 			for (auto [node, chain]: node_list)
-				if (chain && *chain != npos)
+				if (node != end_node())
 				{
 					/* Found a conflict, return the existing node. */
 					return {to_iter(node), false};
@@ -707,7 +1326,7 @@ namespace tpp::_detail
 
 			/* If a candidate was found, replace the entry. Otherwise, emplace a new entry. */
 			const auto h = hash(key);
-			if (const auto [candidate, chain_idx] = find_node<0>(key, h); chain_idx && *chain_idx == npos)
+			if (const auto [candidate, chain_idx] = find_node<0>(key, h); candidate == end_node())
 			{
 				return {emplace_node<0>(hint, {chain_idx}, {h},
 				                        std::piecewise_construct,
@@ -728,7 +1347,7 @@ namespace tpp::_detail
 			if (const auto end = end_node(); node == end)
 				return to_iter(end);
 
-			const auto slice = chain_slice{find_chain_ptr<Is...>(get_chain<Is>(node->template hash<Is>()), pos)...};
+			const auto slice = chain_slice{find_index<Is>(node->template hash<Is>(), pos)...};
 			return erase_node<Is...>(pos, node, slice);
 		}
 		iterator do_erase(size_type pos, bucket_node *node)
@@ -739,21 +1358,16 @@ namespace tpp::_detail
 		template<std::size_t J, typename T, std::size_t... Is>
 		iterator do_erase(std::index_sequence<Is...>, const T &key, std::size_t h)
 		{
-			for (auto *chain_idx = get_chain<J>(h); *chain_idx != npos;)
-			{
-				const auto pos = *chain_idx;
-				auto node = m_dense + pos;
-				if (node->template hash<J>() == h && cmp(key, node->template key<J>()))
-				{
-					/* Grab other bucket indices that point to `pos`. */
-					chain_slice slice = {};
-					((slice[Is] = find_chain_ptr<Is...>(get_chain<Is>(node->template hash<Is>()), pos)), ...);
-					slice[J] = chain_idx;
-					return erase_node<J, Is...>(pos, node, slice);
-				}
-				chain_idx = &node->next[J];
-			}
-			return end();
+			const auto [node, ref] = find_node<J>(key, h);
+			if (node == end_node())
+				return end();
+
+			/* Grab other bucket indices that point to `pos`. */
+			const auto pos = static_cast<size_type>(node - to_address(m_dense));
+			chain_slice slice = {};
+			((slice[Is] = find_index<Is>(node->template hash<Is>(), pos)), ...);
+			slice[J] = ref;
+			return erase_node<J, Is...>(pos, node, slice);
 		}
 		template<std::size_t J, typename T>
 		iterator do_erase(const T &key, std::size_t h)
@@ -761,25 +1375,92 @@ namespace tpp::_detail
 			return do_erase<J>(remove_index_t<J, std::make_index_sequence<key_size>>{}, key, h);
 		}
 
-		template<size_type... Is>
-		void do_rehash(std::index_sequence<Is...>, size_type new_cap)
+		size_type finish_erase_if(size_type new_size)
+		{
+			const auto result = std::exchange(m_dense_size, new_size) - new_size;
+
+			/* Index positions of the moved nodes are stale, rebuild the index once instead of patching it per node. */
+			if (result != 0) do_rehash(bucket_count());
+			return result;
+		}
+
+		void do_rehash(size_type new_cap)
 		{
 			/* Reallocate the sparse buffer. */
-			realloc_buffer(sparse_alloc(), m_sparse, m_sparse_size, new_cap);
-			std::fill_n(m_sparse, m_sparse_size, make_array<key_size>(npos));
+			realloc_sparse(static_cast<size_type>(bucket_policy::round_count(new_cap)));
 
 			/* Go through each entry & re-insert it. */
-			for (size_type i = 0; i < size(); ++i) (insert_node<Is>(m_dense[i], i), ...);
+			index_nodes(0);
 		}
-		void do_rehash(size_type new_cap) { do_rehash(std::make_index_sequence<key_size>{}, new_cap); }
 		void maybe_rehash()
 		{
 			TPP_IF_UNLIKELY(bucket_count() == 0)
 				rehash(8);
+			else if constexpr (is_open::value)
+			{
+				/* Open-addressed index must always have empty slots to terminate the probe, thus load factor is capped. */
+				const auto max_load = static_cast<float>(bucket_count()) * std::min(m_max_load_factor, initial_load_factor);
+				if (static_cast<float>(size() + m_num_deleted) >= max_load)
+				{
+					/* Purge deleted slots if the index is sparse enough. Otherwise, grow the index. */
+					if (static_cast<float>(size() * 2) < max_load)
+						do_rehash(bucket_count());
+					else
+						rehash(bucket_count() * 2);
+				}
+			}
 			else if (load_factor() >= m_max_load_factor)
 				rehash(bucket_count() * 2);
 		}
 
+		[[nodiscard]] meta_allocator meta_alloc() const { return meta_allocator{sparse_alloc()}; }
+		void free_sparse()
+		{
+			if constexpr (is_open::value)
+				if (m_meta)
+				{
+					auto alloc = meta_alloc();
+					std::allocator_traits<meta_allocator>::deallocate(alloc, std::exchange(m_meta, meta_ptr{}), meta_size() * key_size);
+				}
+			if (m_sparse) std::allocator_traits<sparse_allocator>::deallocate(sparse_alloc(), std::exchange(m_sparse, sparse_ptr{}), m_sparse_size);
+			m_sparse_size = 0;
+		}
+		void realloc_sparse(size_type n)
+		{
+			/* Bucket buffer is only ever grown. */
+			if (m_sparse_size < n)
+			{
+				free_sparse();
+				m_sparse = std::allocator_traits<sparse_allocator>::allocate(sparse_alloc(), n);
+				if constexpr (is_open::value)
+					try
+					{
+						auto alloc = meta_alloc();
+						m_meta = std::allocator_traits<meta_allocator>::allocate(alloc, (n + sizeof(meta_block) - 1) * key_size);
+					}
+					catch (...)
+					{
+						std::allocator_traits<sparse_allocator>::deallocate(sparse_alloc(), std::exchange(m_sparse, sparse_ptr{}), n);
+						throw;
+					}
+				m_sparse_size = n;
+			}
+			m_bucket_policy.set_count(m_sparse_size);
+			reset_sparse();
+		}
+		void reset_sparse()
+		{
+			TPP_IF_UNLIKELY(!m_sparse)
+				return;
+
+			std::fill_n(m_sparse, m_sparse_size, make_array<key_size, index_type>(npos));
+			if constexpr (is_open::value)
+			{
+				std::fill_n(m_meta, meta_size() * key_size, meta_byte::empty);
+				m_num_deleted = 0;
+			}
+		}
+
 		void resize_data(size_type capacity)
 		{
 			auto &alloc = dense_alloc();
@@ -820,33 +1501,37 @@ namespace tpp::_detail
 			}
 		}
 
-		template<std::size_t... Is>
-		void copy_data(std::index_sequence<Is...>, const dense_table &other)
+		void copy_data(const dense_table &other)
 		{
 			/* Expect that there is no data in the buffers, but the buffers might still exist. */
 			TPP_ASSERT(size() == 0, "Table must be empty prior to copying elements");
+			m_lazy = other.m_lazy;
 
 			/* Ignore empty tables. */
 			TPP_IF_UNLIKELY(other.size() == 0)
 			{
 				m_dense_size = 0;
+				reset_sparse();
 				return;
 			}
 
 			/* (re)allocate the bucket & element buffers if needed. */
-			realloc_buffer(sparse_alloc(), m_sparse, m_sparse_size, other.m_sparse_size);
+			realloc_sparse(other.m_sparse_size);
 			realloc_buffer(dense_alloc(), m_dense, m_dense_capacity, other.m_dense_size);
-			std::fill_n(m_sparse, m_sparse_size, make_array<key_size>(npos));
 
-			/* Copy & insert elements from the other table. */
+			/* Copy elements from the other table, then insert them into the index. If a copy fails, the already copied elements are kept. */
 			auto alloc = allocator_type{dense_alloc()};
-			for (; m_dense_size < other.size(); ++m_dense_size)
+			try
+			{
+				for (; m_dense_size < other.size(); ++m_dense_size)
+					m_dense[m_dense_size].construct(alloc, other.m_dense[m_dense_size]);
+			}
+			catch (...)
 			{
-				auto &from = other.m_dense[m_dense_size];
-				auto &to = m_dense[m_dense_size];
-				to.construct(alloc, from);
-				(insert_node<Is>(to, m_dense_size), ...);
+				index_nodes(0);
+				throw;
 			}
+			index_nodes(0);
 
 			/* If the node link is ordered, update header offsets to point to the copied data. */
 			if constexpr (is_ordered::value)
@@ -857,38 +1542,39 @@ namespace tpp::_detail
 					header_link()->link(to_address(m_dense + front_off), to_address(m_dense + back_off));
 				}
 		}
-		template<std::size_t... Is>
-		void move_data(std::index_sequence<Is...>, dense_table &other)
+		void move_data(dense_table &other)
 		{
 			/* Expect that there is no data in the buffers, but the buffers might still exist. */
 			TPP_ASSERT(size() == 0, "Table must be empty prior to moving elements");
+			m_lazy = other.m_lazy;
 
 			/* Ignore empty tables. */
 			TPP_IF_UNLIKELY(other.size() == 0)
 			{
 				m_dense_size = 0;
+				reset_sparse();
 				return;
 			}
 
 			/* (re)allocate the bucket & element buffers if needed. */
-			realloc_buffer(sparse_alloc(), m_sparse, m_sparse_size, other.m_sparse_size);
+			realloc_sparse(other.m_sparse_size);
 			realloc_buffer(dense_alloc(), m_dense, m_dense_capacity, other.m_dense_size);
-			std::fill_n(m_sparse, m_sparse_size, make_array<key_size>(npos));
 
-			/* Move & insert elements from the other table. */
+			/* Move elements from the other table, then insert them into the index. */
 			auto alloc = allocator_type{dense_alloc()};
-			for (; m_dense_size < other.size(); ++m_dense_size)
+			try
+			{
+				for (; m_dense_size < other.size(); ++m_dense_size)
+					m_dense[m_dense_size].relocate(alloc, alloc, other.m_dense[m_dense_size]);
+			}
+			catch (...)
 			{
-				auto &from = other.m_dense[m_dense_size];
-				auto &to = m_dense[m_dense_size];
-				to.relocate(alloc, alloc, from);
-				(insert_node<Is>(to, m_dense_size), ...);
+				index_nodes(0);
+				throw;
 			}
+			index_nodes(0);
 			other.m_dense_size = 0;
 		}
-
-		void copy_data(const dense_table &other) { copy_data(std::make_index_sequence<key_size>{}, other); }
-		void move_data(dense_table &other) { move_data(std::make_index_sequence<key_size>{}, other); }
 		void swap_buffers(dense_table &other)
 		{
 			using std::swap;
@@ -897,6 +1583,10 @@ namespace tpp::_detail
 			swap(m_sparse_size, other.m_sparse_size);
 			swap(m_sparse, other.m_sparse);
 			swap(m_dense, other.m_dense);
+			swap(m_bucket_policy, other.m_bucket_policy);
+			swap(m_num_deleted, other.m_num_deleted);
+			swap(m_meta, other.m_meta);
+			swap(m_lazy, other.m_lazy);
 		}
 		void clear_data()
 		{
@@ -919,6 +1609,12 @@ namespace tpp::_detail
 		sparse_ptr m_sparse = {};
 		dense_ptr m_dense = {};
 
+		meta_ptr m_meta = {}; /* Tags of the open-addressed index (one array per key). */
+		size_type m_num_deleted = 0; /* Amount of deleted slots in the open-addressed index. */
+
+		std::size_t m_lazy = lazy_mask; /* Bit mask of lazy keys, indices of which are not yet built. */
+
+		bucket_policy m_bucket_policy = {}; /* Maps hashes to bucket chains of the sparse buffer. */
 		float m_max_load_factor = initial_load_factor;
 	};
 }
@@ -0,0 +1,125 @@
+/*
+ * Created by switchblade on 2023-01-21.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "utility.hpp"
+
+namespace tpp::_detail
+{
+	/* Process-wide epoch-based reclamation domain.
+	 *
+	 * Readers "pin" the domain for the duration of a read, announcing the epoch they have observed. Writers unlink shared
+	 * objects, call `retire_epoch` to obtain the epoch of the object's retirement, and may destroy the object once
+	 * `min_active` is greater than that epoch, as every reader that can still reference the object has left by then.
+	 *
+	 * Pinning and unpinning is wait-free, with the exception of the first pin of every thread, which registers a
+	 * thread record within the domain. Thread records are never freed and are reused once their thread exits. */
+	class epoch_domain
+	{
+		struct alignas(cache_line_size) record
+		{
+			std::atomic<std::uint64_t> epoch = 0;
+			std::atomic<bool> in_use = true;
+			record *next = nullptr;
+			std::size_t depth = 0;
+		};
+		struct thread_record
+		{
+			~thread_record()
+			{
+				if (!ptr) return;
+				ptr->epoch.store(0, std::memory_order_release);
+				ptr->in_use.store(false, std::memory_order_release);
+			}
+
+			record *ptr = nullptr;
+		};
+
+	public:
+		class guard
+		{
+			friend class epoch_domain;
+
+			explicit guard(record *rec) noexcept : m_rec(rec) {}
+
+		public:
+			guard(const guard &) = delete;
+			guard &operator=(const guard &) = delete;
+
+			~guard()
+			{
+				if (--m_rec->depth == 0)
+					m_rec->epoch.store(0, std::memory_order_release);
+			}
+
+		private:
+			record *m_rec;
+		};
+
+	public:
+		[[nodiscard]] static epoch_domain &instance() noexcept
+		{
+			static epoch_domain domain;
+			return domain;
+		}
+
+		/* Pins the calling thread to the current epoch until the returned guard is destroyed. Guards may be nested. */
+		[[nodiscard]] guard pin()
+		{
+			auto *rec = local_record();
+			if (rec->depth++ == 0)
+			{
+				rec->epoch.store(m_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+				/* Make sure the announcement is visible before any of the shared state is read. Pairs with the fence in `min_active`. */
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+			}
+			return guard{rec};
+		}
+
+		/* Advances the global epoch and returns the epoch an object unlinked before the call is retired at. */
+		std::uint64_t retire_epoch() noexcept { return m_epoch.fetch_add(1, std::memory_order_acq_rel); }
+		/* Returns the smallest epoch announced by currently pinned threads. Objects retired at epochs less than the result can be destroyed. */
+		[[nodiscard]] std::uint64_t min_active() const noexcept
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			auto result = m_epoch.load(std::memory_order_acquire);
+			for (auto *rec = m_records.load(std::memory_order_acquire); rec; rec = rec->next)
+				if (const auto epoch = rec->epoch.load(std::memory_order_acquire); epoch != 0)
+					result = std::min(result, epoch);
+			return result;
+		}
+
+	private:
+		epoch_domain() noexcept = default;
+
+		[[nodiscard]] record *local_record()
+		{
+			static thread_local thread_record local;
+			TPP_IF_UNLIKELY(!local.ptr) local.ptr = acquire_record();
+			return local.ptr;
+		}
+		[[nodiscard]] record *acquire_record()
+		{
+			/* Try to reuse a record of an exited thread first. */
+			for (auto *rec = m_records.load(std::memory_order_acquire); rec; rec = rec->next)
+				if (bool expected = false; !rec->in_use.load(std::memory_order_relaxed) && rec->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+					return rec;
+
+			auto *rec = new record();
+			rec->next = m_records.load(std::memory_order_relaxed);
+			while (!m_records.compare_exchange_weak(rec->next, rec, std::memory_order_release, std::memory_order_relaxed));
+			return rec;
+		}
+
+		/* Epoch 0 is reserved for unpinned records. */
+		std::atomic<std::uint64_t> m_epoch = 1;
+		std::atomic<record *> m_records = nullptr;
+	};
+}
@@ -0,0 +1,115 @@
+/*
+ * Created by switchblade on 2023-01-23.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+#include "utility.hpp"
+
+namespace tpp
+{
+	/** @brief Executor that runs bulk tasks on `std::thread` workers spawned for the duration of every call.
+	 *
+	 * Parallel algorithms of the library accept any executor type with the same interface as `thread_executor`:
+	 * <ul>
+	 * <li>`concurrency()` returns the amount of tasks that may run in parallel.</li>
+	 * <li>`bulk(n, f)` invokes `f(i)` for every `i` in `[0, n)` (potentially in parallel) and returns once all invocations
+	 * are complete. Every task must be executed even if some of the tasks throw, in which case one of the thrown exceptions
+	 * is re-thrown from `bulk`.</li>
+	 * </ul>
+	 * This allows parallel operations to be plugged into an external task scheduler. */
+	class thread_executor
+	{
+	public:
+		/** Initializes an executor using `threads` worker threads. If `threads` is 0, uses `std::thread::hardware_concurrency()` threads. */
+		constexpr explicit thread_executor(std::size_t threads = 0) noexcept : m_threads(threads) {}
+
+		/** Returns the amount of worker threads used by the executor. */
+		[[nodiscard]] std::size_t concurrency() const noexcept
+		{
+			if (m_threads != 0) return m_threads;
+			return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+		}
+
+		/** Invokes `f(i)` for every `i` in `[0, n)` using up to `concurrency()` threads, including the calling thread.
+		 * If a worker thread cannot be started, it's tasks are executed by the remaining threads. */
+		template<typename F>
+		void bulk(std::size_t n, F &&f) const
+		{
+			std::atomic<std::size_t> next = 0;
+			std::exception_ptr error;
+			std::mutex error_mtx;
+
+			const auto work = [&]()
+			{
+				for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;)
+					try { f(i); }
+					catch (...)
+					{
+						const std::lock_guard lock{error_mtx};
+						if (!error) error = std::current_exception();
+					}
+			};
+
+			std::vector<std::thread> workers;
+			try
+			{
+				const auto count = std::min(concurrency(), n);
+				workers.reserve(count ? count - 1 : 0);
+				for (std::size_t i = 1; i < count; ++i) workers.emplace_back(work);
+			}
+			catch (...) { /* Remaining tasks are executed by the already started threads. */ }
+
+			work();
+			for (auto &worker: workers) worker.join();
+			if (error) std::rethrow_exception(error);
+		}
+
+	private:
+		std::size_t m_threads;
+	};
+
+	/** Default parallel executor, using `std::thread::hardware_concurrency()` threads. */
+	inline constexpr thread_executor par = thread_executor{};
+
+	/** @brief Pair of iterators denoting a sub-range of a container, as returned by `split`. */
+	template<typename I>
+	class iterator_range
+	{
+	public:
+		using iterator = I;
+
+	public:
+		constexpr iterator_range() = default;
+		constexpr iterator_range(I first, I last) noexcept(std::is_nothrow_move_constructible_v<I>) : m_first(std::move(first)), m_last(std::move(last)) {}
+
+		/** Returns iterator to the first element of the sub-range. */
+		[[nodiscard]] constexpr I begin() const noexcept(std::is_nothrow_copy_constructible_v<I>) { return m_first; }
+		/** Returns iterator one past the last element of the sub-range. */
+		[[nodiscard]] constexpr I end() const noexcept(std::is_nothrow_copy_constructible_v<I>) { return m_last; }
+		/** Checks if the sub-range is empty. */
+		[[nodiscard]] constexpr bool empty() const { return m_first == m_last; }
+
+	private:
+		I m_first = {};
+		I m_last = {};
+	};
+
+	namespace _detail
+	{
+		template<typename E, typename = void>
+		struct is_executor : std::false_type {};
+		template<typename E>
+		struct is_executor<E, std::void_t<decltype(std::declval<const E &>().concurrency()), decltype(std::declval<const E &>().bulk(std::size_t{}, std::declval<void (*)(std::size_t)>()))>> : std::true_type {};
+
+		template<typename E>
+		inline constexpr bool is_executor_v = is_executor<E>::value;
+	}
+}
@@ -0,0 +1,457 @@
+/*
+ * Created by switchblade on 2023-01-28.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <vector>
+#include <limits>
+#include <new>
+
+#include "table_common.hpp"
+#include "meta_block.hpp"
+#include "snapshot.hpp"
+
+namespace tpp::_detail
+{
+	template<typename C, typename = void>
+	struct has_mapped_type : std::false_type {};
+	template<typename C>
+	struct has_mapped_type<C, std::void_t<typename C::mapped_type>> : std::true_type {};
+
+	/* Read-only table indexed by a PTHash-style perfect hash function. Keys are split into buckets, and every bucket is assigned
+	 * a "pilot" value, chosen so that positions of all keys of the bucket (computed from the key hash & the pilot) are free.
+	 * Lookup is thus a single access to the pilot array followed by a single access & compare of the element slot.
+	 * See <a href="https://arxiv.org/abs/2104.10402">PTHash: Revisiting FCH Minimal Perfect Hashing</a> for details.
+	 *
+	 * Slot array is slightly larger than the amount of elements, which greatly reduces the time needed to find pilots.
+	 * Unused slots contain copies of an existing element, which is never found at their position, and are skipped by iterators. */
+	template<typename V, typename K, typename Kh, typename Kc, typename Alloc, typename ValueTraits>
+	class frozen_table : empty_base<Kh>, empty_base<Kc>
+	{
+		using hash_base = empty_base<Kh>;
+		using cmp_base = empty_base<Kc>;
+
+		template<typename T>
+		using rebind_vector = std::vector<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T>>;
+
+	public:
+		using value_type = V;
+		using key_type = K;
+
+		using hasher = Kh;
+		using key_equal = Kc;
+		using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<V>;
+
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		class const_iterator
+		{
+			friend class frozen_table;
+
+		public:
+			using value_type = typename frozen_table::value_type;
+			using reference = const value_type &;
+			using pointer = const value_type *;
+			using size_type = typename frozen_table::size_type;
+			using difference_type = typename frozen_table::difference_type;
+			using iterator_category = std::forward_iterator_tag;
+
+		private:
+			constexpr const_iterator(const frozen_table *table, size_type pos) noexcept : m_table(table), m_pos(pos) {}
+
+		public:
+			constexpr const_iterator() noexcept = default;
+
+			const_iterator operator++(int) noexcept
+			{
+				auto tmp = *this;
+				++(*this);
+				return tmp;
+			}
+			const_iterator &operator++() noexcept
+			{
+				m_pos = m_table->next_occupied(m_pos + 1);
+				return *this;
+			}
+
+			[[nodiscard]] constexpr pointer operator->() const noexcept { return m_table->m_slots.data() + m_pos; }
+			[[nodiscard]] constexpr reference operator*() const noexcept { return *operator->(); }
+
+			[[nodiscard]] constexpr bool operator==(const const_iterator &other) const noexcept { return m_pos == other.m_pos; }
+#if (__cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L))
+			[[nodiscard]] constexpr bool operator!=(const const_iterator &other) const noexcept { return m_pos != other.m_pos; }
+#endif
+
+		private:
+			const frozen_table *m_table = nullptr;
+			size_type m_pos = 0;
+		};
+
+	private:
+		/* Average amount of keys per bucket. Pilot array thus requires ~8 bits per key. */
+		constexpr static size_type bucket_load = 4;
+		/* Amount of keys per unused slot. */
+		constexpr static size_type slot_slack = 64;
+		/* Amount of pilots tried for a bucket before the table is re-built using a different seed. */
+		constexpr static std::uint64_t max_pilot = 1 << 20;
+		constexpr static std::size_t max_seeds = 16;
+
+		/* Skewed bucket assignment (60% of the keys are placed into 30% of the buckets) reduces the search time for pilots,
+		 * since the largest buckets are placed while most of the slots are still available. */
+		constexpr static std::uint64_t dense_keys = 0x9999'999a; /* 0.6 * 2^32 */
+
+		[[nodiscard]] constexpr static std::uint64_t mix(std::uint64_t x) noexcept
+		{
+			x ^= x >> 33;
+			x *= 0xff51'afd7'ed55'8ccdull;
+			x ^= x >> 33;
+			x *= 0xc4ce'b9fe'1a85'ec53ull;
+			x ^= x >> 33;
+			return x;
+		}
+		[[nodiscard]] constexpr static size_type reduce32(std::uint64_t h, std::uint64_t n) noexcept { return static_cast<size_type>(((h >> 32) * n) >> 32); }
+
+	public:
+		frozen_table() = default;
+		frozen_table(const Kh &hash, const Kc &cmp, const allocator_type &alloc)
+				: hash_base(hash), cmp_base(cmp), m_slots(alloc), m_pilots(alloc), m_occupied(alloc) {}
+
+		template<typename Iter>
+		frozen_table(Iter first, Iter last, const Kh &hash, const Kc &cmp, const allocator_type &alloc) : frozen_table(hash, cmp, alloc)
+		{
+			rebind_vector<value_type> values(alloc);
+			values.reserve(distance_or_n(first, last, size_type{0}));
+			for (; first != last; ++first) values.push_back(ValueTraits::make_value(*first));
+			build(values);
+		}
+
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator{this, next_occupied(0)}; }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator{this, m_slots.size()}; }
+
+		[[nodiscard]] constexpr size_type size() const noexcept { return m_size; }
+		[[nodiscard]] size_type bucket_count() const noexcept { return m_slots.size(); }
+		/* Total size of the slot, pilot & occupancy arrays. */
+		[[nodiscard]] size_type memory_usage() const noexcept
+		{
+			return m_slots.size() * sizeof(value_type) + m_pilots.size() * sizeof(std::uint32_t) + m_occupied.size() * sizeof(std::uint64_t);
+		}
+
+		template<typename T>
+		[[nodiscard]] const_iterator find(const T &key) const { return const_iterator{this, find_slot(key)}; }
+		template<typename T>
+		[[nodiscard]] bool contains(const T &key) const { return find_slot(key) != m_slots.size(); }
+
+		template<typename S>
+		void save(S &os) const
+		{
+			assert_snapshot();
+
+			const auto header = snapshot_header_for(m_slots.size(), m_size, m_pilots.size(), m_seed);
+			const auto layout = frozen_snapshot_layout{m_slots.size(), sizeof(value_type), alignof(value_type), m_pilots.size()};
+			snapshot_write(os, &header, sizeof(header));
+			snapshot_write(os, m_pilots.data(), m_pilots.size() * sizeof(std::uint32_t));
+			snapshot_write_zeros(os, layout.occupied_offset - layout.pilots_offset - m_pilots.size() * sizeof(std::uint32_t));
+			snapshot_write(os, m_occupied.data(), m_occupied.size() * sizeof(std::uint64_t));
+			snapshot_write_zeros(os, layout.slots_offset - layout.occupied_offset - m_occupied.size() * sizeof(std::uint64_t));
+			snapshot_write(os, m_slots.data(), m_slots.size() * sizeof(value_type));
+		}
+		template<typename S>
+		void load(S &is)
+		{
+			assert_snapshot();
+
+			snapshot_header header;
+			snapshot_read(is, &header, sizeof(header));
+			header.validate(snapshot_header_for(0, 0, 0, 0));
+			if (header.flags != 0 || header.size > std::numeric_limits<size_type>::max() / sizeof(value_type) / 2 ||
+			    header.capacity != slots_for(static_cast<size_type>(header.size)) || header.extra[0] != buckets_for(static_cast<size_type>(header.size)))
+				throw snapshot_error("Invalid table snapshot");
+
+			/* Read the snapshot into a separate table, so that the table is left unchanged on failure. */
+			auto tmp = frozen_table{hash_base::value(), cmp_base::value(), m_slots.get_allocator()};
+			const auto capacity = static_cast<size_type>(header.capacity);
+			const auto layout = frozen_snapshot_layout{capacity, sizeof(value_type), alignof(value_type), header.extra[0]};
+			tmp.m_size = static_cast<size_type>(header.size);
+			tmp.m_seed = header.extra[1];
+			tmp.m_pilots.resize(static_cast<size_type>(header.extra[0]));
+			tmp.m_occupied.resize(occupied_words(capacity));
+			snapshot_skip(is, layout.pilots_offset - sizeof(header));
+			snapshot_read(is, tmp.m_pilots.data(), tmp.m_pilots.size() * sizeof(std::uint32_t));
+			snapshot_skip(is, layout.occupied_offset - layout.pilots_offset - tmp.m_pilots.size() * sizeof(std::uint32_t));
+			snapshot_read(is, tmp.m_occupied.data(), tmp.m_occupied.size() * sizeof(std::uint64_t));
+			snapshot_skip(is, layout.slots_offset - layout.occupied_offset - tmp.m_occupied.size() * sizeof(std::uint64_t));
+
+			/* Elements are read one by one, as the slot array can not be resized without constructing the elements. */
+			tmp.m_slots.reserve(capacity);
+			for (size_type i = 0; i < capacity; ++i)
+			{
+				alignas(value_type) unsigned char storage[sizeof(value_type)];
+				snapshot_read(is, storage, sizeof(value_type));
+				tmp.m_slots.push_back(*std::launder(reinterpret_cast<const value_type *>(storage)));
+			}
+			tmp.verify_snapshot();
+			swap(tmp);
+		}
+
+		[[nodiscard]] allocator_type get_allocator() const { return m_slots.get_allocator(); }
+		[[nodiscard]] const Kh &get_hash() const noexcept { return hash_base::value(); }
+		[[nodiscard]] const Kc &get_cmp() const noexcept { return cmp_base::value(); }
+
+		void swap(frozen_table &other) noexcept(std::is_nothrow_swappable_v<Kh> && std::is_nothrow_swappable_v<Kc>)
+		{
+			using std::swap;
+			hash_base::swap(other);
+			cmp_base::swap(other);
+			swap(m_slots, other.m_slots);
+			swap(m_pilots, other.m_pilots);
+			swap(m_occupied, other.m_occupied);
+			swap(m_dense_buckets, other.m_dense_buckets);
+			swap(m_size, other.m_size);
+			swap(m_seed, other.m_seed);
+		}
+
+	private:
+		template<typename T>
+		[[nodiscard]] std::uint64_t hash(const T &key) const { return mix(static_cast<std::uint64_t>(get_hash()(key)) ^ m_seed); }
+		[[nodiscard]] size_type bucket(std::uint64_t h, size_type buckets) const noexcept
+		{
+			if ((h & 0xffff'ffff) < dense_keys)
+				return reduce32(h, m_dense_buckets);
+			else
+				return m_dense_buckets + reduce32(h, buckets - m_dense_buckets);
+		}
+		/* Pilot hash does not depend on the key, and is thus computed once per pilot during search. Multiplication after
+		 * the XOR makes the position depend on all bits of the key hash (not only those used to select the bucket), and
+		 * prevents different pilots from simply permuting the slots when their amount is a power of 2. */
+		[[nodiscard]] static size_type position(std::uint64_t h, std::uint64_t pilot_hash, size_type slots) noexcept
+		{
+			return static_cast<size_type>(mul_hi<std::uint64_t>((h ^ pilot_hash) * 0x9e37'79b9'7f4a'7c15ull, slots));
+		}
+		void init_dense_buckets(size_type buckets) noexcept
+		{
+			/* Small tables may not have dense buckets, in which case all keys are assigned to the remaining buckets. */
+			m_dense_buckets = buckets * 3 / 10;
+		}
+
+		template<typename T>
+		[[nodiscard]] size_type find_slot(const T &key) const
+		{
+			TPP_IF_LIKELY(m_size != 0)
+			{
+				const auto h = hash(key);
+				const auto pos = position(h, mix(m_pilots[bucket(h, m_pilots.size())]), m_slots.size());
+				TPP_IF_LIKELY(get_cmp()(ValueTraits::get_key(m_slots[pos]), key))
+					return pos;
+			}
+			return m_slots.size();
+		}
+
+		[[nodiscard]] constexpr static size_type slots_for(size_type n) noexcept { return n == 0 ? 0 : n + n / slot_slack + 1; }
+		[[nodiscard]] constexpr static size_type buckets_for(size_type n) noexcept { return n == 0 ? 0 : n / bucket_load + 1; }
+		[[nodiscard]] static size_type occupied_words(size_type capacity) noexcept { return (capacity + 63) / 64; }
+		[[nodiscard]] bool is_occupied(size_type pos) const noexcept { return (m_occupied[pos / 64] >> (pos % 64)) & 1; }
+		[[nodiscard]] size_type next_occupied(size_type pos) const noexcept
+		{
+			for (auto word = pos / 64; word < m_occupied.size(); pos = ++word * 64)
+				if (const auto bits = m_occupied[word] >> (pos % 64); bits != 0)
+					return pos + ctz(bits);
+			return m_slots.size();
+		}
+
+		template<typename Vec>
+		void build(Vec &values)
+		{
+			std::vector<std::uint64_t> hashes(values.size());
+			for (std::size_t attempt = 0;; ++attempt)
+			{
+				/* Attempts to place all keys using the current seed. Key hashes must be unique, so duplicate keys are removed. */
+				for (size_type i = 0; i < values.size(); ++i) hashes[i] = hash(ValueTraits::get_key(values[i]));
+				remove_duplicates(values, hashes);
+				if (values.empty()) return;
+
+				if (auto [positions, slots] = find_pilots(hashes); !positions.empty())
+				{
+					fill_slots(values, positions, slots);
+					return;
+				}
+				if (attempt == max_seeds)
+					throw std::runtime_error("Failed to build a perfect hash function");
+				m_seed = mix(m_seed + 0x9e37'79b9'7f4a'7c15ull);
+			}
+		}
+		template<typename Vec>
+		void remove_duplicates(Vec &values, std::vector<std::uint64_t> &hashes)
+		{
+			/* Hashes are sorted together with element indices, to avoid random access during the sort. */
+			std::vector<std::pair<std::uint64_t, size_type>> order(values.size());
+			for (size_type i = 0; i < order.size(); ++i) order[i] = {hashes[i], i};
+			std::sort(order.begin(), order.end());
+
+			/* If multiple elements have equal keys, the first one is kept. Hashes of different keys can not be equal, as that
+			 * would require the key hashes to collide. */
+			std::vector<bool> removed(values.size());
+			bool any_removed = false;
+			for (size_type i = 1; i < order.size(); ++i)
+				if (order[i].first == order[i - 1].first)
+				{
+					/* Elements with equal hashes are ordered by index, so the first element of the run is kept. */
+					const auto kept = order[i - 1].second, dup = order[i].second;
+					if (!get_cmp()(ValueTraits::get_key(values[kept]), ValueTraits::get_key(values[dup])))
+						throw std::invalid_argument("Keys of a frozen table must have unique hashes");
+					removed[dup] = any_removed = true;
+					order[i].second = kept;
+				}
+			if (!any_removed) return;
+
+			size_type n = 0;
+			for (size_type i = 0; i < values.size(); ++i)
+				if (!removed[i])
+				{
+					if (n != i)
+					{
+						using std::swap;
+						swap(values[n], values[i]);
+					}
+					hashes[n++] = hashes[i];
+				}
+			values.erase(values.begin() + static_cast<difference_type>(n), values.end());
+			hashes.resize(n);
+		}
+		/* Returns positions of the elements & size of the slot array, or an empty vector if pilots could not be found for the current seed. */
+		[[nodiscard]] std::pair<std::vector<size_type>, size_type> find_pilots(const std::vector<std::uint64_t> &hashes)
+		{
+			const auto n = hashes.size();
+			const auto buckets = buckets_for(n);
+			if (buckets > std::numeric_limits<std::uint32_t>::max())
+				throw std::length_error("Frozen table size exceeds the maximum");
+
+			m_slots.clear();
+			m_size = 0;
+			m_pilots.assign(buckets, 0);
+			init_dense_buckets(buckets);
+			const auto slots = slots_for(n);
+
+			/* Sort keys by bucket, and buckets by size (largest first). */
+			std::vector<size_type> bucket_of(n), offsets(buckets + 1), keys(n);
+			std::vector<std::uint64_t> bucket_hashes(n);
+			for (size_type i = 0; i < n; ++i) ++offsets[(bucket_of[i] = bucket(hashes[i], buckets)) + 1];
+			for (size_type i = 0; i < buckets; ++i) offsets[i + 1] += offsets[i];
+			{
+				/* Hashes are stored by bucket, so that pilot search does not access them at random. */
+				auto fill = offsets;
+				for (size_type i = 0; i < n; ++i)
+				{
+					const auto j = fill[bucket_of[i]]++;
+					bucket_hashes[j] = hashes[i];
+					keys[j] = i;
+				}
+			}
+			std::vector<size_type> order(buckets);
+			for (size_type i = 0; i < buckets; ++i) order[i] = i;
+			std::stable_sort(order.begin(), order.end(), [&](size_type a, size_type b) { return offsets[a + 1] - offsets[a] > offsets[b + 1] - offsets[b]; });
+
+			std::vector<size_type> positions(n);
+			std::vector<bool> taken(slots);
+			std::vector<size_type> candidates;
+			for (const auto b: order)
+			{
+				const auto first = offsets[b], last = offsets[b + 1];
+				if (first == last) break;
+
+				for (std::uint64_t pilot = 0;; ++pilot)
+				{
+					if (pilot == max_pilot) return {};
+
+					/* Positions must be free, and distinct within the bucket. */
+					const auto pilot_hash = mix(pilot);
+					candidates.clear();
+					for (auto i = first; i < last; ++i)
+					{
+						const auto pos = position(bucket_hashes[i], pilot_hash, slots);
+						if (taken[pos] || std::find(candidates.begin(), candidates.end(), pos) != candidates.end()) break;
+						candidates.push_back(pos);
+					}
+					if (candidates.size() != last - first) continue;
+
+					for (auto i = first; i < last; ++i)
+					{
+						taken[candidates[i - first]] = true;
+						positions[keys[i]] = candidates[i - first];
+					}
+					m_pilots[b] = static_cast<std::uint32_t>(pilot);
+					break;
+				}
+			}
+			return {std::move(positions), slots};
+		}
+		template<typename Vec>
+		void fill_slots(Vec &values, const std::vector<size_type> &positions, size_type slots)
+		{
+			/* Element at each slot, or the first element for unused slots. */
+			std::vector<size_type> source(slots, 0);
+			m_occupied.assign(occupied_words(slots), 0);
+			for (size_type i = 0; i < positions.size(); ++i)
+			{
+				source[positions[i]] = i;
+				m_occupied[positions[i] / 64] |= std::uint64_t{1} << (positions[i] % 64);
+			}
+
+			m_slots.reserve(slots);
+			for (size_type pos = 0; pos < slots; ++pos)
+			{
+				if (is_occupied(pos) && source[pos] != 0)
+					m_slots.push_back(std::move(values[source[pos]]));
+				else
+					m_slots.push_back(values[source[pos]]);
+			}
+			m_size = values.size();
+		}
+
+		/* Snapshots contain the pilot array, the occupancy bitmap & raw elements. Unused slots are saved as-is. */
+		constexpr static void assert_snapshot() noexcept
+		{
+			static_assert(is_snapshot_compatible<V>::value, "Snapshots require trivially copyable elements");
+		}
+		[[nodiscard]] snapshot_header snapshot_header_for(size_type capacity, size_type size, size_type buckets, std::uint64_t seed) const
+		{
+			snapshot_header result;
+			result.kind = static_cast<std::uint32_t>(snapshot_kind::frozen);
+			result.node_size = sizeof(value_type);
+			result.node_align = alignof(value_type);
+			result.capacity = capacity;
+			result.size = size;
+			result.extra[0] = buckets;
+			result.extra[1] = seed;
+			result.fingerprint = snapshot_fingerprint<key_type>(get_hash());
+			return result;
+		}
+		/* Checks that the amount of occupied slots matches the size, and that all elements are found at their slots.
+		 * This only requires hashing of the elements, and is much cheaper than building the hash function. */
+		void verify_snapshot()
+		{
+			init_dense_buckets(m_pilots.size());
+
+			size_type occupied = 0;
+			for (auto word: m_occupied)
+				for (; word != 0; word &= word - 1) ++occupied;
+			if (occupied != m_size || (m_slots.size() % 64 != 0 && !m_occupied.empty() && (m_occupied.back() >> (m_slots.size() % 64)) != 0))
+				throw snapshot_error("Invalid table snapshot");
+
+			for (auto pos = next_occupied(0); pos != m_slots.size(); pos = next_occupied(pos + 1))
+				if (find_slot(ValueTraits::get_key(m_slots[pos])) != pos)
+					throw snapshot_error("Table snapshot hash function mismatch");
+		}
+
+		rebind_vector<value_type> m_slots;
+		rebind_vector<std::uint32_t> m_pilots;
+		rebind_vector<std::uint64_t> m_occupied;
+		size_type m_dense_buckets = 0; /* Amount of buckets used by the dense 60% of the keys. */
+		size_type m_size = 0;
+		std::uint64_t m_seed = 0;
+	};
+}
@@ -0,0 +1,128 @@
+/*
+ * Created by switchblade on 2023-01-26.
+ */
+
+#pragma once
+
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace tpp::_detail
+{
+	/* Read-only shared memory mapping of an entire file. Pages of the mapping are shared with other processes mapping the same file. */
+	class mapped_file
+	{
+	public:
+		constexpr mapped_file() noexcept = default;
+		explicit mapped_file(const char *path)
+		{
+#ifdef _WIN32
+			const auto file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) throw_last_error("Failed to open mapped file");
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size))
+			{
+				CloseHandle(file);
+				throw_last_error("Failed to open mapped file");
+			}
+			m_size = static_cast<std::size_t>(size.QuadPart);
+			if (m_size == 0)
+			{
+				CloseHandle(file);
+				return;
+			}
+
+			const auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+			if (mapping == nullptr) throw_last_error("Failed to map file");
+
+			m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			if (m_data == nullptr) throw_last_error("Failed to map file");
+#else
+			const auto fd = ::open(path, O_RDONLY | O_CLOEXEC);
+			if (fd < 0) throw_last_error("Failed to open mapped file");
+
+			struct stat st = {};
+			if (::fstat(fd, &st) != 0)
+			{
+				const auto err = errno;
+				::close(fd);
+				throw std::system_error(err, std::generic_category(), "Failed to open mapped file");
+			}
+			m_size = static_cast<std::size_t>(st.st_size);
+			if (m_size == 0)
+			{
+				::close(fd);
+				return;
+			}
+
+			/* The mapping keeps a reference to the file, so the descriptor can be closed right away. */
+			const auto data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+			const auto err = errno;
+			::close(fd);
+			if (data == MAP_FAILED) throw std::system_error(err, std::generic_category(), "Failed to map file");
+			m_data = data;
+#endif
+		}
+
+		mapped_file(const mapped_file &) = delete;
+		mapped_file &operator=(const mapped_file &) = delete;
+
+		mapped_file(mapped_file &&other) noexcept { swap(other); }
+		mapped_file &operator=(mapped_file &&other) noexcept
+		{
+			swap(other);
+			return *this;
+		}
+
+		~mapped_file()
+		{
+			if (m_data == nullptr) return;
+#ifdef _WIN32
+			UnmapViewOfFile(m_data);
+#else
+			::munmap(m_data, m_size);
+#endif
+		}
+
+		[[nodiscard]] constexpr const void *data() const noexcept { return m_data; }
+		[[nodiscard]] constexpr std::size_t size() const noexcept { return m_size; }
+
+		void swap(mapped_file &other) noexcept
+		{
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+		}
+
+	private:
+		[[noreturn]] static void throw_last_error(const char *msg)
+		{
+#ifdef _WIN32
+			throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), msg);
+#else
+			throw std::system_error(errno, std::generic_category(), msg);
+#endif
+		}
+
+		void *m_data = nullptr;
+		std::size_t m_size = 0;
+	};
+}
@@ -0,0 +1,375 @@
+/*
+ * Created by switchblade on 2023-01-15.
+ */
+
+#pragma once
+
+#include <utility>
+#include <atomic>
+#include <limits>
+
+#include "utility.hpp"
+
+#if defined(TPP_HAS_SSSE3)
+#include <tmmintrin.h>
+#elif defined(TPP_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+#ifdef TPP_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+#pragma intrinsic(_BitScanForward, _BitScanReverse)
+#ifdef _WIN64
+#pragma intrinsic(_BitScanForward64, _BitScanReverse64)
+#endif
+#endif
+
+namespace tpp::_detail
+{
+	enum class meta_byte : std::int8_t
+	{
+		empty = static_cast<std::int8_t>(0b1000'0000),
+		deleted = static_cast<std::int8_t>(0b1111'1110),
+		sentinel = static_cast<std::int8_t>(0b1111'1111),
+	};
+
+	[[nodiscard]] constexpr bool is_occupied(meta_byte v) noexcept { return v > meta_byte::sentinel; }
+	[[nodiscard]] constexpr bool is_available(meta_byte v) noexcept { return v < meta_byte::sentinel; }
+
+	template<typename T, std::size_t P>
+	class basic_index_mask
+	{
+	public:
+		/* Use the smallest possible unsigned word type. */
+		using value_type = std::conditional_t<sizeof(T) <= sizeof(std::size_t), std::size_t, std::uint64_t>;
+
+	public:
+		constexpr basic_index_mask() noexcept = default;
+		constexpr explicit basic_index_mask(value_type value) noexcept : m_value(value) {}
+
+		constexpr basic_index_mask operator++(int) noexcept
+		{
+			auto tmp = *this;
+			operator++();
+			return tmp;
+		}
+		constexpr basic_index_mask &operator++() noexcept
+		{
+			m_value &= (m_value - 1);
+			return *this;
+		}
+
+		[[nodiscard]] constexpr bool empty() const noexcept { return m_value == 0; }
+		[[nodiscard]] inline std::size_t lsb_index() const noexcept;
+		[[nodiscard]] inline std::size_t msb_index() const noexcept;
+
+		[[nodiscard]] constexpr bool operator==(const basic_index_mask &other) const noexcept { return m_value == other.m_value; }
+#if (__cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L))
+		[[nodiscard]] constexpr bool operator!=(const basic_index_mask &other) const noexcept { return m_value != other.m_value; }
+#endif
+
+	private:
+		value_type m_value = 0;
+	};
+
+	template<typename T>
+	[[maybe_unused]] [[nodiscard]] constexpr std::size_t generic_ctz(T value) noexcept
+	{
+		constexpr T mask = T{1};
+		std::size_t result = 0;
+		while ((value & (mask << result++)) == T{});
+		return result;
+	}
+	template<typename T>
+	[[maybe_unused]] [[nodiscard]] constexpr std::size_t generic_clz(T value) noexcept
+	{
+		constexpr T mask = T{1} << (std::numeric_limits<T>::digits - 1);
+		std::size_t result = 0;
+		while ((value & (mask >> result++)) == T{});
+		return result;
+	}
+
+#if defined(__GNUC__) || defined(__clang__)
+	template<typename T>
+	[[nodiscard]] inline std::size_t ctz(T value) noexcept
+	{
+		if constexpr (sizeof(T) <= sizeof(unsigned int))
+			return static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned int>(value)));
+		if constexpr (sizeof(T) <= sizeof(unsigned long))
+			return static_cast<std::size_t>(__builtin_ctzl(static_cast<unsigned long>(value)));
+		if constexpr (sizeof(T) <= sizeof(unsigned long long))
+			return static_cast<std::size_t>(__builtin_ctzll(static_cast<unsigned long long>(value)));
+		return generic_ctz(value);
+	}
+	template<typename T>
+	[[nodiscard]] inline std::size_t clz(T value) noexcept
+	{
+		if constexpr (sizeof(T) <= sizeof(unsigned int))
+		{
+			constexpr auto diff = (sizeof(unsigned int) - sizeof(T)) * 8;
+			return static_cast<std::size_t>(__builtin_clz(static_cast<unsigned int>(value))) - diff;
+		}
+		if constexpr (sizeof(T) <= sizeof(unsigned long))
+		{
+			constexpr auto diff = (sizeof(unsigned long) - sizeof(T)) * 8;
+			return static_cast<std::size_t>(__builtin_clzl(static_cast<unsigned long>(value))) - diff;
+		}
+		if constexpr (sizeof(T) <= sizeof(unsigned long long))
+		{
+			constexpr auto diff = (sizeof(unsigned long long) - sizeof(T)) * 8;
+			return static_cast<std::size_t>(__builtin_clzll(static_cast<unsigned long long>(value))) - diff;
+		}
+		return generic_clz(value);
+	}
+#elif defined(_MSC_VER)
+	template<typename T>
+	[[nodiscard]] inline std::size_t ctz(T value) noexcept
+	{
+		if constexpr (sizeof(T) <= sizeof(unsigned long))
+		{
+			unsigned long result = 0;
+			_BitScanForward(&result, static_cast<unsigned long>(value));
+			return static_cast<std::size_t>(result);
+		}
+#ifdef _WIN64
+		if constexpr (sizeof(T) <= sizeof(unsigned __int64))
+		{
+			unsigned long result = 0;
+			_BitScanForward64(&result, static_cast<unsigned __int64>(value));
+			return static_cast<std::size_t>(result);
+		}
+#endif
+		return generic_ctz(value);
+	}
+	template<typename T>
+	[[nodiscard]] inline std::size_t clz(T value) noexcept
+	{
+		if constexpr (sizeof(T) <= sizeof(unsigned long))
+		{
+			unsigned long result = 0;
+			_BitScanReverse(&result, static_cast<unsigned long>(value));
+			return std::numeric_limits<T>::digits - static_cast<std::size_t>(result);
+		}
+#ifdef _WIN64
+		if constexpr (sizeof(T) <= sizeof(unsigned __int64))
+		{
+			unsigned long result = 0;
+			_BitScanReverse64(&result, static_cast<unsigned __int64>(value));
+			return std::numeric_limits<T>::digits - static_cast<std::size_t>(result);
+		}
+#endif
+		return generic_clz(value);
+	}
+#else
+	template<typename T>
+	[[nodiscard]] inline std::size_t ctz(T value) noexcept { return generic_ctz(value); }
+	template<typename T>
+	[[nodiscard]] inline std::size_t clz(T value) noexcept { return generic_clz(value); }
+#endif
+
+	template<typename T, std::size_t P>
+	std::size_t basic_index_mask<T, P>::lsb_index() const noexcept { return ctz(m_value) >> P; }
+	template<typename T, std::size_t P>
+	std::size_t basic_index_mask<T, P>::msb_index() const noexcept { return clz(m_value) >> P; }
+
+#if defined(TPP_HAS_SSE2)
+	using index_mask = basic_index_mask<std::uint16_t, 0>;
+	using block_value = __m128i;
+#elif defined(TPP_HAS_NEON)
+	using index_mask = basic_index_mask<std::uint64_t, 3>;
+	using block_value = uint8x8_t;
+#else
+	using index_mask = basic_index_mask<std::uint64_t, 3>;
+	using block_value = std::uint64_t;
+#endif
+
+	struct meta_block
+	{
+		constexpr meta_block() noexcept = default;
+		constexpr meta_block(block_value value) noexcept : value(value) {}
+
+#if defined(TPP_HAS_SSE2)
+		explicit meta_block(const meta_byte *bytes) noexcept { value = _mm_loadu_si128(reinterpret_cast<const block_value *>(bytes)); }
+#elif defined(TPP_HAS_NEON)
+		explicit meta_block(const meta_byte *bytes) noexcept { value = vld1_u8(reinterpret_cast<const block_value *>(bytes)); }
+#else
+		explicit meta_block(const meta_byte *bytes) noexcept { value = read_unaligned<block_value>(bytes); }
+#endif
+
+		[[nodiscard]] inline index_mask match_empty() const noexcept;
+		[[nodiscard]] inline index_mask match_available() const noexcept;
+		[[nodiscard]] inline index_mask match_eq(meta_byte b) const noexcept;
+
+		/* Count leading empty of deleted entries (index of the left-most occupied entry). */
+		[[nodiscard]] inline std::size_t count_available() const noexcept;
+
+		/* Set available to empty & occupied to deleted. */
+		[[nodiscard]] inline meta_block reset_occupied() const noexcept;
+
+		block_value value = {};
+	};
+
+#if defined(TPP_HAS_SSE2)
+	/* https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87853 */
+	[[nodiscard]] inline __m128i x86_cmpeq_epi8(__m128i a, __m128i b) noexcept
+	{
+#if defined(__GNUC__) && !defined(__clang__)
+		if constexpr (std::is_unsigned_v<char>)
+			return (__m128i) ((__v16qi) a == (__v16qi) b);
+		else
+#endif
+		return _mm_cmpeq_epi8(a, b);
+	}
+	[[nodiscard]] inline __m128i x86_cmpgt_epi8(__m128i a, __m128i b) noexcept
+	{
+#if defined(__GNUC__) && !defined(__clang__)
+		if constexpr (std::is_unsigned_v<char>)
+			return (__m128i) ((__v16qi) a > (__v16qi) b);
+		else
+#endif
+		return _mm_cmpgt_epi8(a, b);
+	}
+
+	index_mask meta_block::match_empty() const noexcept
+	{
+#ifdef TPP_HAS_SSSE3
+		return index_mask{static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_sign_epi8(value, value)))};
+#else
+		return match_eq(meta_byte::empty);
+#endif
+	}
+	index_mask meta_block::match_available() const noexcept
+	{
+		return index_mask{static_cast<std::uint16_t>(_mm_movemask_epi8(x86_cmpgt_epi8(_mm_set1_epi8(std::int8_t(meta_byte::sentinel)), value)))};
+	}
+	index_mask meta_block::match_eq(meta_byte b) const noexcept
+	{
+		return index_mask{static_cast<std::uint16_t>(_mm_movemask_epi8(x86_cmpeq_epi8(_mm_set1_epi8(std::int8_t(b)), value)))};
+	}
+
+	std::size_t meta_block::count_available() const noexcept
+	{
+		return ctz(_mm_movemask_epi8(x86_cmpgt_epi8(_mm_set1_epi8(std::int8_t(meta_byte::sentinel)), value)) + 1);
+	}
+	meta_block meta_block::reset_occupied() const noexcept
+	{
+		/* Mask all occupied. */
+		const auto mask = x86_cmpgt_epi8(value, _mm_set1_epi8(std::int8_t(meta_byte::sentinel)));
+		const auto deleted = _mm_set1_epi8(std::int8_t(meta_byte::deleted));
+		const auto empty = _mm_set1_epi8(std::int8_t(meta_byte::empty));
+
+		/* (deleted & mask) | (empty & ~mask) */
+		return _mm_or_si128(_mm_and_si128(mask, deleted), _mm_andnot_si128(mask, empty));
+	}
+#elif defined(TPP_HAS_NEON)
+	index_mask meta_block::match_empty() const noexcept
+	{
+		return index_mask{vget_lane_u64(vreinterpret_u64_u8(vceq_s8(vdup_n_s8(std::int8_t(meta_byte::empty)), vreinterpret_s8_u8(value))), 0)};
+	}
+	index_mask meta_block::match_available() const noexcept
+	{
+		return index_mask{vget_lane_u64(vreinterpret_u64_u8(vcgt_s8(vdup_n_s8(std::int8_t(meta_byte::sentinel)), vreinterpret_s8_u8(value))), 0)};
+	}
+	index_mask meta_block::match_eq(meta_byte b) const noexcept
+	{
+		constexpr std::uint64_t msb_mask = 0x8080808080808080;
+		const auto v = vdup_n_u8(static_cast<std::uint8_t>(b));
+		return index_mask{vget_lane_u64(vreinterpret_u64_u8(vceq_u8(value, v)), 0) & msb_mask};
+	}
+
+	std::size_t meta_block::count_available() const noexcept
+	{
+		return ctz(vget_lane_u64(vreinterpret_u64_u8(vcle_s8(vdup_n_s8(std::int8_t(meta_byte::sentinel)), vreinterpret_s8_u8(value))), 0)) >> 3;
+	}
+	meta_block meta_block::reset_occupied() const noexcept
+	{
+		/* Mask all occupied. */
+		const auto mask = vreinterpret_u64_u8(vcgt_s8(vreinterpret_s8_u8(value), vdup_n_s8(std::int8_t(meta_byte::sentinel))));
+		const auto deleted = vreinterpret_u8_s8(vdup_n_s8(std::int8_t(meta_byte::deleted)));
+		const auto empty = vreinterpret_u8_s8(vdup_n_s8(std::int8_t(meta_byte::empty)));
+
+		/* mask ? deleted : empty */
+		return vbsl_u8(mask, deleted, empty);
+	}
+#else
+	index_mask meta_block::match_empty() const noexcept
+	{
+		constexpr std::uint64_t msb_mask = 0x8080808080808080;
+		return index_mask{(value & (~value << 6)) & msb_mask};
+	}
+	index_mask meta_block::match_available() const noexcept
+	{
+		constexpr std::uint64_t msb_mask = 0x8080808080808080;
+		return index_mask{(value & (~value << 7)) & msb_mask};
+	}
+	index_mask meta_block::match_eq(meta_byte b) const noexcept
+	{
+		constexpr std::uint64_t msb_mask = 0x8080808080808080;
+		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
+		const auto x = value ^ (lsb_mask * static_cast<std::uint8_t>(b));
+		return index_mask{(x - lsb_mask) & ~x & msb_mask};
+	}
+
+	std::size_t meta_block::count_available() const noexcept
+	{
+		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
+		return ctz((value | ~(value >> 7)) & lsb_mask) >> 3;
+	}
+	std::size_t meta_block::count_available() const noexcept
+	{
+		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
+		return ctz((value | ~(value >> 7)) & lsb_mask) >> 3;
+	}
+	meta_block meta_block::reset_occupied() const noexcept
+	{
+		constexpr std::uint64_t msb_mask = 0x8080808080808080;
+		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
+		const auto x = value & msb_mask;
+		return (~x + (x >> 7)) & ~lsb_mask;
+	}
+#endif
+
+	/* Loads a metadata block starting at `pos` from an array of `n` atomic metadata bytes (where `n` is a power of two), wrapping around
+	 * the end of the array. Bytes are loaded individually with acquire semantics, as they may be concurrently modified by other threads. */
+	[[nodiscard]] inline meta_block load_block(const std::atomic<meta_byte> *meta, std::size_t pos, std::size_t n) noexcept
+	{
+		alignas(meta_block) meta_byte bytes[sizeof(meta_block)];
+		for (std::size_t i = 0; i < sizeof(meta_block); ++i)
+			bytes[i] = meta[(pos + i) & (n - 1)].load(std::memory_order_acquire);
+		return meta_block{bytes};
+	}
+
+	/* Splits a hash into the probe position (H1) & the metadata byte of an occupied entry (H2). Every container using metadata
+	 * blocks (as well as binary snapshots of swiss tables) shares this layout. */
+	[[nodiscard]] constexpr std::pair<std::size_t, meta_byte> decompose_hash(std::size_t h) noexcept
+	{
+		return {h >> 7, {meta_byte(std::int8_t(h) & 0x7f)}};
+	}
+	/* Convert node capacity to max table size. */
+	template<typename S>
+	[[nodiscard]] constexpr S capacity_to_max_size(S n) noexcept
+	{
+		if constexpr (sizeof(meta_block) == 8)
+			return n == 7 ? 6 : n - n / 8;
+		else
+			return n - n / 8;
+	}
+	/* Returns the capacity an open-addressed table with `num_deleted` deleted entries must be rehashed to before an insertion, or 0 if
+	 * there is space left. If at most half of the space is used by live elements, deleted entries are reclaimed by rehashing into
+	 * a table of the same capacity. Otherwise, the table is grown. */
+	template<typename S>
+	[[nodiscard]] constexpr S rehash_capacity(S capacity, S size, S num_deleted, S min_capacity) noexcept
+	{
+		if (size + num_deleted < capacity_to_max_size(capacity))
+			return 0;
+		else if (capacity == 0)
+			return min_capacity;
+		else
+			return (size + 1) * 2 <= capacity_to_max_size(capacity) ? capacity : capacity * 2;
+	}
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <tuple>
+#include <utility>
 
 namespace tpp
 {
@@ -12,6 +13,14 @@ namespace tpp
 	template<typename... Ks>
 	struct multikey { static_assert(sizeof...(Ks) != 0, "Multikey must have at least one key type"); };
 
+	/** @brief Helper structure used to mark a secondary key of a multikey as lazy.
+	 *
+	 * Index of a lazy key is not maintained until the first non-const lookup by that key (`find`, `contains` or `erase`),
+	 * after which it is built and kept up to date. Until then, inserts do not hash the key and do not check it for conflicts.
+	 * Const lookups never build the index, and instead fall back to a linear search while the index is not built. */
+	template<typename K>
+	struct lazy_key {};
+
 	namespace _detail
 	{
 		template<typename, typename = void>
@@ -21,6 +30,24 @@ namespace tpp
 		template<typename>
 		struct multikey_eq;
 
+		template<typename K>
+		struct unwrap_key { using type = K; };
+		template<typename K>
+		struct unwrap_key<lazy_key<K>> { using type = K; };
+		template<typename K>
+		using unwrap_key_t = typename unwrap_key<K>::type;
+
+		template<typename K>
+		struct is_lazy_key : std::false_type {};
+		template<typename K>
+		struct is_lazy_key<lazy_key<K>> : std::true_type {};
+
+		template<typename... Ks, std::size_t... Is>
+		constexpr std::size_t make_lazy_mask(std::index_sequence<Is...>) noexcept { return ((std::size_t{is_lazy_key<Ks>::value} << Is) | ... | 0); }
+		/* Bit mask of lazy keys of a multikey. */
+		template<typename... Ks>
+		constexpr std::size_t lazy_mask_v = make_lazy_mask<Ks...>(std::index_sequence_for<Ks...>{});
+
 		template<typename T, typename U, typename... Us>
 		struct is_pack_element : is_pack_element<T, Us...> {};
 		template<typename T, typename... Us>
@@ -31,22 +58,22 @@ namespace tpp
 		struct is_pack_element<T, U> : std::false_type {};
 
 		template<typename... Ks, typename Mapped>
-		struct multikey_alloc<multikey<Ks...>, Mapped> { using type = std::allocator<std::pair<std::tuple<Ks...>, Mapped>>; };
+		struct multikey_alloc<multikey<Ks...>, Mapped> { using type = std::allocator<std::pair<std::tuple<unwrap_key_t<Ks>...>, Mapped>>; };
 		template<typename... Ks>
-		struct multikey_alloc<multikey<Ks...>, void> { using type = std::allocator<std::tuple<Ks...>>; };
+		struct multikey_alloc<multikey<Ks...>, void> { using type = std::allocator<std::tuple<unwrap_key_t<Ks>...>>; };
 		template<typename... Ts>
 		using multikey_alloc_t = typename multikey_alloc<Ts...>::type;
 
 		template<typename... Ks>
 		struct multikey_hash<multikey<Ks...>>
 		{
-			template<typename T, typename = std::enable_if_t<is_pack_element<T, Ks...>::value>>
+			template<typename T, typename = std::enable_if_t<is_pack_element<T, unwrap_key_t<Ks>...>::value>>
 			[[nodiscard]] constexpr auto operator()(const T &key) const { return std::hash<T>{}(key); }
 		};
 		template<typename... Ks>
 		struct multikey_eq<multikey<Ks...>>
 		{
-			template<typename T, typename = std::enable_if_t<is_pack_element<T, Ks...>::value>>
+			template<typename T, typename = std::enable_if_t<is_pack_element<T, unwrap_key_t<Ks>...>::value>>
 			[[nodiscard]] constexpr auto operator()(const T &a, const T &b) const { return std::equal_to<T>{}(a, b); }
 		};
 	}
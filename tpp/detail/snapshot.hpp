@@ -0,0 +1,162 @@
+/*
+ * Created by switchblade on 2023-01-25.
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <ios>
+#include <tuple>
+
+#include "utility.hpp"
+
+namespace tpp
+{
+	/** @brief Exception thrown when a table snapshot can not be written, read, or is not compatible with the table it is loaded into. */
+	class snapshot_error : public std::runtime_error
+	{
+	public:
+		using std::runtime_error::runtime_error;
+	};
+
+	namespace _detail
+	{
+		/* Elements can be saved as raw bytes if they are trivially copyable, or are pairs or tuples of such types. */
+		template<typename T>
+		struct is_snapshot_compatible : std::is_trivially_copyable<T> {};
+		template<typename T, typename U>
+		struct is_snapshot_compatible<std::pair<T, U>> : std::conjunction<is_snapshot_compatible<T>, is_snapshot_compatible<U>> {};
+		template<typename... Ts>
+		struct is_snapshot_compatible<std::tuple<Ts...>> : std::conjunction<is_snapshot_compatible<Ts>...> {};
+
+		enum class snapshot_kind : std::uint32_t { swiss = 1, dense = 2, frozen = 3 };
+		/* Header flag set if the snapshot contains the index of a dense table. */
+		inline constexpr std::uint32_t snapshot_index = 1;
+		/* Header flag set if the snapshot only contains metadata blocks of a swiss table modified since the previous checkpoint. */
+		inline constexpr std::uint32_t snapshot_delta = 2;
+
+		/* Snapshots are written in native byte order & layout, and are only meant to be loaded by the same build of the application.
+		 * Version must be incremented whenever layout of the snapshot or of the table nodes changes. */
+		struct snapshot_header
+		{
+			constexpr static std::uint32_t current_version = 1;
+
+			char magic[4] = {'T', 'P', 'P', 'S'};
+			std::uint32_t version = current_version;
+			std::uint32_t kind = 0;
+			std::uint32_t node_size = 0;
+			std::uint32_t node_align = 0;
+			std::uint32_t block_size = 0;
+			std::uint32_t flags = 0;
+			std::uint64_t capacity = 0;
+			std::uint64_t size = 0;
+			std::uint64_t extra[2] = {}; /* Table-specific values (ex. amount of empty slots of a swiss table). */
+			std::uint64_t fingerprint = 0;
+
+			/* Checks that the header was written by a compatible table. */
+			void validate(const snapshot_header &expected) const
+			{
+				if (std::memcmp(magic, expected.magic, sizeof(magic)) != 0)
+					throw snapshot_error("Invalid table snapshot");
+				if (version != expected.version || kind != expected.kind)
+					throw snapshot_error("Unsupported table snapshot version");
+				if (node_size != expected.node_size || node_align != expected.node_align || block_size != expected.block_size)
+					throw snapshot_error("Table snapshot layout mismatch");
+				if (fingerprint != expected.fingerprint)
+					throw snapshot_error("Table snapshot hash function mismatch");
+			}
+		};
+
+		/* Data sections following the header are aligned to at least 8 bytes, so that they can be used directly when mapped into memory. */
+		[[nodiscard]] constexpr std::size_t snapshot_align(std::size_t offset, std::size_t align) noexcept
+		{
+			align = align < 8 ? 8 : align;
+			return (offset + align - 1) / align * align;
+		}
+
+		/* Swiss table snapshots consist of the header, bucket metadata & nodes (where empty nodes are zero-filled). */
+		struct swiss_snapshot_layout
+		{
+			constexpr swiss_snapshot_layout(std::uint64_t capacity, std::size_t block_size, std::size_t node_size, std::size_t node_align) noexcept
+					: meta_offset(snapshot_align(sizeof(snapshot_header), 1)),
+					  nodes_offset(snapshot_align(meta_offset + static_cast<std::size_t>(capacity) + block_size, node_align)),
+					  total_size(nodes_offset + static_cast<std::size_t>(capacity) * node_size) {}
+
+			std::size_t meta_offset;
+			std::size_t nodes_offset;
+			std::size_t total_size;
+		};
+
+		/* Dense table snapshots consist of the header, dense element array & optionally the bucket array followed by per-key
+		 * metadata of the open-addressed index. */
+		struct dense_snapshot_layout
+		{
+			constexpr dense_snapshot_layout(std::uint64_t size, std::size_t node_size, std::size_t node_align, std::uint64_t buckets, std::size_t bucket_size, std::uint64_t meta_size) noexcept
+					: dense_offset(snapshot_align(sizeof(snapshot_header), node_align)),
+					  sparse_offset(snapshot_align(dense_offset + static_cast<std::size_t>(size) * node_size, 1)),
+					  meta_offset(sparse_offset + static_cast<std::size_t>(buckets) * bucket_size),
+					  total_size(meta_offset + static_cast<std::size_t>(meta_size)) {}
+
+			std::size_t dense_offset;
+			std::size_t sparse_offset;
+			std::size_t meta_offset;
+			std::size_t total_size;
+		};
+
+		/* Frozen table snapshots consist of the header, pilot array, slot occupancy bitmap & slots (including unused ones). */
+		struct frozen_snapshot_layout
+		{
+			constexpr frozen_snapshot_layout(std::uint64_t slots, std::size_t slot_size, std::size_t slot_align, std::uint64_t buckets) noexcept
+					: pilots_offset(snapshot_align(sizeof(snapshot_header), 1)),
+					  occupied_offset(snapshot_align(pilots_offset + static_cast<std::size_t>(buckets) * sizeof(std::uint32_t), 1)),
+					  slots_offset(snapshot_align(occupied_offset + static_cast<std::size_t>((slots + 63) / 64) * sizeof(std::uint64_t), slot_align)),
+					  total_size(slots_offset + static_cast<std::size_t>(slots) * slot_size) {}
+
+			std::size_t pilots_offset;
+			std::size_t occupied_offset;
+			std::size_t slots_offset;
+			std::size_t total_size;
+		};
+
+		/* Hash of a value-initialized key identifies the hash function (and it's seed) used by the saved table. */
+		template<typename K, typename H>
+		[[nodiscard]] std::uint64_t snapshot_fingerprint(const H &hash)
+		{
+			if constexpr (std::is_default_constructible_v<K>)
+				return static_cast<std::uint64_t>(hash(K{}));
+			else
+				return 0;
+		}
+
+		template<typename S>
+		void snapshot_write(S &os, const void *data, std::size_t n)
+		{
+			if (n != 0 && !os.write(static_cast<const char *>(data), static_cast<std::streamsize>(n)))
+				throw snapshot_error("Failed to write table snapshot");
+		}
+		template<typename S>
+		void snapshot_write_zeros(S &os, std::size_t n)
+		{
+			constexpr std::size_t chunk_size = 4096;
+			const char zeros[chunk_size] = {};
+			for (std::size_t chunk; n != 0; n -= chunk)
+				snapshot_write(os, zeros, chunk = n < chunk_size ? n : chunk_size);
+		}
+		template<typename S>
+		void snapshot_read(S &is, void *data, std::size_t n)
+		{
+			if (n != 0 && !is.read(static_cast<char *>(data), static_cast<std::streamsize>(n)))
+				throw snapshot_error("Failed to read table snapshot");
+		}
+		template<typename S>
+		void snapshot_skip(S &is, std::size_t n)
+		{
+			constexpr std::size_t chunk_size = 64;
+			char buffer[chunk_size];
+			for (std::size_t chunk; n != 0; n -= chunk)
+				snapshot_read(is, buffer, chunk = n < chunk_size ? n : chunk_size);
+		}
+	}
+}
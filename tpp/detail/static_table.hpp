@@ -0,0 +1,168 @@
+/*
+ * Created by switchblade on 2023-01-29.
+ */
+
+#pragma once
+
+#include <string_view>
+#include <stdexcept>
+#include <cstdint>
+#include <array>
+
+#include "table_common.hpp"
+
+namespace tpp
+{
+	/** @brief Hash functor usable in constant expressions.
+	 *
+	 * Integral & enum keys are hashed as-is, while strings are hashed via 64-bit FNV-1a. Hash values are additionally
+	 * mixed by static tables, and are stable across builds & platforms of the same pointer width. */
+	template<typename T, typename = void>
+	struct static_hash;
+
+	template<typename T>
+	struct static_hash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+	{
+		[[nodiscard]] constexpr std::size_t operator()(T value) const noexcept
+		{
+			if constexpr (std::is_enum_v<T>)
+				return static_cast<std::size_t>(static_cast<std::underlying_type_t<T>>(value));
+			else
+				return static_cast<std::size_t>(value);
+		}
+	};
+	template<typename C, typename Traits>
+	struct static_hash<std::basic_string_view<C, Traits>>
+	{
+		[[nodiscard]] constexpr std::size_t operator()(std::basic_string_view<C, Traits> str) const noexcept
+		{
+			std::uint64_t result = 0xcbf2'9ce4'8422'2325ull;
+			for (auto c: str)
+			{
+				result ^= static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<C>>(c));
+				result *= 0x100'0000'01b3ull;
+			}
+			return static_cast<std::size_t>(result);
+		}
+	};
+
+	namespace _detail
+	{
+		/* Table capacity is chosen so that a random seed has ~40-60% chance to be collision-free (see the birthday problem),
+		 * which requires the capacity to grow quadratically with the amount of keys. */
+		[[nodiscard]] constexpr std::size_t static_table_capacity(std::size_t n) noexcept
+		{
+			const auto min_cap = std::max(n * 2, n * n / 2);
+			std::size_t result = 1;
+			while (result < min_cap) result *= 2;
+			return result;
+		}
+
+		template<std::size_t N>
+		using static_index_t = std::conditional_t<(N <= 0xff), std::uint8_t, std::conditional_t<(N <= 0xffff), std::uint16_t, std::uint32_t>>;
+
+		/* Open-addressing table with a compile-time perfect hash function. Elements are stored in insertion order, and are
+		 * indexed by an array of element indices, addressed by the multiplicative hash of the key & a seed. Seed is selected
+		 * during construction such that positions of all keys are unique, thus a lookup consists of a hash, a shift and
+		 * a single compare. Empty positions of the index refer to the first element, which is never found at these positions. */
+		template<typename V, typename K, std::size_t N, typename Kh, typename Kc, typename ValueTraits>
+		class static_table : empty_base<Kh>, empty_base<Kc>
+		{
+			static_assert(N != 0, "Static table must contain at least one element");
+
+			using hash_base = empty_base<Kh>;
+			using cmp_base = empty_base<Kc>;
+
+			constexpr static std::size_t max_seeds = 4096;
+
+		public:
+			using value_type = V;
+			using key_type = K;
+
+			using hasher = Kh;
+			using key_equal = Kc;
+
+			using size_type = std::size_t;
+			using difference_type = std::ptrdiff_t;
+
+			using const_iterator = const value_type *;
+
+		private:
+			using index_t = static_index_t<N>;
+
+			constexpr static size_type capacity = static_table_capacity(N);
+			constexpr static size_type shift = 64 - log2(capacity);
+
+		public:
+			template<typename A, std::size_t... Is>
+			constexpr static_table(std::index_sequence<Is...>, const A &values, const Kh &hash, const Kc &cmp)
+					: hash_base(hash), cmp_base(cmp), m_values{values[Is]...}, m_seed(find_seed()), m_index(make_index()) {}
+
+			[[nodiscard]] constexpr const_iterator begin() const noexcept { return m_values.data(); }
+			[[nodiscard]] constexpr const_iterator end() const noexcept { return m_values.data() + N; }
+
+			[[nodiscard]] constexpr size_type size() const noexcept { return N; }
+			[[nodiscard]] constexpr size_type bucket_count() const noexcept { return capacity; }
+
+			template<typename T>
+			[[nodiscard]] constexpr const_iterator find(const T &key) const
+			{
+				const auto &value = m_values[m_index[position(key, m_seed)]];
+				TPP_IF_LIKELY(get_cmp()(ValueTraits::get_key(value), key))
+					return &value;
+				return end();
+			}
+
+			[[nodiscard]] constexpr const Kh &get_hash() const noexcept { return hash_base::value(); }
+			[[nodiscard]] constexpr const Kc &get_cmp() const noexcept { return cmp_base::value(); }
+
+		private:
+			/* Multiplicative hash moves entropy of the low bits of the key hash into the high bits of the product, which are
+			 * then used as the position. High bits of the key hash are folded in first, as they would otherwise be lost. */
+			template<typename T>
+			[[nodiscard]] constexpr size_type position(const T &key, std::uint64_t seed) const
+			{
+				auto h = static_cast<std::uint64_t>(get_hash()(key));
+				h ^= h >> 32;
+				return static_cast<size_type>((h * seed) >> shift);
+			}
+			[[nodiscard]] constexpr static std::uint64_t seed_at(std::size_t i) noexcept { return (0x9e37'79b9'7f4a'7c15ull * (i + 1)) | 1; }
+
+			/* Selects the first seed for which positions of all keys are unique. Since the table is built in a constant
+			 * expression, failure to find a seed results in a compilation error. */
+			[[nodiscard]] constexpr std::uint64_t find_seed() const
+			{
+				for (std::size_t i = 0; i < max_seeds; ++i)
+				{
+					std::array<std::uint64_t, (capacity + 63) / 64> taken = {};
+					bool valid = true;
+					for (std::size_t j = 0; j < N && valid; ++j)
+					{
+						const auto pos = position(ValueTraits::get_key(m_values[j]), seed_at(i));
+						const auto bit = std::uint64_t{1} << (pos % 64);
+						if ((taken[pos / 64] & bit) != 0) valid = false;
+						taken[pos / 64] |= bit;
+					}
+					if (valid) return seed_at(i);
+				}
+
+				for (std::size_t i = 0; i < N; ++i)
+					for (std::size_t j = i + 1; j < N; ++j)
+						if (get_cmp()(ValueTraits::get_key(m_values[i]), ValueTraits::get_key(m_values[j])))
+							throw std::invalid_argument("Static table keys must be unique");
+				throw std::invalid_argument("Failed to find a collision-free seed for static table keys");
+			}
+			[[nodiscard]] constexpr std::array<index_t, capacity> make_index() const
+			{
+				std::array<index_t, capacity> result = {};
+				for (std::size_t i = 0; i < N; ++i)
+					result[position(ValueTraits::get_key(m_values[i]), m_seed)] = static_cast<index_t>(i);
+				return result;
+			}
+
+			std::array<value_type, N> m_values;
+			std::uint64_t m_seed;
+			std::array<index_t, capacity> m_index;
+		};
+	}
+}
@@ -0,0 +1,155 @@
+/*
+ * Created by switchblade on 2023-01-18.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+
+#include "utility.hpp"
+
+namespace tpp
+{
+	/** @brief Non-owning view of `size()` objects of type `T` placed `stride()` bytes apart.
+	 *
+	 * Strided views are used to access a single member (ex. key or mapped value) of elements of a contiguous container
+	 * without copying or going through container iterators. A view is invalidated by any operation that invalidates
+	 * references to elements of the viewed container. */
+	template<typename T>
+	class strided_view
+	{
+		using byte_type = std::conditional_t<std::is_const_v<T>, const std::uint8_t, std::uint8_t>;
+
+	public:
+		using element_type = T;
+		using value_type = std::remove_cv_t<T>;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using pointer = T *;
+		using reference = T &;
+
+		class iterator
+		{
+			friend class strided_view;
+
+		public:
+			using value_type = std::remove_cv_t<T>;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T *;
+			using reference = T &;
+			using iterator_category = std::random_access_iterator_tag;
+#if (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
+			using iterator_concept = std::random_access_iterator_tag;
+#endif
+
+		private:
+			constexpr iterator(pointer ptr, difference_type stride) noexcept : m_ptr(ptr), m_stride(stride) {}
+
+		public:
+			constexpr iterator() noexcept = default;
+
+			iterator operator++(int) noexcept
+			{
+				auto tmp = *this;
+				operator++();
+				return tmp;
+			}
+			iterator &operator++() noexcept { return operator+=(1); }
+			iterator operator--(int) noexcept
+			{
+				auto tmp = *this;
+				operator--();
+				return tmp;
+			}
+			iterator &operator--() noexcept { return operator-=(1); }
+
+			iterator &operator+=(difference_type n) noexcept
+			{
+				m_ptr = offset(m_ptr, n * m_stride);
+				return *this;
+			}
+			iterator &operator-=(difference_type n) noexcept { return operator+=(-n); }
+
+			[[nodiscard]] iterator operator+(difference_type n) const noexcept { return iterator{*this} += n; }
+			[[nodiscard]] iterator operator-(difference_type n) const noexcept { return iterator{*this} -= n; }
+			[[nodiscard]] friend iterator operator+(difference_type n, const iterator &iter) noexcept { return iter + n; }
+
+			[[nodiscard]] difference_type operator-(const iterator &other) const noexcept
+			{
+				TPP_ASSERT(m_stride == other.m_stride, "Iterators must belong to the same view");
+				return m_stride ? (bytes(m_ptr) - bytes(other.m_ptr)) / m_stride : 0;
+			}
+
+			[[nodiscard]] constexpr pointer operator->() const noexcept { return m_ptr; }
+			[[nodiscard]] constexpr reference operator*() const noexcept { return *m_ptr; }
+			[[nodiscard]] reference operator[](difference_type n) const noexcept { return *offset(m_ptr, n * m_stride); }
+
+			[[nodiscard]] constexpr bool operator==(const iterator &other) const noexcept { return m_ptr == other.m_ptr; }
+			[[nodiscard]] constexpr bool operator!=(const iterator &other) const noexcept { return m_ptr != other.m_ptr; }
+			[[nodiscard]] bool operator<(const iterator &other) const noexcept { return (*this - other) < 0; }
+			[[nodiscard]] bool operator<=(const iterator &other) const noexcept { return (*this - other) <= 0; }
+			[[nodiscard]] bool operator>(const iterator &other) const noexcept { return (*this - other) > 0; }
+			[[nodiscard]] bool operator>=(const iterator &other) const noexcept { return (*this - other) >= 0; }
+
+		private:
+			pointer m_ptr = nullptr;
+			difference_type m_stride = 0;
+		};
+		using const_iterator = iterator;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = reverse_iterator;
+
+	public:
+		/** Initializes an empty view. */
+		constexpr strided_view() noexcept = default;
+		/** Initializes a view of `size` objects starting at `data`, with each next object located `stride` bytes after the previous. */
+		constexpr strided_view(pointer data, size_type size, difference_type stride) noexcept : m_data(data), m_size(size), m_stride(stride) {}
+
+		/** Returns iterator to the first object of the view. */
+		[[nodiscard]] constexpr iterator begin() const noexcept { return iterator{m_data, m_stride}; }
+		/** @copydoc begin */
+		[[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin(); }
+		/** Returns iterator one past the last object of the view. */
+		[[nodiscard]] iterator end() const noexcept { return begin() + static_cast<difference_type>(m_size); }
+		/** @copydoc end */
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+		/** Returns reverse iterator to the last object of the view. */
+		[[nodiscard]] reverse_iterator rbegin() const noexcept { return reverse_iterator{end()}; }
+		/** @copydoc rbegin */
+		[[nodiscard]] const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+		/** Returns reverse iterator one past the first object of the view. */
+		[[nodiscard]] constexpr reverse_iterator rend() const noexcept { return reverse_iterator{begin()}; }
+		/** @copydoc rend */
+		[[nodiscard]] constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+		/** Returns pointer to the first object of the view. */
+		[[nodiscard]] constexpr pointer data() const noexcept { return m_data; }
+		/** Returns the distance between two adjacent objects of the view in bytes. */
+		[[nodiscard]] constexpr difference_type stride() const noexcept { return m_stride; }
+		/** Returns the number of objects within the view. */
+		[[nodiscard]] constexpr size_type size() const noexcept { return m_size; }
+		/** Checks if the view is empty (`size() == 0`). */
+		[[nodiscard]] constexpr bool empty() const noexcept { return m_size == 0; }
+
+		/** Returns reference to the `i`th object of the view. */
+		[[nodiscard]] reference operator[](size_type i) const noexcept
+		{
+			TPP_ASSERT(i < m_size, "View index out of range");
+			return *offset(m_data, static_cast<difference_type>(i) * m_stride);
+		}
+		/** Returns reference to the first object of the view. */
+		[[nodiscard]] reference front() const noexcept { return operator[](0); }
+		/** Returns reference to the last object of the view. */
+		[[nodiscard]] reference back() const noexcept { return operator[](m_size - 1); }
+
+	private:
+		[[nodiscard]] static byte_type *bytes(pointer ptr) noexcept { return reinterpret_cast<byte_type *>(ptr); }
+		[[nodiscard]] static pointer offset(pointer ptr, difference_type n) noexcept { return reinterpret_cast<pointer>(bytes(ptr) + n); }
+
+		pointer m_data = nullptr;
+		size_type m_size = 0;
+		difference_type m_stride = 0;
+	};
+}
@@ -4,340 +4,23 @@
 
 #pragma once
 
+#include <numeric>
 #include <vector>
 #include <limits>
+#include <memory>
 #include <tuple>
 #include <new>
 
 #include "table_common.hpp"
-
-#if defined(TPP_HAS_SSSE3)
-#include <tmmintrin.h>
-#elif defined(TPP_HAS_SSE2)
-#include <emmintrin.h>
-#endif
-
-#ifdef TPP_HAS_NEON
-#include <arm_neon.h>
-#endif
-
-#ifdef _MSC_VER
-#include <intrin.h>
-
-#pragma intrinsic(_BitScanForward, _BitScanReverse)
-#ifdef _WIN64
-#pragma intrinsic(_BitScanForward64, _BitScanReverse64)
-#endif
-#endif
+#include "meta_block.hpp"
+#include "executor.hpp"
+#include "snapshot.hpp"
 
 namespace tpp::_detail
 {
 	template<typename I, typename V, typename K, typename Kh, typename Kc, typename Alloc, typename ValueTraits>
 	class swiss_table;
 
-	enum class meta_byte : std::int8_t
-	{
-		empty = static_cast<std::int8_t>(0b1000'0000),
-		deleted = static_cast<std::int8_t>(0b1111'1110),
-		sentinel = static_cast<std::int8_t>(0b1111'1111),
-	};
-
-	[[nodiscard]] constexpr bool is_occupied(meta_byte v) noexcept { return v > meta_byte::sentinel; }
-	[[nodiscard]] constexpr bool is_available(meta_byte v) noexcept { return v < meta_byte::sentinel; }
-
-	template<typename T, std::size_t P>
-	class basic_index_mask
-	{
-	public:
-		/* Use the smallest possible unsigned word type. */
-		using value_type = std::conditional_t<sizeof(T) <= sizeof(std::size_t), std::size_t, std::uint64_t>;
-
-	public:
-		constexpr basic_index_mask() noexcept = default;
-		constexpr explicit basic_index_mask(value_type value) noexcept : m_value(value) {}
-
-		constexpr basic_index_mask operator++(int) noexcept
-		{
-			auto tmp = *this;
-			operator++();
-			return tmp;
-		}
-		constexpr basic_index_mask &operator++() noexcept
-		{
-			m_value &= (m_value - 1);
-			return *this;
-		}
-
-		[[nodiscard]] constexpr bool empty() const noexcept { return m_value == 0; }
-		[[nodiscard]] inline std::size_t lsb_index() const noexcept;
-		[[nodiscard]] inline std::size_t msb_index() const noexcept;
-
-		[[nodiscard]] constexpr bool operator==(const basic_index_mask &other) const noexcept { return m_value == other.m_value; }
-#if (__cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L))
-		[[nodiscard]] constexpr bool operator!=(const basic_index_mask &other) const noexcept { return m_value != other.m_value; }
-#endif
-
-	private:
-		value_type m_value = 0;
-	};
-
-	template<typename T>
-	[[maybe_unused]] [[nodiscard]] constexpr std::size_t generic_ctz(T value) noexcept
-	{
-		constexpr T mask = T{1};
-		std::size_t result = 0;
-		while ((value & (mask << result++)) == T{});
-		return result;
-	}
-	template<typename T>
-	[[maybe_unused]] [[nodiscard]] constexpr std::size_t generic_clz(T value) noexcept
-	{
-		constexpr T mask = T{1} << (std::numeric_limits<T>::digits - 1);
-		std::size_t result = 0;
-		while ((value & (mask >> result++)) == T{});
-		return result;
-	}
-
-#if defined(__GNUC__) || defined(__clang__)
-	template<typename T>
-	[[nodiscard]] inline std::size_t ctz(T value) noexcept
-	{
-		if constexpr (sizeof(T) <= sizeof(unsigned int))
-			return static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned int>(value)));
-		if constexpr (sizeof(T) <= sizeof(unsigned long))
-			return static_cast<std::size_t>(__builtin_ctzl(static_cast<unsigned long>(value)));
-		if constexpr (sizeof(T) <= sizeof(unsigned long long))
-			return static_cast<std::size_t>(__builtin_ctzll(static_cast<unsigned long long>(value)));
-		return generic_ctz(value);
-	}
-	template<typename T>
-	[[nodiscard]] inline std::size_t clz(T value) noexcept
-	{
-		if constexpr (sizeof(T) <= sizeof(unsigned int))
-		{
-			constexpr auto diff = (sizeof(unsigned int) - sizeof(T)) * 8;
-			return static_cast<std::size_t>(__builtin_clz(static_cast<unsigned int>(value))) - diff;
-		}
-		if constexpr (sizeof(T) <= sizeof(unsigned long))
-		{
-			constexpr auto diff = (sizeof(unsigned long) - sizeof(T)) * 8;
-			return static_cast<std::size_t>(__builtin_clzl(static_cast<unsigned long>(value))) - diff;
-		}
-		if constexpr (sizeof(T) <= sizeof(unsigned long long))
-		{
-			constexpr auto diff = (sizeof(unsigned long long) - sizeof(T)) * 8;
-			return static_cast<std::size_t>(__builtin_clzll(static_cast<unsigned long long>(value))) - diff;
-		}
-		return generic_clz(value);
-	}
-#elif defined(_MSC_VER)
-	template<typename T>
-	[[nodiscard]] inline std::size_t ctz(T value) noexcept
-	{
-		if constexpr (sizeof(T) <= sizeof(unsigned long))
-		{
-			unsigned long result = 0;
-			_BitScanForward(&result, static_cast<unsigned long>(value));
-			return static_cast<std::size_t>(result);
-		}
-#ifdef _WIN64
-		if constexpr (sizeof(T) <= sizeof(unsigned __int64))
-		{
-			unsigned long result = 0;
-			_BitScanForward64(&result, static_cast<unsigned __int64>(value));
-			return static_cast<std::size_t>(result);
-		}
-#endif
-		return generic_ctz(value);
-	}
-	template<typename T>
-	[[nodiscard]] inline std::size_t clz(T value) noexcept
-	{
-		if constexpr (sizeof(T) <= sizeof(unsigned long))
-		{
-			unsigned long result = 0;
-			_BitScanReverse(&result, static_cast<unsigned long>(value));
-			return std::numeric_limits<T>::digits - static_cast<std::size_t>(result);
-		}
-#ifdef _WIN64
-		if constexpr (sizeof(T) <= sizeof(unsigned __int64))
-		{
-			unsigned long result = 0;
-			_BitScanReverse64(&result, static_cast<unsigned __int64>(value));
-			return std::numeric_limits<T>::digits - static_cast<std::size_t>(result);
-		}
-#endif
-		return generic_clz(value);
-	}
-#else
-	template<typename T>
-	[[nodiscard]] inline std::size_t ctz(T value) noexcept { return generic_ctz(value); }
-	template<typename T>
-	[[nodiscard]] inline std::size_t clz(T value) noexcept { return generic_clz(value); }
-#endif
-
-	template<typename T, std::size_t P>
-	std::size_t basic_index_mask<T, P>::lsb_index() const noexcept { return ctz(m_value) >> P; }
-	template<typename T, std::size_t P>
-	std::size_t basic_index_mask<T, P>::msb_index() const noexcept { return clz(m_value) >> P; }
-
-#if defined(TPP_HAS_SSE2)
-	using index_mask = basic_index_mask<std::uint16_t, 0>;
-	using block_value = __m128i;
-#elif defined(TPP_HAS_NEON)
-	using index_mask = basic_index_mask<std::uint64_t, 3>;
-	using block_value = uint8x8_t;
-#else
-	using index_mask = basic_index_mask<std::uint64_t, 3>;
-	using block_value = std::uint64_t;
-#endif
-
-	struct meta_block
-	{
-		constexpr meta_block() noexcept = default;
-		constexpr meta_block(block_value value) noexcept : value(value) {}
-
-#if defined(TPP_HAS_SSE2)
-		explicit meta_block(const meta_byte *bytes) noexcept { value = _mm_loadu_si128(reinterpret_cast<const block_value *>(bytes)); }
-#elif defined(TPP_HAS_NEON)
-		explicit meta_block(const meta_byte *bytes) noexcept { value = vld1_u8(reinterpret_cast<const block_value *>(bytes)); }
-#else
-		explicit meta_block(const meta_byte *bytes) noexcept { value = read_unaligned<block_value>(bytes); }
-#endif
-
-		[[nodiscard]] inline index_mask match_empty() const noexcept;
-		[[nodiscard]] inline index_mask match_available() const noexcept;
-		[[nodiscard]] inline index_mask match_eq(meta_byte b) const noexcept;
-
-		/* Count leading empty of deleted entries (index of the left-most occupied entry). */
-		[[nodiscard]] inline std::size_t count_available() const noexcept;
-
-		/* Set available to empty & occupied to deleted. */
-		[[nodiscard]] inline meta_block reset_occupied() const noexcept;
-
-		block_value value = {};
-	};
-
-#if defined(TPP_HAS_SSE2)
-	/* https://gcc.gnu.org/bugzilla/show_bug.cgi?id=87853 */
-	[[nodiscard]] inline __m128i x86_cmpeq_epi8(__m128i a, __m128i b) noexcept
-	{
-#if defined(__GNUC__) && !defined(__clang__)
-		if constexpr (std::is_unsigned_v<char>)
-			return (__m128i) ((__v16qi) a == (__v16qi) b);
-		else
-#endif
-		return _mm_cmpeq_epi8(a, b);
-	}
-	[[nodiscard]] inline __m128i x86_cmpgt_epi8(__m128i a, __m128i b) noexcept
-	{
-#if defined(__GNUC__) && !defined(__clang__)
-		if constexpr (std::is_unsigned_v<char>)
-			return (__m128i) ((__v16qi) a > (__v16qi) b);
-		else
-#endif
-		return _mm_cmpgt_epi8(a, b);
-	}
-
-	index_mask meta_block::match_empty() const noexcept
-	{
-#ifdef TPP_HAS_SSSE3
-		return index_mask{static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_sign_epi8(value, value)))};
-#else
-		return match_eq(meta_byte::empty);
-#endif
-	}
-	index_mask meta_block::match_available() const noexcept
-	{
-		return index_mask{static_cast<std::uint16_t>(_mm_movemask_epi8(x86_cmpgt_epi8(_mm_set1_epi8(std::int8_t(meta_byte::sentinel)), value)))};
-	}
-	index_mask meta_block::match_eq(meta_byte b) const noexcept
-	{
-		return index_mask{static_cast<std::uint16_t>(_mm_movemask_epi8(x86_cmpeq_epi8(_mm_set1_epi8(std::int8_t(b)), value)))};
-	}
-
-	std::size_t meta_block::count_available() const noexcept
-	{
-		return ctz(_mm_movemask_epi8(x86_cmpgt_epi8(_mm_set1_epi8(std::int8_t(meta_byte::sentinel)), value)) + 1);
-	}
-	meta_block meta_block::reset_occupied() const noexcept
-	{
-		/* Mask all occupied. */
-		const auto mask = x86_cmpgt_epi8(value, _mm_set1_epi8(std::int8_t(meta_byte::sentinel)));
-		const auto deleted = _mm_set1_epi8(std::int8_t(meta_byte::deleted));
-		const auto empty = _mm_set1_epi8(std::int8_t(meta_byte::empty));
-
-		/* (deleted & mask) | (empty & ~mask) */
-		return _mm_or_si128(_mm_and_si128(mask, deleted), _mm_andnot_si128(mask, empty));
-	}
-#elif defined(TPP_HAS_NEON)
-	index_mask meta_block::match_empty() const noexcept
-	{
-		return index_mask{vget_lane_u64(vreinterpret_u64_u8(vceq_s8(vdup_n_s8(std::int8_t(meta_byte::empty)), vreinterpret_s8_u8(value))), 0)};
-	}
-	index_mask meta_block::match_available() const noexcept
-	{
-		return index_mask{vget_lane_u64(vreinterpret_u64_u8(vcgt_s8(vdup_n_s8(std::int8_t(meta_byte::sentinel)), vreinterpret_s8_u8(value))), 0)};
-	}
-	index_mask meta_block::match_eq(meta_byte b) const noexcept
-	{
-		constexpr std::uint64_t msb_mask = 0x8080808080808080;
-		const auto v = vdup_n_u8(static_cast<std::uint8_t>(b));
-		return index_mask{vget_lane_u64(vreinterpret_u64_u8(vceq_u8(value, v)), 0) & msb_mask};
-	}
-
-	std::size_t meta_block::count_available() const noexcept
-	{
-		return ctz(vget_lane_u64(vreinterpret_u64_u8(vcle_s8(vdup_n_s8(std::int8_t(meta_byte::sentinel)), vreinterpret_s8_u8(value))), 0)) >> 3;
-	}
-	meta_block meta_block::reset_occupied() const noexcept
-	{
-		/* Mask all occupied. */
-		const auto mask = vreinterpret_u64_u8(vcgt_s8(vreinterpret_s8_u8(value), vdup_n_s8(std::int8_t(meta_byte::sentinel))));
-		const auto deleted = vreinterpret_u8_s8(vdup_n_s8(std::int8_t(meta_byte::deleted)));
-		const auto empty = vreinterpret_u8_s8(vdup_n_s8(std::int8_t(meta_byte::empty)));
-
-		/* mask ? deleted : empty */
-		return vbsl_u8(mask, deleted, empty);
-	}
-#else
-	index_mask meta_block::match_empty() const noexcept
-	{
-		constexpr std::uint64_t msb_mask = 0x8080808080808080;
-		return index_mask{(value & (~value << 6)) & msb_mask};
-	}
-	index_mask meta_block::match_available() const noexcept
-	{
-		constexpr std::uint64_t msb_mask = 0x8080808080808080;
-		return index_mask{(value & (~value << 7)) & msb_mask};
-	}
-	index_mask meta_block::match_eq(meta_byte b) const noexcept
-	{
-		constexpr std::uint64_t msb_mask = 0x8080808080808080;
-		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
-		const auto x = value ^ (lsb_mask * static_cast<std::uint8_t>(b));
-		return index_mask{(x - lsb_mask) & ~x & msb_mask};
-	}
-
-	std::size_t meta_block::count_available() const noexcept
-	{
-		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
-		return ctz((value | ~(value >> 7)) & lsb_mask) >> 3;
-	}
-	std::size_t meta_block::count_available() const noexcept
-	{
-		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
-		return ctz((value | ~(value >> 7)) & lsb_mask) >> 3;
-	}
-	meta_block meta_block::reset_occupied() const noexcept
-	{
-		constexpr std::uint64_t msb_mask = 0x8080808080808080;
-		constexpr std::uint64_t lsb_mask = 0x0101010101010101;
-		const auto x = value & msb_mask;
-		return (~x + (x >> 7)) & ~lsb_mask;
-	}
-#endif
-
 	/* Helper used to select node table type. */
 	template<typename T, typename = void>
 	struct is_stable : std::false_type {};
@@ -351,6 +34,8 @@ namespace tpp::_detail
 
 		using is_transparent = std::conjunction<_detail::is_transparent<Kh>, _detail::is_transparent<Kc>>;
 		using is_ordered = _detail::is_ordered<typename ValueTraits::link_type>;
+		/* Modified blocks are only tracked by tables that support snapshots. */
+		using can_track_dirty = std::conjunction<std::negation<is_ordered>, std::negation<is_stable<ValueTraits>>, is_snapshot_compatible<I>>;
 
 		using bucket_node = std::conditional_t<is_stable<ValueTraits>::value, stable_node<V, Alloc, ValueTraits>, packed_node<I, Alloc, ValueTraits>>;
 		using bucket_link = typename ValueTraits::link_type;
@@ -557,7 +242,8 @@ namespace tpp::_detail
 		}
 		void reallocate(size_type n)
 		{
-			if (capacity < n)
+			/* Positions of nodes depend on the capacity, thus the buffer is re-allocated even if it is larger. */
+			if (capacity != n)
 			{
 				if (capacity != 0)
 				{
@@ -699,7 +385,8 @@ namespace tpp::_detail
 		}
 		void reallocate(size_type n)
 		{
-			if (capacity < n)
+			/* Positions of nodes depend on the capacity, thus the buffer is re-allocated even if it is larger. */
+			if (capacity != n)
 			{
 				if (capacity) std::allocator_traits<NodeAlloc>::deallocate(node_alloc(), static_cast<node_ptr>(m_data), buffer_size(capacity));
 				m_data = std::allocator_traits<NodeAlloc>::allocate(node_alloc(), buffer_size(n));
@@ -741,11 +428,65 @@ namespace tpp::_detail
 		void *m_data = {};
 	};
 
+	/* Bitmap of metadata blocks of a swiss table modified since the last checkpoint. Once the entire table is marked, individual blocks
+	 * are no longer tracked, which allows parallel operations to mark the table before modifying it from multiple threads. */
+	class dirty_blocks
+	{
+	public:
+		[[nodiscard]] static constexpr std::size_t block_count(std::size_t capacity) noexcept { return (capacity + sizeof(meta_block) - 1) / sizeof(meta_block); }
+
+		explicit dirty_blocks(std::size_t capacity) { reset(capacity); }
+
+		[[nodiscard]] constexpr std::size_t capacity() const noexcept { return m_capacity; }
+		[[nodiscard]] constexpr bool all() const noexcept { return m_all; }
+
+		void mark(std::size_t block) noexcept
+		{
+			TPP_ASSERT(m_all || block < block_count(m_capacity), "Dirty block index is out of range");
+			if (!m_all) m_bits[block / 64] |= std::uint64_t{1} << (block % 64);
+		}
+		void mark_all() noexcept { m_all = true; }
+
+		/* Returns indices of the marked blocks in ascending order. */
+		[[nodiscard]] std::vector<std::size_t> marked() const
+		{
+			std::vector<std::size_t> result;
+			for (std::size_t i = 0; i < m_bits.size(); ++i)
+				for (auto word = m_bits[i]; word != 0; word &= word - 1)
+					result.push_back(i * 64 + ctz(word));
+			return result;
+		}
+
+		void reset(std::size_t capacity)
+		{
+			m_bits.assign((block_count(capacity) + 63) / 64, 0);
+			m_capacity = capacity;
+			m_all = false;
+		}
+
+	private:
+		std::vector<std::uint64_t> m_bits;
+		std::size_t m_capacity = 0;
+		bool m_all = false;
+	};
+
+	/* Dirty-block tracking state of a swiss table. Tables that do not support snapshots store no state. */
+	template<bool Enable>
+	struct swiss_dirty_state {};
+	template<>
+	struct swiss_dirty_state<true>
+	{
+		std::unique_ptr<dirty_blocks> m_dirty; /* Blocks modified since the last checkpoint, if tracking is enabled. */
+	};
+
 	template<typename I, typename V, typename K, typename Kh, typename Kc, typename Alloc, typename ValueTraits>
-	class swiss_table : public swiss_node_traits<V, Alloc, ValueTraits>, empty_base<Kh>, empty_base<Kc>, empty_base<typename ValueTraits::link_type>
+	class swiss_table : public swiss_node_traits<V, Alloc, ValueTraits>, empty_base<Kh>, empty_base<Kc>, empty_base<typename ValueTraits::link_type>,
+	                    swiss_dirty_state<swiss_table_traits<I, V, K, Kh, Kc, Alloc, ValueTraits>::can_track_dirty::value>
 	{
 		using traits_t = swiss_table_traits<I, V, K, Kh, Kc, Alloc, ValueTraits>;
 		using link_base = empty_base<typename ValueTraits::link_type>;
+		using dirty_base = swiss_dirty_state<traits_t::can_track_dirty::value>;
+		using can_track_dirty = typename traits_t::can_track_dirty;
 
 	public:
 		using insert_type = typename traits_t::insert_type;
@@ -805,19 +546,9 @@ namespace tpp::_detail
 		using hash_base = empty_base<hasher>;
 		using cmp_base = empty_base<key_equal>;
 
-		[[nodiscard]] static constexpr std::pair<std::size_t, meta_byte> decompose_hash(std::size_t h) noexcept
-		{
-			return {h >> 7, {meta_byte(std::int8_t(h) & 0x7f)}};
-		}
+		/* Reseeding re-hashes all keys in-place, which is only possible if hashing does not throw. */
+		using can_reseed = std::conjunction<is_reseedable<hasher>, std::is_nothrow_invocable<const hasher &, const key_type &>>;
 
-		/* Convert node capacity to max table size. */
-		[[nodiscard]] static constexpr size_type capacity_to_max_size(size_type n) noexcept
-		{
-			if constexpr (sizeof(meta_block) == 8)
-				return n == 7 ? 6 : n - n / 8;
-			else
-				return n - n / 8;
-		}
 		/* Convert table size to required node capacity. */
 		[[nodiscard]] static constexpr size_type size_to_min_capacity(size_type n) noexcept
 		{
@@ -845,8 +576,8 @@ namespace tpp::_detail
 		template<typename Iter>
 		swiss_table(Iter first, Iter last, size_type n, const hasher &hash, const key_equal &cmp, const allocator_type &alloc) : swiss_table(distance_or_n(first, last, n), hash, cmp, alloc) { insert(first, last); }
 
-		swiss_table(const swiss_table &other) : hash_base(other), cmp_base(other), link_base(), m_buffer(other.m_buffer) { copy_data(other); }
-		swiss_table(const swiss_table &other, const allocator_type &alloc) : hash_base(other), cmp_base(other), link_base(), m_buffer(alloc) { copy_data(other); }
+		swiss_table(const swiss_table &other) : hash_base(other), cmp_base(other), link_base(), dirty_base(), m_buffer(other.m_buffer) { copy_data(other); }
+		swiss_table(const swiss_table &other, const allocator_type &alloc) : hash_base(other), cmp_base(other), link_base(), dirty_base(), m_buffer(alloc) { copy_data(other); }
 
 		swiss_table(swiss_table &&other) noexcept(std::is_nothrow_move_constructible_v<buffer_type> && std::is_nothrow_move_constructible_v<hasher> && std::is_nothrow_move_constructible_v<key_equal>)
 				: hash_base(std::move(other)), cmp_base(std::move(other)), link_base(std::move(other)), m_buffer(std::move(other.m_buffer)) { move_from(other); }
@@ -857,11 +588,12 @@ namespace tpp::_detail
 		{
 			if (this != &other)
 			{
+				/* Clear before assigning the header link, so that metadata of the old buffer does not refer to destroyed nodes. */
+				clear();
 				link_base::operator=(other);
 				hash_base::operator=(other);
 				cmp_base::operator=(other);
 
-				erase_nodes();
 				m_buffer = other.m_buffer;
 				copy_data(other);
 			}
@@ -871,11 +603,11 @@ namespace tpp::_detail
 		{
 			if (this != &other)
 			{
+				clear();
 				link_base::operator=(std::move(other));
 				hash_base::operator=(std::move(other));
 				cmp_base::operator=(std::move(other));
 
-				erase_nodes();
 				m_buffer = std::move(other.m_buffer);
 				move_from(other);
 			}
@@ -915,6 +647,7 @@ namespace tpp::_detail
 
 		void clear()
 		{
+			m_reseed_capacity = 0;
 			if (m_size != 0)
 			{
 				/* Reset header link. */
@@ -925,6 +658,7 @@ namespace tpp::_detail
 				m_buffer.fill_empty();
 				m_size = 0;
 				m_num_empty = capacity_to_max_size(m_buffer.capacity);
+				mark_dirty_all();
 			}
 		}
 		void reserve(size_type n) { if (n > m_size + m_num_empty) do_rehash(align_capacity(size_to_min_capacity(n))); }
@@ -937,6 +671,14 @@ namespace tpp::_detail
 		template<typename T>
 		[[nodiscard]] const_iterator find(const T &key) const { return to_iter(find_node(key, hash(key))); }
 
+		/* Overloads of lookup functions that accept a precomputed hash `h` of the key. */
+		template<typename T>
+		[[nodiscard]] bool contains_hashed(const T &key, std::size_t h) const { return find_node(key, h) != m_buffer.capacity; }
+		template<typename T>
+		[[nodiscard]] iterator find_hashed(const T &key, std::size_t h) { return to_iter(find_node(key, h)); }
+		template<typename T>
+		[[nodiscard]] const_iterator find_hashed(const T &key, std::size_t h) const { return to_iter(find_node(key, h)); }
+
 		std::pair<iterator, bool> insert(const insert_type &value) { return do_insert({}, ValueTraits::get_key(value), value); }
 		std::pair<iterator, bool> insert(insert_type &&value) { return do_insert({}, ValueTraits::get_key(value), std::move(value)); }
 		iterator insert(const_iterator hint, const insert_type &value)
@@ -963,8 +705,8 @@ namespace tpp::_detail
 		auto insert_node(N &&node) -> typename stable_node<V, Alloc, ValueTraits>::template insert_return<iterator, N>
 		{
 			const auto h = hash(node.key());
-			if (auto target_pos = find_node(node.key(), h); target_pos == m_buffer.capacity)
-				return {emplace_node({}, h, std::forward<N>(node)), true};
+			if (const auto [target_pos, slot] = find_slot(node.key(), h); target_pos == m_buffer.capacity)
+				return {emplace_node_at({}, h, slot, std::forward<N>(node)), true};
 			else
 				return {to_iter(target_pos), false, std::forward<N>(node)};
 		}
@@ -972,8 +714,8 @@ namespace tpp::_detail
 		auto insert_node(const_iterator hint, N &&node) -> iterator
 		{
 			const auto h = hash(node.key());
-			if (auto target_pos = find_node(node.key(), h); target_pos == m_buffer.capacity)
-				return emplace_node(hint, h, std::forward<N>(node));
+			if (const auto [target_pos, slot] = find_slot(node.key(), h); target_pos == m_buffer.capacity)
+				return emplace_node_at(hint, h, slot, std::forward<N>(node));
 			else
 				return to_iter(target_pos);
 		}
@@ -995,8 +737,8 @@ namespace tpp::_detail
 		std::pair<iterator, bool> insert_or_assign_node(N &&node)
 		{
 			const auto h = hash(node.key());
-			if (auto target_pos = find_node(node.key(), h); target_pos == m_buffer.capacity)
-				return {emplace_node({}, h, std::forward<N>(node)), true};
+			if (const auto [target_pos, slot] = find_slot(node.key(), h); target_pos == m_buffer.capacity)
+				return {emplace_node_at({}, h, slot, std::forward<N>(node)), true};
 			else
 			{
 				auto alloc = value_allocator{get_allocator()};
@@ -1010,8 +752,8 @@ namespace tpp::_detail
 		iterator insert_or_assign_node(node_iterator hint, N &&node)
 		{
 			const auto h = hash(node.key());
-			if (auto target_pos = find_node(node.key(), h); target_pos == m_buffer.capacity)
-				return emplace_node(hint, h, std::forward<N>(node));
+			if (const auto [target_pos, slot] = find_slot(node.key(), h); target_pos == m_buffer.capacity)
+				return emplace_node_at(hint, h, slot, std::forward<N>(node));
 			else
 			{
 				auto alloc = value_allocator{get_allocator()};
@@ -1048,11 +790,18 @@ namespace tpp::_detail
 		{
 			return do_try_emplace(to_underlying(hint), std::forward<U>(key), std::forward<Args>(args)...).first;
 		}
+		template<typename U, typename... Args>
+		std::pair<iterator, bool> try_emplace_hashed(U &&key, std::size_t h, Args &&...args) TPP_REQUIRES((std::is_constructible_v<V, std::piecewise_construct_t, std::tuple<K &&>, std::tuple<Args && ...>>))
+		{
+			return do_try_emplace_hashed({}, h, std::forward<U>(key), std::forward<Args>(args)...);
+		}
 
 		template<typename T, typename = std::enable_if_t<!std::is_convertible_v<T, const_iterator>>>
-		iterator erase(const T &key)
+		iterator erase(const T &key) { return erase_hashed(key, hash(key)); }
+		template<typename T>
+		iterator erase_hashed(const T &key, std::size_t h)
 		{
-			if (const auto pos = find_node(key, hash(key)); pos != m_buffer.capacity)
+			if (const auto pos = find_node(key, h); pos != m_buffer.capacity)
 				return do_erase(pos);
 			else
 				return end();
@@ -1104,7 +853,8 @@ namespace tpp::_detail
 			{
 				const auto &key = ValueTraits::get_key(*pos);
 				const auto h = hash(key);
-				if (find_node(key, h) == m_buffer.capacity) emplace_node({}, h, other.extract(pos));
+				if (const auto [target_pos, slot] = find_slot(key, h); target_pos == m_buffer.capacity)
+					emplace_node_at({}, h, slot, other.extract(pos));
 			};
 			if constexpr (!is_ordered::value)
 				for (auto pos = other.begin(), last = other.end(); pos != last; ++pos) transfer(pos);
@@ -1130,6 +880,248 @@ namespace tpp::_detail
 			if (!n || new_cap > m_buffer.capacity) do_rehash(new_cap);
 		}
 
+		template<typename E>
+		void rehash(size_type n, const E &exec)
+		{
+			TPP_IF_UNLIKELY(!n && !m_size) return;
+
+			const auto new_cap = align_capacity(n | size_to_min_capacity(n));
+			if (!n || new_cap > m_buffer.capacity) do_rehash(new_cap, exec);
+		}
+		template<typename E>
+		void reserve(size_type n, const E &exec) { if (n > m_size + m_num_empty) do_rehash(align_capacity(size_to_min_capacity(n)), exec); }
+
+		/* Bulk insertion using executor `exec`. If multiple elements of the range have equal keys, the first one is inserted. */
+		template<typename E, typename Iter>
+		void insert(const E &exec, Iter first, Iter last)
+		{
+			if constexpr (!parallel_placement || !std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<Iter>::iterator_category>)
+				insert(first, last);
+			else
+				do_parallel_insert(exec, first, static_cast<size_type>(std::distance(first, last)));
+		}
+
+		[[nodiscard]] std::vector<iterator_range<iterator>> split(size_type n) { return split_nodes<iterator>(n); }
+		[[nodiscard]] std::vector<iterator_range<const_iterator>> split(size_type n) const { return split_nodes<const_iterator>(n); }
+
+		template<typename S>
+		void save(S &os) const
+		{
+			assert_snapshot();
+
+			const auto header = snapshot_header_for(m_buffer.capacity, m_size, m_num_empty);
+			const auto layout = snapshot_layout(m_buffer.capacity);
+			snapshot_write(os, &header, sizeof(header));
+			snapshot_write_zeros(os, layout.meta_offset - sizeof(header));
+			TPP_IF_UNLIKELY(m_buffer.capacity == 0)
+				return;
+
+			const auto meta_size = m_buffer.capacity + sizeof(meta_block);
+			snapshot_write(os, m_buffer.meta(), meta_size);
+			snapshot_write_zeros(os, layout.nodes_offset - layout.meta_offset - meta_size);
+			write_nodes(os, 0, m_buffer.capacity);
+		}
+		template<typename S>
+		void load(S &is)
+		{
+			assert_snapshot();
+
+			const auto header = read_snapshot_header(is, 0);
+			const auto capacity = static_cast<size_type>(header.capacity);
+			const auto layout = snapshot_layout(capacity);
+			snapshot_skip(is, layout.meta_offset - sizeof(header));
+
+			/* Read the snapshot into a separate buffer, so that the table is left unchanged on failure. */
+			auto buffer = buffer_type{get_allocator()};
+			if (capacity != 0)
+			{
+				buffer.allocate(capacity);
+				try
+				{
+					const auto meta_size = capacity + sizeof(meta_block);
+					snapshot_read(is, buffer.meta(), meta_size);
+					snapshot_skip(is, layout.nodes_offset - layout.meta_offset - meta_size);
+					snapshot_read(is, to_address(buffer.nodes()), capacity * sizeof(bucket_node));
+					verify_snapshot(buffer, header);
+				}
+				catch (...)
+				{
+					buffer.deallocate();
+					throw;
+				}
+			}
+
+			if (m_size != 0) erase_nodes();
+			m_buffer.swap_data(buffer);
+			buffer.deallocate();
+
+			m_size = static_cast<size_type>(header.size);
+			m_num_empty = static_cast<size_type>(header.extra[0]);
+			mark_dirty_all();
+		}
+
+		void set_dirty_tracking(bool enable)
+		{
+			assert_snapshot();
+			if constexpr (can_track_dirty::value)
+			{
+				if (!enable)
+					dirty_base::m_dirty.reset();
+				else if (!dirty_base::m_dirty)
+					dirty_base::m_dirty = std::make_unique<dirty_blocks>(m_buffer.capacity);
+			}
+		}
+		[[nodiscard]] bool dirty_tracking() const noexcept { return dirty_state() != nullptr; }
+		void mark_dirty(const_iterator where) noexcept
+		{
+			const auto pos = static_cast<size_type>(&(*to_underlying(where)) - m_buffer.nodes());
+			mark_dirty_block(pos / sizeof(meta_block));
+		}
+
+		/* Deltas consist of the header, followed by the index, metadata & nodes of every written block. */
+		template<typename S>
+		void checkpoint_delta(S &os)
+		{
+			assert_snapshot();
+
+			/* Without tracking (or if the entire table was modified), all blocks are written. */
+			std::vector<std::size_t> blocks;
+			auto *dirty = dirty_state();
+			if (!dirty || dirty->all() || dirty->capacity() != m_buffer.capacity)
+			{
+				blocks.resize(dirty_blocks::block_count(m_buffer.capacity));
+				std::iota(blocks.begin(), blocks.end(), std::size_t{0});
+			}
+			else
+				blocks = dirty->marked();
+
+			auto header = snapshot_header_for(m_buffer.capacity, m_size, m_num_empty);
+			header.flags = snapshot_delta;
+			header.extra[1] = blocks.size();
+			snapshot_write(os, &header, sizeof(header));
+			for (const auto block: blocks)
+			{
+				const auto first = block * sizeof(meta_block);
+				const auto last = std::min<size_type>(first + sizeof(meta_block), m_buffer.capacity);
+				const auto index = static_cast<std::uint64_t>(block);
+				snapshot_write(os, &index, sizeof(index));
+				snapshot_write(os, m_buffer.meta() + first, last - first);
+				write_nodes(os, first, last);
+			}
+
+			/* Blocks remain marked if the delta could not be written. */
+			if (dirty) dirty->reset(m_buffer.capacity);
+		}
+		template<typename S>
+		void apply_delta(S &is)
+		{
+			assert_snapshot();
+
+			const auto header = read_snapshot_header(is, snapshot_delta);
+			const auto capacity = static_cast<size_type>(header.capacity);
+			const auto num_blocks = dirty_blocks::block_count(capacity);
+			const auto num_records = header.extra[1];
+
+			/* Delta of a table with a different capacity can only be applied if it contains all blocks. */
+			const auto rebuild = capacity != m_buffer.capacity;
+			if (num_records > num_blocks || (rebuild && num_records != num_blocks))
+				throw snapshot_error("Table snapshot delta does not match the table");
+
+			/* Read all blocks before modifying the table, so that the table is left unchanged on failure. Blocks are sorted,
+			 * thus only the last block may be partial, and metadata & nodes of the `i`th block start at `i * sizeof(meta_block)`. */
+			std::vector<size_type> indices;
+			std::vector<meta_byte> metadata;
+			std::vector<unsigned char> nodes;
+			for (std::uint64_t i = 0; i < num_records; ++i)
+			{
+				std::uint64_t index;
+				snapshot_read(is, &index, sizeof(index));
+				if (index >= num_blocks || (!indices.empty() && index <= indices.back()))
+					throw snapshot_error("Invalid table snapshot delta");
+
+				const auto first = static_cast<size_type>(index) * sizeof(meta_block);
+				const auto n = std::min<size_type>(sizeof(meta_block), capacity - first);
+				indices.push_back(static_cast<size_type>(index));
+				metadata.resize(metadata.size() + n);
+				nodes.resize(nodes.size() + n * sizeof(bucket_node));
+				snapshot_read(is, metadata.data() + metadata.size() - n, n);
+				snapshot_read(is, nodes.data() + nodes.size() - n * sizeof(bucket_node), n * sizeof(bucket_node));
+			}
+
+			auto buffer = buffer_type{get_allocator()};
+			if (rebuild && capacity != 0)
+			{
+				buffer.allocate(capacity);
+				buffer.fill_empty();
+			}
+			auto &target = rebuild ? buffer : m_buffer;
+			const auto used = rebuild ? 0 : capacity_to_max_size(m_buffer.capacity) - m_num_empty;
+			try { verify_delta(target, rebuild ? 0 : m_size, used, header, indices, metadata, nodes); }
+			catch (...)
+			{
+				buffer.deallocate();
+				throw;
+			}
+
+			/* Replace the modified blocks. Nodes are trivially copyable, so they are copied as raw bytes. */
+			auto alloc = value_allocator{get_allocator()};
+			auto *target_meta = target.meta();
+			auto *target_nodes = to_address(target.nodes());
+			for (size_type i = 0; i < indices.size(); ++i)
+			{
+				const auto first = indices[i] * sizeof(meta_block);
+				const auto n = std::min<size_type>(sizeof(meta_block), capacity - first);
+				for (size_type j = first; j < first + n; ++j)
+					if (is_occupied(target_meta[j])) target_nodes[j].destroy(alloc);
+
+				std::memcpy(target_meta + first, metadata.data() + i * sizeof(meta_block), n);
+				std::memcpy(static_cast<void *>(target_nodes + first), nodes.data() + i * sizeof(meta_block) * sizeof(bucket_node), n * sizeof(bucket_node));
+				if (!rebuild) mark_dirty_block(indices[i]);
+			}
+
+			/* Update the mirrored tail of the first block. */
+			if (!indices.empty() && indices.front() == 0)
+				for (size_type i = 0; i < std::min<size_type>(sizeof(meta_block) - 1, capacity); ++i)
+					target_meta[capacity + 1 + i] = target_meta[i];
+
+			if (rebuild)
+			{
+				if (m_size != 0) erase_nodes();
+				m_buffer.swap_data(buffer);
+				buffer.deallocate();
+				mark_dirty_all();
+			}
+			m_size = static_cast<size_type>(header.size);
+			m_num_empty = static_cast<size_type>(header.extra[0]);
+		}
+
+		/* Re-inserts nodes in link order and purges deleted entries. Position of the nodes is dictated by their hash,
+		 * so earlier-inserted nodes take their preferred slots and probe sequences are left without tombstones. */
+		void compact()
+		{
+			static_assert(is_ordered::value, "compact is only available for ordered tables");
+
+			TPP_IF_UNLIKELY(m_size == 0)
+				return;
+
+			m_buffer.resize(m_buffer.capacity, [&](auto, auto, size_type)
+			{
+				/* Header link still points to the old buffer, which is kept alive until relocation is complete. */
+				auto alloc = node_allocator{get_allocator()};
+				for (auto *node = begin_node(), *last = end_node(); node != last;)
+				{
+					auto *link = static_cast<bucket_link *>(node);
+					auto *next = static_cast<bucket_node *>(link->off(link->next));
+					const auto h = node->hash();
+					const auto target_pos = find_available(h);
+					m_buffer.nodes()[target_pos].relocate(alloc, alloc, *node);
+					set_metadata(target_pos, decompose_hash(h).second);
+					node = next;
+				}
+			});
+			m_num_empty = capacity_to_max_size(m_buffer.capacity) - m_size;
+		}
+
 		/* SwissHash uses a fixed maximum load factor. See https://github.com/abseil/abseil-cpp/blob/189d55a57f57731d335fd84999d5dccf771b8e6b/absl/container/internal/raw_hash_set.h#L479 */
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return 7.0f / 8.0f; }
 
@@ -1232,6 +1224,38 @@ namespace tpp::_detail
 			}
 			return m_buffer.capacity;
 		}
+		/* Same as `find_node`, but also returns the first available slot of the probe sequence (which is the slot `find_available`
+		 * would return), so that insertion of a missing key does not need to walk the probe sequence again. */
+		template<typename T>
+		std::pair<size_type, size_type> find_slot(const T &key, std::size_t h) const
+		{
+			auto slot = m_buffer.capacity;
+			TPP_IF_LIKELY(m_buffer.capacity != 0)
+			{
+				const auto [h1, h2] = decompose_hash(h);
+				const auto *metadata = m_buffer.meta();
+				const auto *nodes = m_buffer.nodes();
+				for (auto probe = bucket_probe{h1 & m_buffer.capacity, m_buffer.capacity};; ++probe)
+				{
+					const auto block = meta_block(metadata + probe.pos);
+					for (auto match = block.match_eq(h2); !match.empty(); ++match)
+					{
+						const auto offset = probe.off(match.lsb_index());
+						TPP_IF_LIKELY(cmp(nodes[offset].key(), key))
+							return {offset, slot};
+					}
+
+					/* Remember the first empty or deleted slot. */
+					if (slot == m_buffer.capacity)
+						if (const auto available = block.match_available(); !available.empty())
+							slot = probe.off(available.lsb_index());
+					TPP_IF_UNLIKELY(!block.match_empty().empty())
+						break;
+					assert_probe(probe);
+				}
+			}
+			return {m_buffer.capacity, slot};
+		}
 		size_type find_available(std::size_t h) const noexcept
 		{
 			const auto [h1, h2] = decompose_hash(h);
@@ -1245,33 +1269,207 @@ namespace tpp::_detail
 			}
 		}
 
+		/* Snapshots contain raw metadata & nodes of the table. Ordered tables are not supported, as their header link is not part of the buffer. */
+		constexpr static void assert_snapshot() noexcept
+		{
+			static_assert(!is_ordered::value && !is_stable<ValueTraits>::value, "Snapshots are only available for unordered packed tables");
+			static_assert(is_snapshot_compatible<I>::value, "Snapshots require trivially copyable elements");
+		}
+		[[nodiscard]] snapshot_header snapshot_header_for(size_type capacity, size_type size, size_type num_empty) const
+		{
+			snapshot_header result;
+			result.kind = static_cast<std::uint32_t>(snapshot_kind::swiss);
+			result.node_size = sizeof(bucket_node);
+			result.node_align = alignof(bucket_node);
+			result.block_size = sizeof(meta_block);
+			result.capacity = capacity;
+			result.size = size;
+			result.extra[0] = num_empty;
+			result.fingerprint = snapshot_fingerprint<key_type>(get_hash());
+			return result;
+		}
+		[[nodiscard]] static constexpr swiss_snapshot_layout snapshot_layout(size_type capacity) noexcept
+		{
+			return {capacity, sizeof(meta_block), sizeof(bucket_node), alignof(bucket_node)};
+		}
+		/* Checks integrity of the loaded metadata, and that the stored hashes of the (first few) elements match the hash function.
+		 * Amount of empty slots still available for insertion must match the metadata, as insertion relies on it to detect a full table. */
+		void verify_snapshot(const buffer_type &buffer, const snapshot_header &header) const
+		{
+			constexpr size_type max_rehashed = 64;
+			constexpr auto tail_size = sizeof(meta_block) - 1;
+
+			const auto *metadata = buffer.meta();
+			const auto *nodes = to_address(buffer.nodes());
+			if (metadata[buffer.capacity] != meta_byte::sentinel)
+				throw snapshot_error("Invalid table snapshot");
+			for (size_type i = 0; i < std::min<size_type>(tail_size, buffer.capacity); ++i)
+				if (metadata[buffer.capacity + 1 + i] != metadata[i])
+					throw snapshot_error("Invalid table snapshot");
+
+			size_type occupied = 0, deleted = 0;
+			for (size_type i = 0; i < buffer.capacity; ++i)
+			{
+				if (!is_occupied(metadata[i]))
+				{
+					if (metadata[i] == meta_byte::deleted)
+						++deleted;
+					else if (metadata[i] != meta_byte::empty)
+						throw snapshot_error("Invalid table snapshot");
+					continue;
+				}
+
+				const auto h = nodes[i].hash();
+				if (decompose_hash(h).second != metadata[i] || (occupied < max_rehashed && hash(nodes[i].key()) != h))
+					throw snapshot_error("Table snapshot hash function mismatch");
+				++occupied;
+			}
+			if (occupied != header.size || !is_num_empty_valid(buffer.capacity, occupied + deleted, header))
+				throw snapshot_error("Invalid table snapshot");
+		}
+		/* Every occupied or deleted slot is subtracted from the amount of empty slots available for insertion. */
+		[[nodiscard]] static constexpr bool is_num_empty_valid(size_type capacity, size_type used, const snapshot_header &header) noexcept
+		{
+			const auto max_size = capacity_to_max_size(capacity);
+			return used <= max_size && header.extra[0] == max_size - used;
+		}
+
+		/* Reads & validates a snapshot header with the specified flags. */
+		template<typename S>
+		[[nodiscard]] snapshot_header read_snapshot_header(S &is, std::uint32_t flags) const
+		{
+			snapshot_header header;
+			snapshot_read(is, &header, sizeof(header));
+			header.validate(snapshot_header_for(0, 0, 0));
+			if (header.flags != flags)
+				throw snapshot_error(flags == snapshot_delta ? "Invalid table snapshot delta" : "Invalid table snapshot");
+
+			const auto capacity = static_cast<size_type>(header.capacity);
+			const auto max_size = capacity ? capacity_to_max_size(capacity) : 0;
+			if (header.capacity > max_bucket_count() || ((capacity + 1) & capacity) != 0 || header.size > max_size || header.extra[0] > max_size - header.size)
+				throw snapshot_error("Invalid table snapshot");
+			return header;
+		}
+		/* Writes runs of occupied nodes within [first, last) as-is, and zeros in place of empty nodes. */
+		template<typename S>
+		void write_nodes(S &os, size_type first, size_type last) const
+		{
+			const auto *metadata = m_buffer.meta();
+			const auto *nodes = to_address(m_buffer.nodes());
+			for (size_type run_last; first < last; first = run_last)
+			{
+				const auto occupied = is_occupied(metadata[first]);
+				for (run_last = first + 1; run_last < last && is_occupied(metadata[run_last]) == occupied;) ++run_last;
+				if (occupied)
+					snapshot_write(os, nodes + first, (run_last - first) * sizeof(bucket_node));
+				else
+					snapshot_write_zeros(os, (run_last - first) * sizeof(bucket_node));
+			}
+		}
+		/* Checks that the blocks of a delta are consistent with the stored hashes, and that applying them to `target` (containing `size` elements
+		 * and `used` occupied or deleted slots) results in the saved size & amount of empty slots. */
+		void verify_delta(const buffer_type &target, size_type size, size_type used, const snapshot_header &header, const std::vector<size_type> &indices,
+		                  const std::vector<meta_byte> &metadata, const std::vector<unsigned char> &nodes) const
+		{
+			constexpr size_type max_rehashed = 64;
+
+			const auto *target_meta = target.meta();
+			for (size_type i = 0, checked = 0; i < indices.size(); ++i)
+			{
+				const auto first = indices[i] * sizeof(meta_block);
+				const auto n = std::min<size_type>(sizeof(meta_block), target.capacity - first);
+				for (size_type j = 0; j < n; ++j)
+				{
+					size -= is_occupied(target_meta[first + j]);
+					used -= target_meta[first + j] != meta_byte::empty;
+
+					const auto value = metadata[i * sizeof(meta_block) + j];
+					if (!is_occupied(value) && value != meta_byte::empty && value != meta_byte::deleted)
+						throw snapshot_error("Invalid table snapshot delta");
+					used += value != meta_byte::empty;
+					if (!is_occupied(value)) continue;
+
+					alignas(bucket_node) unsigned char storage[sizeof(bucket_node)];
+					std::memcpy(storage, nodes.data() + (i * sizeof(meta_block) + j) * sizeof(bucket_node), sizeof(bucket_node));
+					const auto &node = *std::launder(reinterpret_cast<const bucket_node *>(storage));
+					if (decompose_hash(node.hash()).second != value || (checked++ < max_rehashed && hash(node.key()) != node.hash()))
+						throw snapshot_error("Table snapshot hash function mismatch");
+					++size;
+				}
+			}
+			if (size != header.size || !is_num_empty_valid(target.capacity, used, header))
+				throw snapshot_error("Table snapshot delta does not match the table");
+		}
+
+		/* Splits slots of the table into `n` ranges of whole metadata blocks. Iterators of the ranges skip to the next occupied slot (or the sentinel),
+		 * so a range that contains no elements begins and ends at the same position. */
+		template<typename It>
+		[[nodiscard]] std::vector<iterator_range<It>> split_nodes(size_type n) const
+		{
+			static_assert(!is_ordered::value, "split is only available for unordered tables");
+
+			const auto blocks = (m_buffer.capacity + sizeof(meta_block) - 1) / sizeof(meta_block);
+			n = std::clamp<size_type>(n, 1, std::max<size_type>(blocks, 1));
+
+			const auto slot_iter = [&](size_type block)
+			{
+				const auto pos = std::min<size_type>(blocks * block / n * sizeof(meta_block), m_buffer.capacity);
+				return It{node_iterator{m_buffer.meta() + pos, m_buffer.nodes() + pos}};
+			};
+
+			std::vector<iterator_range<It>> result;
+			result.reserve(n);
+			for (size_type i = 0; i < n; ++i)
+				result.emplace_back(slot_iter(i), slot_iter(i + 1));
+			return result;
+		}
+
 		void set_metadata(size_type pos, meta_byte value) noexcept
 		{
 			constexpr auto tail_size = sizeof(meta_block) - 1;
 			auto *metadata = m_buffer.meta();
 			metadata[((pos - tail_size) & m_buffer.capacity) + (tail_size & m_buffer.capacity)] = value;
 			metadata[pos] = value;
+			mark_dirty_block(pos / sizeof(meta_block));
+		}
+
+		/* Tracking of modified blocks is compiled out for tables that do not support snapshots. */
+		[[nodiscard]] dirty_blocks *dirty_state() const noexcept
+		{
+			if constexpr (can_track_dirty::value)
+				return dirty_base::m_dirty.get();
+			else
+				return nullptr;
+		}
+		void mark_dirty_block(size_type block) noexcept
+		{
+			if constexpr (can_track_dirty::value)
+				if (dirty_base::m_dirty) dirty_base::m_dirty->mark(block);
+		}
+		void mark_dirty_all() noexcept
+		{
+			if constexpr (can_track_dirty::value)
+				if (dirty_base::m_dirty) dirty_base::m_dirty->mark_all();
 		}
 
 		void insert_link(node_iterator hint, bucket_node *node) noexcept
 		{
 			if constexpr (is_ordered::value)
 			{
-				auto prev = hint.link ? const_cast<bucket_link *>(hint.link) : back_node();
+				auto prev = hint.link ? const_cast<bucket_link *>(to_address(hint.link)) : back_node();
 				node->link(prev);
 			}
 		}
+		/* Inserts a node at the available slot `target_pos` previously obtained from `find_slot`, unless the table has to be rehashed first. */
 		template<typename... Args>
-		iterator emplace_node(node_iterator hint, std::size_t h, Args &&...args)
+		iterator emplace_node_at(node_iterator hint, std::size_t h, size_type target_pos, Args &&...args)
 		{
-			size_type target_pos;
 			TPP_IF_UNLIKELY(m_buffer.capacity == 0)
 			{
 				do_rehash(1);
 				target_pos = find_available(h);
 			} else
 			{
-				target_pos = find_available(h);
 				TPP_IF_UNLIKELY(!m_num_empty && m_buffer.meta()[target_pos] != meta_byte::deleted)
 				{
 					/* Do an in-place rehash by reclaiming deleted entries. Choice of coefficients is outlined by the reference implementation at
@@ -1296,6 +1494,9 @@ namespace tpp::_detail
 			set_metadata(target_pos, decompose_hash(h).second);
 			++m_size;
 
+			if constexpr (can_reseed::value)
+				TPP_IF_UNLIKELY(is_probe_excessive(h, target_pos))
+					target_pos = reseed_rehash(target_pos);
 			return to_iter(target_pos);
 		}
 		iterator erase_node(size_type pos, bucket_node *node)
@@ -1317,6 +1518,16 @@ namespace tpp::_detail
 
 		template<typename... Args>
 		std::pair<iterator, bool> do_emplace(node_iterator hint, Args &&...args)
+		{
+			/* If the key can be obtained from the arguments, look it up before constructing the node. */
+			using extractor = key_extractor<I, K>;
+			if constexpr (is_key_extractable<extractor, std::tuple<Args...>>::value)
+				return do_insert(hint, extractor::get(args...), std::forward<Args>(args)...);
+			else
+				return do_emplace_tmp(hint, std::forward<Args>(args)...);
+		}
+		template<typename... Args>
+		std::pair<iterator, bool> do_emplace_tmp(node_iterator hint, Args &&...args)
 		{
 			auto alloc = value_allocator{get_allocator()};
 			auto tmp = bucket_node{};
@@ -1331,8 +1542,13 @@ namespace tpp::_detail
 		std::pair<iterator, bool> do_try_emplace(node_iterator hint, T &&key, Args &&...args)
 		{
 			const auto h = hash(key);
-			if (auto target_pos = find_node(key, h); target_pos == m_buffer.capacity)
-				return {emplace_node(hint, h, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), true};
+			return do_try_emplace_hashed(hint, h, std::forward<T>(key), std::forward<Args>(args)...);
+		}
+		template<typename T, typename... Args>
+		std::pair<iterator, bool> do_try_emplace_hashed(node_iterator hint, std::size_t h, T &&key, Args &&...args)
+		{
+			if (const auto [target_pos, slot] = find_slot(key, h); target_pos == m_buffer.capacity)
+				return {emplace_node_at(hint, h, slot, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), true};
 			else
 				return {to_iter(target_pos), false};
 		}
@@ -1340,8 +1556,8 @@ namespace tpp::_detail
 		std::pair<iterator, bool> do_insert(node_iterator hint, const T &key, Args &&...args)
 		{
 			const auto h = hash(key);
-			if (auto target_pos = find_node(key, h); target_pos == m_buffer.capacity)
-				return {emplace_node(hint, h, std::forward<Args>(args)...), true};
+			if (const auto [target_pos, slot] = find_slot(key, h); target_pos == m_buffer.capacity)
+				return {emplace_node_at(hint, h, slot, std::forward<Args>(args)...), true};
 			else
 				return {to_iter(target_pos), false};
 		}
@@ -1349,11 +1565,12 @@ namespace tpp::_detail
 		std::pair<iterator, bool> do_insert_or_assign(node_iterator hint, T &&key, Args &&...args)
 		{
 			const auto h = hash(key);
-			if (auto target_pos = find_node(key, h); target_pos == m_buffer.capacity)
-				return {emplace_node(hint, h, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), true};
+			if (const auto [target_pos, slot] = find_slot(key, h); target_pos == m_buffer.capacity)
+				return {emplace_node_at(hint, h, slot, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)), true};
 			else
 			{
 				m_buffer.nodes()[target_pos].replace(std::forward<Args>(args)...);
+				mark_dirty_block(target_pos / sizeof(meta_block));
 				return {to_iter(target_pos), false};
 			}
 		}
@@ -1375,12 +1592,140 @@ namespace tpp::_detail
 
 		void do_rehash(size_type capacity)
 		{
+			mark_dirty_all();
 			m_buffer.resize(capacity, [&](auto src_meta, auto src_nodes, size_type src_cap)
 			{
 				/* Relocate occupied entries from the old buffers to the new buffers. */
 				auto alloc = node_allocator{get_allocator()};
 				for (size_type i = 0; i < src_cap; ++i)
 					if (is_occupied(src_meta[i]))
+					{
+						auto *node = to_address(src_nodes + i);
+						const auto h = node->hash();
+						const auto target_pos = find_available(h);
+						m_buffer.nodes()[target_pos].relocate(alloc, alloc, *node);
+						set_metadata(target_pos, decompose_hash(h).second);
+					}
+			});
+			m_num_empty = capacity_to_max_size(capacity) - m_size;
+		}
+
+		/* Parallel placement splits the slots of the buffer into a power of 2 of equally-sized partitions, and assigns every
+		 * element to the partition containing it's home slot. Partitions are then filled in parallel, with every task only
+		 * probing blocks that lie entirely within it's own partition. Elements which probe sequence leaves the partition
+		 * (or wraps around the table) before an available slot is found are placed by a final serial pass.
+		 *
+		 * Ordered tables are excluded, since placing a node modifies the links of it's neighbours. Relocation must not throw,
+		 * as the source buffer is released once `resize` returns. */
+		constexpr static bool parallel_placement = !is_ordered::value && (is_stable<ValueTraits>::value || std::is_nothrow_move_constructible_v<I>);
+		constexpr static size_type min_partition_size = 4096;
+
+		enum class probe_result { found, available, escaped };
+
+		template<typename E>
+		[[nodiscard]] static size_type partition_count(const E &exec, size_type capacity)
+		{
+			const auto workers = static_cast<size_type>(exec.concurrency());
+			size_type parts = 1;
+			while (parts < workers * 4 && (capacity + 1) / (parts * 2) >= min_partition_size)
+				parts *= 2;
+			return workers > 1 ? parts : 1;
+		}
+
+		/* Probes the sequence of `h` within slots `[first, last)`. If `key` is not null, stops at an element with equal key. */
+		template<typename T>
+		std::pair<probe_result, size_type> probe_partition(const T *key, std::size_t h, size_type first, size_type last) const
+		{
+			const auto [h1, h2] = decompose_hash(h);
+			const auto *metadata = m_buffer.meta();
+			const auto *nodes = m_buffer.nodes();
+			auto slot = m_buffer.capacity;
+			for (auto probe = bucket_probe{h1 & m_buffer.capacity, m_buffer.capacity};; ++probe)
+			{
+				TPP_IF_UNLIKELY(probe.pos < first || probe.pos + sizeof(meta_block) > last)
+					return {probe_result::escaped, 0};
+
+				const auto block = meta_block(metadata + probe.pos);
+				if (key != nullptr)
+					for (auto match = block.match_eq(h2); !match.empty(); ++match)
+					{
+						const auto offset = probe.pos + match.lsb_index();
+						TPP_IF_LIKELY(cmp(nodes[offset].key(), *key))
+							return {probe_result::found, offset};
+					}
+
+				if (slot == m_buffer.capacity)
+					if (const auto available = block.match_available(); !available.empty())
+					{
+						slot = probe.pos + available.lsb_index();
+						if (key == nullptr) break;
+					}
+				TPP_IF_UNLIKELY(!block.match_empty().empty())
+					break;
+			}
+			return {probe_result::available, slot};
+		}
+
+		template<typename E>
+		void do_rehash(size_type capacity, const E &exec)
+		{
+			const auto parts = partition_count(exec, capacity);
+			if constexpr (parallel_placement)
+			{
+				if (parts < 2 || m_size < min_partition_size)
+					return do_rehash(capacity);
+			}
+			else
+				return do_rehash(capacity);
+
+			/* Sort occupied slots of the old buffer into per-slice lists of target partitions. This is done before the
+			 * buffer is replaced, so that allocation failure leaves the table unchanged. */
+			const auto part_size = (capacity + 1) / parts;
+			const auto src_cap = m_buffer.capacity;
+			mark_dirty_all();
+			std::vector<std::vector<size_type>> lists(parts * parts);
+			exec.bulk(parts, [&](std::size_t slice)
+			{
+				const auto *metadata = m_buffer.meta();
+				const auto *nodes = m_buffer.nodes();
+				for (auto i = src_cap * slice / parts, last = src_cap * (slice + 1) / parts; i < last; ++i)
+					if (is_occupied(metadata[i]))
+					{
+						const auto home = decompose_hash(nodes[i].hash()).first & capacity;
+						lists[slice * parts + home / part_size].push_back(i);
+					}
+			});
+
+			m_buffer.resize(capacity, [&](auto, auto src_nodes, size_type)
+			{
+				/* Relocation is noexcept, and `exec` is required to run every task, so all partitions are always processed. */
+				exec.bulk(parts, [&](std::size_t part)
+				{
+					auto alloc = node_allocator{get_allocator()};
+					for (size_type slice = 0; slice < parts; ++slice)
+					{
+						auto &list = lists[slice * parts + part];
+						auto escaped = list.begin();
+						for (const auto i: list)
+						{
+							auto *node = src_nodes + i;
+							const auto h = node->hash();
+							const auto [result, target_pos] = probe_partition<key_type>(nullptr, h, part * part_size, (part + 1) * part_size);
+							if (result == probe_result::escaped)
+							{
+								*escaped++ = i;
+								continue;
+							}
+							m_buffer.nodes()[target_pos].relocate(alloc, alloc, *node);
+							set_metadata(target_pos, decompose_hash(h).second);
+						}
+						list.erase(escaped, list.end());
+					}
+				});
+
+				auto alloc = node_allocator{get_allocator()};
+				for (auto &list: lists)
+					for (const auto i: list)
 					{
 						auto *node = src_nodes + i;
 						const auto h = node->hash();
@@ -1391,8 +1736,103 @@ namespace tpp::_detail
 			});
 			m_num_empty = capacity_to_max_size(capacity) - m_size;
 		}
-		void rehash_deleted()
+		template<typename E, typename Iter>
+		void do_parallel_insert(const E &exec, Iter first, size_type n)
+		{
+			reserve(m_size + n, exec);
+
+			const auto capacity = m_buffer.capacity;
+			const auto parts = partition_count(exec, capacity);
+			if (parts < 2 || n < min_partition_size)
+			{
+				for (size_type i = 0; i < n; ++i) insert(first[i]);
+				return;
+			}
+
+			/* Hash the elements & sort them into per-slice lists of target partitions. Slices are contiguous ranges of the input,
+			 * so concatenating the lists of a partition in slice order preserves the relative order of it's elements.
+			 * Dirty blocks can not be marked concurrently, so the entire table is marked instead. */
+			const auto part_size = (capacity + 1) / parts;
+			mark_dirty_all();
+			std::vector<std::size_t> hashes(n);
+			std::vector<std::vector<size_type>> lists(parts * parts);
+			std::vector<size_type> num_placed(parts), num_filled(parts);
+			exec.bulk(parts, [&](std::size_t slice)
+			{
+				for (auto i = n * slice / parts, last = n * (slice + 1) / parts; i < last; ++i)
+				{
+					const auto h = hashes[i] = hash(ValueTraits::get_key(first[i]));
+					const auto home = decompose_hash(h).first & capacity;
+					lists[slice * parts + home / part_size].push_back(i);
+				}
+			});
+
+			/* Sizes are updated even if construction of some elements has failed, in which case the inserted elements are kept. */
+			const auto apply_counts = [&]()
+			{
+				for (size_type part = 0; part < parts; ++part)
+				{
+					m_size += num_placed[part];
+					m_num_empty -= num_filled[part];
+				}
+			};
+			try
+			{
+				exec.bulk(parts, [&](std::size_t part)
+				{
+					auto alloc = value_allocator{get_allocator()};
+					for (size_type slice = 0; slice < parts; ++slice)
+					{
+						auto &list = lists[slice * parts + part];
+						auto escaped = list.begin();
+						for (const auto i: list)
+						{
+							const auto &value = first[i];
+							const auto &key = ValueTraits::get_key(value);
+							const auto h = hashes[i];
+							const auto [result, target_pos] = probe_partition(&key, h, part * part_size, (part + 1) * part_size);
+							if (result == probe_result::escaped)
+								*escaped++ = i;
+							else if (result == probe_result::available)
+							{
+								auto *target = m_buffer.nodes() + target_pos;
+								target->construct(alloc, value);
+								target->hash() = h;
+
+								num_filled[part] += m_buffer.meta()[target_pos] == meta_byte::empty;
+								set_metadata(target_pos, decompose_hash(h).second);
+								++num_placed[part];
+							}
+						}
+						list.erase(escaped, list.end());
+					}
+				});
+			}
+			catch (...)
+			{
+				apply_counts();
+				throw;
+			}
+			apply_counts();
+
+			/* Elements of a partition are placed in order, so equal keys that escaped their partition are resolved in order as well.
+			 * Insertion of escaped elements may reseed the hasher, after which the pre-computed hashes are no longer valid. */
+			const auto reseed_capacity = m_reseed_capacity;
+			for (size_type part = 0; part < parts; ++part)
+				for (size_type slice = 0; slice < parts; ++slice)
+					for (const auto i: lists[slice * parts + part])
+					{
+						const auto &value = first[i];
+						const auto &key = ValueTraits::get_key(value);
+						const auto h = m_reseed_capacity == reseed_capacity ? hashes[i] : hash(key);
+						if (const auto [target_pos, slot] = find_slot(key, h); target_pos == m_buffer.capacity)
+							emplace_node_at({}, h, slot, value);
+					}
+		}
+		/* If `track` is not null, it is updated with the new position of the node it refers to. */
+		void rehash_deleted(size_type *track = nullptr)
 		{
+			mark_dirty_all();
 			auto *metadata = m_buffer.meta(), *tail = m_buffer.meta() + m_buffer.capacity + 1;
 			auto *nodes = m_buffer.nodes();
 
@@ -1431,12 +1871,14 @@ namespace tpp::_detail
 						nodes[target_pos].relocate(alloc, alloc, *node);
 						set_metadata(i, meta_byte::empty);
 						set_metadata(target_pos, h2);
+						if (track && *track == i) *track = target_pos;
 					}
 					else
 					{
 						using std::swap;
 						swap(*node, nodes[target_pos]);
 						set_metadata(target_pos, h2);
+						if (track && (*track == i || *track == target_pos)) *track = *track == i ? target_pos : i;
 						goto process_node; /* Process the swapped-with node. */
 					}
 				}
@@ -1445,11 +1887,43 @@ namespace tpp::_detail
 			m_num_empty = capacity_to_max_size(m_buffer.capacity) - m_size;
 		}
 
+		/* Probe sequences of a uniformly distributed hash rarely exceed a few blocks, while keys crafted to collide make them grow linearly.
+		 * Sequences longer than the logarithm of the capacity are thus treated as an attack. Keys which collide regardless of the seed
+		 * are only reseeded once per capacity, so that the amortized cost of insertion remains constant. */
+		[[nodiscard]] bool is_probe_excessive(std::size_t h, size_type pos) const noexcept
+		{
+			const auto max_probes = log2(m_buffer.capacity + 1);
+			if (m_buffer.capacity == m_reseed_capacity || (m_buffer.capacity + 1) / sizeof(meta_block) <= max_probes)
+				return false;
+
+			/* Positions of the probe sequence only depend on the hash, thus metadata is not accessed. */
+			auto probe = bucket_probe{decompose_hash(h).first & m_buffer.capacity, m_buffer.capacity};
+			for (size_type n = 0; ((pos - probe.pos) & m_buffer.capacity) >= sizeof(meta_block); ++probe)
+				if (++n > max_probes) return true;
+			return false;
+		}
+		/* Replaces the seed of the hasher and re-inserts all nodes in-place. Returns the new position of the node at `pos`. */
+		size_type reseed_rehash(size_type pos) noexcept
+		{
+			hash_base::value().reseed();
+			m_reseed_capacity = m_buffer.capacity;
+
+			auto *metadata = m_buffer.meta();
+			auto *nodes = m_buffer.nodes();
+			for (size_type i = 0; i < m_buffer.capacity; ++i)
+				if (is_occupied(metadata[i])) nodes[i].hash() = hash(nodes[i].key());
+			rehash_deleted(&pos);
+			return pos;
+		}
+
 		void copy_data(const swiss_table &other)
 		{
 			/* Expect that there is no data in the buffers, but the buffers might still exist. */
 			TPP_ASSERT(m_size == 0, "Table must be empty prior to copying elements");
 
+			mark_dirty_all();
+			m_reseed_capacity = other.m_reseed_capacity;
+
 			/* Ignore empty tables. */
 			TPP_IF_UNLIKELY(other.m_size == 0)
 			{
@@ -1461,7 +1935,7 @@ namespace tpp::_detail
 			m_buffer.reallocate(other.m_buffer.capacity);
 			m_buffer.fill_empty();
 
-			/* Copy elements from the other table. */
+			/* Copy elements from the other table. Deleted entries are preserved, as they may be a part of a probe sequence. */
 			auto alloc = value_allocator{get_allocator()};
 			auto *nodes = m_buffer.nodes(), *other_nodes = other.m_buffer.nodes();
 			auto *other_metadata = other.m_buffer.meta();
@@ -1471,8 +1945,10 @@ namespace tpp::_detail
 					nodes[i].construct(alloc, other_nodes[i]);
 					set_metadata(i, other_metadata[i]);
 				}
+				else if (other_metadata[i] == meta_byte::deleted)
+					set_metadata(i, meta_byte::deleted);
 			m_size = other.m_size;
-			m_num_empty = capacity_to_max_size(m_buffer.capacity) - m_size;
+			m_num_empty = other.m_num_empty;
 
 			/* If the node link is ordered, update header offsets to point to the copied data. */
 			if constexpr (is_ordered::value)
@@ -1488,6 +1964,9 @@ namespace tpp::_detail
 			/* Expect that there is no data in the buffers, but the buffers might still exist. */
 			TPP_ASSERT(size() == 0, "Table must be empty prior to moving elements");
 
+			mark_dirty_all();
+			m_reseed_capacity = std::exchange(other.m_reseed_capacity, 0);
+
 			/* Ignore empty tables. */
 			TPP_IF_UNLIKELY(other.m_size == 0)
 			{
@@ -1511,10 +1990,13 @@ namespace tpp::_detail
 					dst_node->relocate(alloc, other_alloc, *src_node);
 					set_metadata(i, other_metadata[i]);
 				}
+				else if (other_metadata[i] == meta_byte::deleted)
+					set_metadata(i, meta_byte::deleted);
 			m_size = other.m_size;
-			m_num_empty = capacity_to_max_size(m_buffer.capacity) - m_size;
+			m_num_empty = other.m_num_empty;
 
 			/* Reset the other table. */
+			other.mark_dirty_all();
 			other.m_size = 0;
 			other.m_num_empty = capacity_to_max_size(other.m_buffer.capacity);
 			other.m_buffer.fill_empty();
@@ -1530,8 +2012,12 @@ namespace tpp::_detail
 		}
 		void swap_buffers(swiss_table &other)
 		{
+			/* Dirty tracking state belongs to the table object, and is not exchanged with the data. */
+			mark_dirty_all();
+			other.mark_dirty_all();
 			std::swap(m_size, other.m_size);
 			std::swap(m_num_empty, other.m_num_empty);
+			std::swap(m_reseed_capacity, other.m_reseed_capacity);
 			m_buffer.swap_data(other.m_buffer);
 		}
 		void move_from(swiss_table &other)
@@ -1545,5 +2031,6 @@ namespace tpp::_detail
 		size_type m_size = 0;       /* Amount of occupied nodes. */
 		size_type m_num_empty = 0;  /* Amount of empty entries we can still use. */
 		buffer_type m_buffer;
+		size_type m_reseed_capacity = 0; /* Capacity of the table when the hasher was last reseeded, exchanged together with the buffer. */
 	};
 }
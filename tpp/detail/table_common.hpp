@@ -169,8 +169,10 @@ namespace tpp::_detail
 		}
 		friend void swap(ordered_link &a, ordered_link &b) noexcept
 		{
-			auto a_next = a.off(a.next), b_next = b.off(b.next);
-			auto a_prev = a.off(a.prev), b_prev = b.off(b.prev);
+			/* If the links are adjacent, each becomes the neighbour of the other instead of itself. */
+			const auto replace = [](ordered_link *p, ordered_link *from, ordered_link *to) { return p == from ? to : p; };
+			auto a_next = replace(a.off(a.next), &b, &a), b_next = replace(b.off(b.next), &a, &b);
+			auto a_prev = replace(a.off(a.prev), &b, &a), b_prev = replace(b.off(b.prev), &a, &b);
 			a.link(b_next, b_prev);
 			b.link(a_next, a_prev);
 		}
@@ -256,7 +258,7 @@ namespace tpp::_detail
 			static_assert(std::is_constructible_v<mapped_t, Args...>);
 			new(&target) mapped_t(std::forward<Args>(args)...);
 		}
-		void destroy(A &alloc) { std::allocator_traits<allocator_type>::destroy(alloc, &value()); }
+		void destroy(allocator_type &alloc) { std::allocator_traits<allocator_type>::destroy(alloc, &value()); }
 
 		template<typename U>
 		void relocate(U &alloc_dst, U &alloc_src, packed_node &src)
@@ -292,7 +294,7 @@ namespace tpp::_detail
 		friend void swap(packed_node &a, packed_node &b) noexcept(std::is_nothrow_swappable_v<V>)
 		{
 			using std::swap;
-			a.link_base::swap(b);
+			swap(static_cast<link_base &>(a), static_cast<link_base &>(b));
 			swap(a.value(), b.value());
 			swap(a.hash(), b.hash());
 		}
@@ -379,7 +381,7 @@ namespace tpp::_detail
 			{
 				if (m_ptr)
 				{
-					std::allocator_traits<allocator_type>::destroy(alloc(), m_ptr);
+					std::allocator_traits<allocator_type>::destroy(alloc(), to_address(m_ptr));
 					std::allocator_traits<allocator_type>::deallocate(alloc(), m_ptr, 1);
 				}
 			}
@@ -446,7 +448,7 @@ namespace tpp::_detail
 		void construct(allocator_type &alloc, Args &&...args)
 		{
 			m_ptr = std::allocator_traits<allocator_type>::allocate(alloc, 1);
-			std::allocator_traits<allocator_type>::construct(alloc, m_ptr, std::forward<Args>(args)...);
+			std::allocator_traits<allocator_type>::construct(alloc, to_address(m_ptr), std::forward<Args>(args)...);
 		}
 		template<typename... Args>
 		void replace(Args &&...args)
@@ -460,11 +462,11 @@ namespace tpp::_detail
 			static_assert(std::is_constructible_v<mapped_t, Args...>);
 			new(&target) mapped_t(std::forward<Args>(args)...);
 		}
-		void destroy(A &alloc)
+		void destroy(allocator_type &alloc)
 		{
 			if (m_ptr)
 			{
-				std::allocator_traits<allocator_type>::destroy(alloc, m_ptr);
+				std::allocator_traits<allocator_type>::destroy(alloc, to_address(m_ptr));
 				std::allocator_traits<allocator_type>::deallocate(alloc, m_ptr, 1);
 				m_ptr = value_ptr{};
 			}
@@ -491,7 +493,7 @@ namespace tpp::_detail
 		constexpr friend void swap(stable_node &a, stable_node &b) noexcept
 		{
 			using std::swap;
-			a.link_base::swap(b);
+			swap(static_cast<link_base &>(a), static_cast<link_base &>(b));
 			swap(a.m_ptr, b.m_ptr);
 			swap(a.m_hash, b.m_hash);
 		}
@@ -514,6 +516,37 @@ namespace tpp::_detail
 	template<typename T>
 	struct is_extractable<T, std::void_t<typename T::is_extractable>> : std::true_type {};
 
+	template<typename T>
+	using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
+
+	template<typename, typename>
+	struct is_key_pair : std::false_type {};
+	template<typename K, typename M>
+	struct is_key_pair<std::pair<K, M>, K> : std::true_type {};
+
+	/* Helper used to obtain the key from emplace arguments without constructing the value. Only arguments of the exact
+	 * key type are accepted, as conversion to the key type could otherwise produce a different key. */
+	template<typename I, typename K>
+	struct key_extractor
+	{
+		/* Sets are constructed from the key itself. */
+		template<typename T, typename = std::enable_if_t<std::is_same_v<I, K> && std::is_same_v<remove_cvref_t<T>, K>>>
+		[[nodiscard]] static constexpr const K &get(const T &key) noexcept { return key; }
+
+		/* Maps are constructed from a key-mapped pair, a key and mapped arguments, or piecewise. */
+		template<typename T, typename U, typename = std::enable_if_t<is_key_pair<I, K>::value && std::is_same_v<remove_cvref_t<T>, K>>>
+		[[nodiscard]] static constexpr const K &get(const std::pair<T, U> &value) noexcept { return value.first; }
+		template<typename T, typename U, typename = std::enable_if_t<is_key_pair<I, K>::value && std::is_same_v<remove_cvref_t<T>, K>>>
+		[[nodiscard]] static constexpr const K &get(const T &key, const U &) noexcept { return key; }
+		template<typename T, typename... Us, typename = std::enable_if_t<is_key_pair<I, K>::value && std::is_same_v<remove_cvref_t<T>, K>>>
+		[[nodiscard]] static constexpr const K &get(std::piecewise_construct_t, const std::tuple<T> &key, const std::tuple<Us...> &) noexcept { return std::get<0>(key); }
+	};
+
+	template<typename, typename, typename = void>
+	struct is_key_extractable : std::false_type {};
+	template<typename E, typename... Args>
+	struct is_key_extractable<E, std::tuple<Args...>, std::void_t<decltype(E::get(std::declval<const Args &>()...))>> : std::true_type {};
+
 	template<typename N, typename A>
 	struct ordered_iterator
 	{
@@ -538,6 +571,9 @@ namespace tpp::_detail
 
 		constexpr explicit ordered_iterator(link_ptr link) noexcept : link(link) {}
 		constexpr explicit ordered_iterator(node_ptr node) noexcept : ordered_iterator(link_ptr{node}) {}
+		/* Raw node pointers would otherwise be ambiguous between `link_ptr` and `node_ptr` for fancy pointers. */
+		template<typename P, typename = std::enable_if_t<std::is_same_v<P, N *> && !std::is_same_v<P, node_ptr>>>
+		constexpr explicit ordered_iterator(P node) noexcept : ordered_iterator(node_ptr{node}) {}
 
 		ordered_iterator operator++(int) noexcept
 		{
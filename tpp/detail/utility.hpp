@@ -173,8 +173,8 @@ namespace tpp::_detail
 	[[nodiscard]] inline std::array<T, Size> make_array(const T &value) noexcept { return make_array(std::make_index_sequence<Size>{}, value); }
 
 #if (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
-	template<typename P>
-	[[nodiscard]] inline decltype(auto) to_address(const P &p) noexcept { return std::to_address(p); }
+	/* Using-declaration instead of a wrapper, as a wrapper would be ambiguous with `std::to_address` found via ADL. */
+	using std::to_address;
 #else
 	template<typename>
 	struct true_helper : std::true_type {};
@@ -197,6 +197,49 @@ namespace tpp::_detail
 	}
 #endif
 
+	/* Size of a cache line used to pad shared state of concurrent containers. 64 bytes is used instead of
+	 * `std::hardware_destructive_interference_size`, as the latter is not consistently available. */
+	inline constexpr std::size_t cache_line_size = 64;
+
+	/* Fractional part of the golden ratio, used for multiplicative (Fibonacci) hashing. */
+	inline constexpr std::size_t golden_ratio = static_cast<std::size_t>(sizeof(std::size_t) > 4 ? 0x9e3779b97f4a7c15ull : 0x9e3779b9ull);
+
+	/** Returns the high half of the full-width product of `a` and `b`. */
+	template<typename T>
+	[[nodiscard]] constexpr TPP_FORCEINLINE std::enable_if_t<std::is_unsigned_v<T>, T> mul_hi(T a, T b) noexcept
+	{
+		if constexpr (sizeof(T) <= 4)
+			return static_cast<T>((static_cast<std::uint64_t>(a) * static_cast<std::uint64_t>(b)) >> (sizeof(T) * 8));
+		else
+		{
+			static_assert(sizeof(T) == 8, "Unsupported integer width");
+#if defined(__SIZEOF_INT128__)
+			__extension__ using uint128_t = unsigned __int128;
+			return static_cast<T>((static_cast<uint128_t>(a) * static_cast<uint128_t>(b)) >> 64);
+#else
+			const auto a_lo = a & 0xffff'ffff, a_hi = a >> 32;
+			const auto b_lo = b & 0xffff'ffff, b_hi = b >> 32;
+			const auto lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+			const auto cross = (lo_lo >> 32) + (hi_lo & 0xffff'ffff) + lo_hi;
+			return hi_hi + (hi_lo >> 32) + (cross >> 32);
+#endif
+		}
+	}
+	/* Helper used to check if a hash functor can change it's seed (see `seeded_hash`). Tables using such hashers may reseed them,
+	 * thus hashes computed by a copy of the hasher must not be passed to the table. */
+	template<typename, typename = void>
+	struct is_reseedable : std::false_type {};
+	template<typename T>
+	struct is_reseedable<T, std::void_t<decltype(std::declval<T &>().reseed())>> : std::true_type {};
+
+	/** Returns the base-2 logarithm of `n`, rounded down. */
+	[[nodiscard]] constexpr std::size_t log2(std::size_t n) noexcept
+	{
+		std::size_t result = 0;
+		while (n >>= 1) ++result;
+		return result;
+	}
+
 	template<typename Iter, typename Size>
 	[[nodiscard]] inline Size distance_or_n(const Iter &first, const Iter &last, Size n) noexcept
 	{
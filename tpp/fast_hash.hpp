@@ -0,0 +1,340 @@
+/*
+ * Created by switchblade on 2023-01-30.
+ */
+
+#pragma once
+
+#include <string_view>
+#include <iterator>
+#include <cstring>
+#include <string>
+
+#include "detail/utility.hpp"
+
+/* Accelerated hashing requires 64-bit CRC32C & `cvtsi128_si64` instructions, thus is only available on x86-64. */
+#if defined(TPP_ARCH_X64) && !defined(TPP_NO_SIMD) && (defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__))
+#define TPP_FAST_HASH_X64
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#include <cpuid.h>
+#endif
+#endif
+
+namespace tpp
+{
+	namespace _detail
+	{
+		/* Constants from wyhash (https://github.com/wangyi-fudan/wyhash), which are also used to initialize the accelerated variants. */
+		inline constexpr std::uint64_t hash_secret[4] = {0xa076'1d64'78bd'642full, 0xe703'7ed1'a0b4'28dbull, 0x8ebc'6af0'9c88'c6e3ull, 0x5899'65cc'7537'4cc3ull};
+
+		/* Folded multiply, XOR of the low & high halves of the 128-bit product. */
+		[[nodiscard]] constexpr TPP_FORCEINLINE std::uint64_t mul_fold(std::uint64_t a, std::uint64_t b) noexcept { return (a * b) ^ mul_hi<std::uint64_t>(a, b); }
+
+		[[nodiscard]] inline std::uint64_t read_u64(const unsigned char *p) noexcept
+		{
+			std::uint64_t result;
+			std::memcpy(&result, p, sizeof(result));
+			return result;
+		}
+		[[nodiscard]] inline std::uint32_t read_u32(const unsigned char *p) noexcept
+		{
+			std::uint32_t result;
+			std::memcpy(&result, p, sizeof(result));
+			return result;
+		}
+		/* Reads 1 to 3 bytes, such that every byte is used at least once. */
+		[[nodiscard]] inline std::uint32_t read_small(const unsigned char *p, std::size_t n) noexcept
+		{
+			return (std::uint32_t{p[0]} << 16) | (std::uint32_t{p[n >> 1]} << 8) | p[n - 1];
+		}
+
+		[[nodiscard]] constexpr std::uint64_t hash_u64(std::uint64_t value, std::uint64_t seed) noexcept
+		{
+			return mul_fold(value ^ seed ^ hash_secret[0], hash_secret[1]);
+		}
+
+		/* Portable implementation is a variant of wyhash. Inputs of up to 16 bytes are read via (possibly overlapping) loads
+		 * from both ends, and longer inputs are consumed in 16-byte (or 48-byte, using 3 independent lanes) blocks. */
+		[[nodiscard]] inline std::uint64_t hash_bytes_portable(const unsigned char *p, std::size_t n, std::uint64_t seed) noexcept
+		{
+			const auto *s = hash_secret;
+			seed ^= mul_fold(seed ^ s[0], s[1]);
+
+			std::uint64_t a = 0, b = 0;
+			if (n <= 16)
+			{
+				if (n >= 4)
+				{
+					const auto off = (n >> 3) << 2;
+					a = (std::uint64_t{read_u32(p)} << 32) | read_u32(p + off);
+					b = (std::uint64_t{read_u32(p + n - 4)} << 32) | read_u32(p + n - 4 - off);
+				}
+				else if (n > 0)
+					a = read_small(p, n);
+			}
+			else
+			{
+				auto i = n;
+				if (i > 48)
+				{
+					auto s1 = seed, s2 = seed;
+					do
+					{
+						seed = mul_fold(read_u64(p) ^ s[1], read_u64(p + 8) ^ seed);
+						s1 = mul_fold(read_u64(p + 16) ^ s[2], read_u64(p + 24) ^ s1);
+						s2 = mul_fold(read_u64(p + 32) ^ s[3], read_u64(p + 40) ^ s2);
+						p += 48;
+						i -= 48;
+					} while (i > 48);
+					seed ^= s1 ^ s2;
+				}
+				for (; i > 16; p += 16, i -= 16)
+					seed = mul_fold(read_u64(p) ^ s[1], read_u64(p + 8) ^ seed);
+				a = read_u64(p + i - 16);
+				b = read_u64(p + i - 8);
+			}
+
+			a ^= s[1];
+			b ^= seed;
+			return mul_fold((a * b) ^ s[0] ^ n, mul_hi<std::uint64_t>(a, b) ^ s[1]);
+		}
+
+#ifdef TPP_FAST_HASH_X64
+		/* Unaligned 16-byte loads are a part of SSE2, which is always available on x86-64. */
+		[[nodiscard]] inline __m128i read_u128(const unsigned char *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+
+		/* CRC32C implementation consumes 8-byte words by 2 (or 4 for inputs over 32 bytes) independent CRC lanes, which hides the
+		 * latency of the `crc32` instruction. CRC is linear and only produces 32 bits per lane, thus lanes are combined & mixed by
+		 * a folded multiply. Words are keyed by a folded multiply with the seed before they are consumed, since inputs whose CRC
+		 * differences cancel out would otherwise collide regardless of the seed. */
+		[[nodiscard]] TPP_TARGET("sse4.2") inline std::uint64_t hash_bytes_crc32c(const unsigned char *p, std::size_t n, std::uint64_t seed) noexcept
+		{
+			const auto *s = hash_secret;
+			const auto *end = p + n;
+
+			seed ^= mul_fold(seed ^ s[0], s[1]);
+			const auto key = [k = seed ^ s[2]](std::uint64_t word) noexcept { return mul_fold(word ^ k, hash_secret[3]); };
+
+			std::uint64_t a = seed ^ s[0], b = (seed >> 32) ^ s[1];
+			if (n > 16)
+			{
+				if (n > 32)
+				{
+					std::uint64_t c = a ^ s[2], d = b ^ s[3];
+					do
+					{
+						a = _mm_crc32_u64(a, key(read_u64(p)));
+						b = _mm_crc32_u64(b, key(read_u64(p + 8)));
+						c = _mm_crc32_u64(c, key(read_u64(p + 16)));
+						d = _mm_crc32_u64(d, key(read_u64(p + 24)));
+						p += 32;
+					} while (end - p > 32);
+					a = _mm_crc32_u64(a, c);
+					b = _mm_crc32_u64(b, d);
+				}
+				if (end - p > 16)
+				{
+					a = _mm_crc32_u64(a, key(read_u64(p)));
+					b = _mm_crc32_u64(b, key(read_u64(p + 8)));
+				}
+				a = _mm_crc32_u64(a, key(read_u64(end - 16)));
+				b = _mm_crc32_u64(b, key(read_u64(end - 8)));
+			}
+			else if (n >= 8)
+			{
+				a = _mm_crc32_u64(a, key(read_u64(p)));
+				b = _mm_crc32_u64(b, key(read_u64(end - 8)));
+			}
+			else if (n >= 4)
+			{
+				a = _mm_crc32_u64(a, key(read_u32(p)));
+				b = _mm_crc32_u64(b, key(read_u32(end - 4)));
+			}
+			else if (n > 0)
+				a = _mm_crc32_u64(a, key(read_small(p, n)));
+
+			return mul_fold(((a << 32) | (b & 0xffff'ffff)) ^ s[2], n ^ seed ^ s[3]);
+		}
+
+		/* AES implementation uses the input blocks as round keys of `aesenc`, with 4 independent lanes for inputs over 64 bytes.
+		 * Three finalization rounds diffuse every input byte over the entire state. */
+		[[nodiscard]] TPP_TARGET("aes") inline std::uint64_t hash_bytes_aes(const unsigned char *p, std::size_t n, std::uint64_t seed) noexcept
+		{
+			const auto *s = hash_secret;
+			const auto *end = p + n;
+			const auto key0 = _mm_set_epi64x(static_cast<long long>(s[1]), static_cast<long long>(s[0]));
+			const auto key1 = _mm_set_epi64x(static_cast<long long>(s[3]), static_cast<long long>(s[2]));
+
+			auto acc = _mm_set_epi64x(static_cast<long long>(n ^ s[2]), static_cast<long long>(seed ^ s[3]));
+			if (n > 16)
+			{
+				if (n > 64)
+				{
+					auto b = _mm_xor_si128(acc, key0), c = _mm_xor_si128(acc, key1), d = _mm_aesenc_si128(acc, key0);
+					do
+					{
+						acc = _mm_aesenc_si128(acc, read_u128(p));
+						b = _mm_aesenc_si128(b, read_u128(p + 16));
+						c = _mm_aesenc_si128(c, read_u128(p + 32));
+						d = _mm_aesenc_si128(d, read_u128(p + 48));
+						p += 64;
+					} while (end - p > 64);
+					acc = _mm_aesenc_si128(_mm_aesenc_si128(acc, b), _mm_aesenc_si128(c, d));
+				}
+				for (; end - p > 16; p += 16)
+					acc = _mm_aesenc_si128(acc, read_u128(p));
+				acc = _mm_aesenc_si128(acc, read_u128(end - 16));
+			}
+			else if (n > 0)
+			{
+				__m128i block;
+				if (n >= 8)
+					block = _mm_set_epi64x(static_cast<long long>(read_u64(end - 8)), static_cast<long long>(read_u64(p)));
+				else if (n >= 4)
+					block = _mm_set_epi64x(static_cast<long long>(read_u32(end - 4)), static_cast<long long>(read_u32(p)));
+				else
+					block = _mm_set_epi64x(0, static_cast<long long>(read_small(p, n)));
+				acc = _mm_aesenc_si128(acc, block);
+			}
+
+			acc = _mm_aesenc_si128(acc, key0);
+			acc = _mm_aesenc_si128(acc, key1);
+			acc = _mm_aesenc_si128(acc, key0);
+			return static_cast<std::uint64_t>(_mm_cvtsi128_si64(acc)) ^ static_cast<std::uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc)));
+		}
+#endif
+
+		enum class hash_isa : std::uint8_t { portable, crc32c, aes };
+
+		[[nodiscard]] inline hash_isa detect_hash_isa() noexcept
+		{
+#ifdef TPP_FAST_HASH_X64
+			/* AES-NI & SSE4.2 support is reported by bits 25 & 20 of ECX for CPUID leaf 1. */
+			unsigned int ecx = 0;
+#ifdef _MSC_VER
+			int regs[4];
+			__cpuid(regs, 1);
+			ecx = static_cast<unsigned int>(regs[2]);
+#else
+			unsigned int eax, ebx, edx;
+			if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+				return hash_isa::portable;
+#endif
+			if (ecx & (1u << 25))
+				return hash_isa::aes;
+			if (ecx & (1u << 20))
+				return hash_isa::crc32c;
+#endif
+			return hash_isa::portable;
+		}
+		/* Instruction set is detected once, and is the same for every table of the process. */
+		[[nodiscard]] inline hash_isa fast_hash_isa() noexcept
+		{
+			static const auto isa = detect_hash_isa();
+			return isa;
+		}
+
+		[[nodiscard]] inline std::uint64_t hash_bytes(const void *data, std::size_t n, std::uint64_t seed) noexcept
+		{
+			const auto *p = static_cast<const unsigned char *>(data);
+#if defined(TPP_FAST_HASH_X64) && defined(TPP_HAS_AES)
+			return hash_bytes_aes(p, n, seed);
+#else
+#ifdef TPP_FAST_HASH_X64
+			switch (fast_hash_isa())
+			{
+				case hash_isa::aes: return hash_bytes_aes(p, n, seed);
+				case hash_isa::crc32c: return hash_bytes_crc32c(p, n, seed);
+				default: break;
+			}
+#endif
+			return hash_bytes_portable(p, n, seed);
+#endif
+		}
+
+		[[nodiscard]] constexpr std::size_t to_size_hash(std::uint64_t h) noexcept
+		{
+			if constexpr (sizeof(std::size_t) < sizeof(std::uint64_t))
+				return static_cast<std::size_t>(h ^ (h >> 32));
+			else
+				return static_cast<std::size_t>(h);
+		}
+
+		template<typename T, typename = void>
+		struct is_contiguous_bytes : std::false_type {};
+		template<typename T>
+		struct is_contiguous_bytes<T, std::void_t<decltype(std::data(std::declval<const T &>())), decltype(std::size(std::declval<const T &>()))>>
+				: std::bool_constant<std::has_unique_object_representations_v<std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<const T &>()))>>>> {};
+	}
+
+	/** @brief Fast non-cryptographic hash functor for integers, enums, pointers & strings.
+	 *
+	 * Integers are hashed via a folded 64-bit multiply. Strings are hashed using the fastest implementation supported by
+	 * the CPU, which is selected at run time (unless the library is compiled with AES-NI enabled): AES-NI rounds, SSE4.2 CRC32C,
+	 * or a portable multiply-based fallback. All bits of the result are mixed, thus it is suitable for tables which use both
+	 * the high & low bits of the hash (ex. swiss tables, which use the low 7 bits as metadata tags).
+	 *
+	 * @note Hash values depend on the byte order and instruction set of the CPU, and must not be persisted or sent to other machines.
+	 * As a consequence, binary snapshots of tables using `fast_hash` can only be loaded on a CPU with the same instruction set. */
+	template<typename T, typename = void>
+	struct fast_hash;
+
+	template<typename T>
+	struct fast_hash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>>>
+	{
+		[[nodiscard]] constexpr std::size_t operator()(T value) const noexcept { return operator()(value, 0); }
+		/** Returns hash of `value` mixed with `seed`. */
+		[[nodiscard]] constexpr std::size_t operator()(T value, std::uint64_t seed) const noexcept
+		{
+			if constexpr (std::is_pointer_v<T>)
+				return _detail::to_size_hash(_detail::hash_u64(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value)), seed));
+			else if constexpr (std::is_enum_v<T>)
+				return _detail::to_size_hash(_detail::hash_u64(static_cast<std::uint64_t>(static_cast<std::underlying_type_t<T>>(value)), seed));
+			else
+				return _detail::to_size_hash(_detail::hash_u64(static_cast<std::uint64_t>(value), seed));
+		}
+	};
+	template<typename C, typename Traits>
+	struct fast_hash<std::basic_string_view<C, Traits>>
+	{
+		/** String hashes are transparent, so that strings can be looked up by views & C strings without conversion. */
+		using is_transparent = std::true_type;
+
+		[[nodiscard]] std::size_t operator()(std::basic_string_view<C, Traits> str) const noexcept { return operator()(str, 0); }
+		/** Returns hash of `str` mixed with `seed`. */
+		[[nodiscard]] std::size_t operator()(std::basic_string_view<C, Traits> str, std::uint64_t seed) const noexcept
+		{
+			return _detail::to_size_hash(_detail::hash_bytes(str.data(), str.size() * sizeof(C), seed));
+		}
+	};
+	template<typename C, typename Traits, typename Alloc>
+	struct fast_hash<std::basic_string<C, Traits, Alloc>> : fast_hash<std::basic_string_view<C, Traits>> {};
+
+	/** @brief Hash functor adapter, which hashes the object representation of contiguous data via `fast_hash`.
+	 *
+	 * If `T` has a unique object representation (ex. structures of integers without padding), bytes of the object are hashed.
+	 * Otherwise, `T` must be a contiguous range (ex. `std::vector` or `std::array`) of such elements, and bytes of it's elements are hashed.
+	 * Objects with equal bytes are required to compare equal. */
+	template<typename T>
+	struct bytes_hash
+	{
+		static_assert(std::has_unique_object_representations_v<T> || _detail::is_contiguous_bytes<T>::value,
+		              "bytes_hash requires a type with unique object representation, or a contiguous range of such elements");
+
+		[[nodiscard]] std::size_t operator()(const T &value) const noexcept { return operator()(value, 0); }
+		/** Returns hash of `value` mixed with `seed`. */
+		[[nodiscard]] std::size_t operator()(const T &value, std::uint64_t seed) const noexcept
+		{
+			if constexpr (std::has_unique_object_representations_v<T>)
+				return _detail::to_size_hash(_detail::hash_bytes(&value, sizeof(T), seed));
+			else
+			{
+				const auto size = static_cast<std::size_t>(std::size(value));
+				return _detail::to_size_hash(_detail::hash_bytes(std::data(value), size * sizeof(*std::data(value)), seed));
+			}
+		}
+	};
+}
@@ -0,0 +1,148 @@
+/*
+ * Created by switchblade on 2023-01-28.
+ */
+
+#pragma once
+
+#include "detail/frozen_table.hpp"
+
+namespace tpp
+{
+	/** @brief Read-only hash map indexed by a perfect hash function.
+	 *
+	 * Frozen map is built once from a range of elements (or from another map via `freeze`), and can not be modified afterwards.
+	 * Elements are stored in a single flat array, and are indexed by a PTHash-style perfect hash function, which requires ~8 bits
+	 * per element. Every lookup accesses exactly one pilot and one element, and performs a single key comparison, regardless of
+	 * whether the key is present. Element array contains ~1.5% unused slots to speed up construction of the hash function.
+	 *
+	 * @note Keys of the map must have unique hashes, since the hash function is built from the output of `KeyHash`.
+	 * @tparam Key Key type stored by the map.
+	 * @tparam Mapped Mapped type associated with map keys.
+	 * @tparam KeyHash Hash functor used by the map.
+	 * @tparam KeyCmp Compare functor used by the map.
+	 * @tparam Alloc Allocator used by the map. */
+	template<typename Key, typename Mapped, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<std::pair<Key, Mapped>>>
+	class frozen_map
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Mapped;
+		/* Elements are never modified, and can thus be stored as `std::pair<Key, Mapped>`. */
+		using value_type = std::pair<key_type, mapped_type>;
+
+	private:
+		struct traits_t
+		{
+			template<typename T>
+			static constexpr auto &get_key(T &value) noexcept { return value.first; }
+			/* Elements of sparse maps are pairs of references, and must be converted element-wise. */
+			template<typename T>
+			static constexpr value_type make_value(const T &value) { return value_type{value.first, value.second}; }
+		};
+
+		using table_t = _detail::frozen_table<value_type, key_type, KeyHash, KeyCmp, Alloc, traits_t>;
+
+	public:
+		using reference = const value_type &;
+		using const_reference = const value_type &;
+		using pointer = const value_type *;
+		using const_pointer = const value_type *;
+
+		using iterator = typename table_t::const_iterator;
+		using const_iterator = typename table_t::const_iterator;
+
+		using size_type = typename table_t::size_type;
+		using difference_type = typename table_t::difference_type;
+
+		using hasher = typename table_t::hasher;
+		using key_equal = typename table_t::key_equal;
+		using allocator_type = typename table_t::allocator_type;
+
+	public:
+		/** Initializes an empty map. */
+		frozen_map() = default;
+		/** Initializes an empty map using the specified hasher, comparator and allocator. */
+		explicit frozen_map(const hasher &hash, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{}) : m_table(hash, cmp, alloc) {}
+
+		/** Initializes the map with an initializer list of elements. If multiple elements have equal keys, only the first one is inserted.
+		 * @throw std::invalid_argument If different keys have equal hashes.
+		 * @throw std::runtime_error If the perfect hash function could not be built. */
+		frozen_map(std::initializer_list<value_type> il, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+				: frozen_map(il.begin(), il.end(), hash, cmp, alloc) {}
+		/** Initializes the map with a range of elements. If multiple elements have equal keys, only the first one is inserted.
+		 * @throw std::invalid_argument If different keys have equal hashes.
+		 * @throw std::runtime_error If the perfect hash function could not be built. */
+		template<typename I>
+		frozen_map(I first, I last, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+				: m_table(first, last, hash, cmp, alloc) {}
+
+		/** Returns iterator to the first element of the map. */
+		[[nodiscard]] const_iterator begin() const noexcept { return m_table.begin(); }
+		/** @copydoc begin */
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		/** Returns iterator one past the last element of the map. */
+		[[nodiscard]] const_iterator end() const noexcept { return m_table.end(); }
+		/** @copydoc end */
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		/** Returns the amount of elements within the map. */
+		[[nodiscard]] constexpr size_type size() const noexcept { return m_table.size(); }
+		/** Checks if the map is empty. */
+		[[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+		/** Returns the amount of element slots of the map (including the unused ones). */
+		[[nodiscard]] size_type bucket_count() const noexcept { return m_table.bucket_count(); }
+		/** Returns the total amount of memory used by the element array & the hash function. */
+		[[nodiscard]] size_type memory_usage() const noexcept { return m_table.memory_usage(); }
+
+		/** Searches for an element with the specified key within the map.
+		 * @return Iterator to the element, or the end iterator if the element was not found. */
+		[[nodiscard]] const_iterator find(const key_type &key) const { return m_table.find(key); }
+		/** Checks if an element with the specified key is present within the map. */
+		[[nodiscard]] bool contains(const key_type &key) const { return m_table.contains(key); }
+		/** Returns the amount of elements with the specified key (0 or 1). */
+		[[nodiscard]] size_type count(const key_type &key) const { return contains(key); }
+		/** Returns reference to the mapped object of the specified element.
+		 * @throw std::out_of_range If no such element exists within the map. */
+		[[nodiscard]] const mapped_type &at(const key_type &key) const
+		{
+			const auto pos = find(key);
+			if (pos == end())
+				throw std::out_of_range("`frozen_map::at` - invalid key");
+			return pos->second;
+		}
+
+		/** Writes a binary snapshot of the map to output stream `os`. Snapshot contains the hash function & the element array,
+		 * and can be restored via `load` without re-building the hash function.
+		 * @note Only available if the key & mapped types are trivially copyable.
+		 * @note Snapshots use native byte order & layout, and are only compatible with maps of the same type and hash function.
+		 * @throw snapshot_error If the snapshot could not be written. */
+		template<typename S>
+		void save(S &os) const { m_table.save(os); }
+		/** Replaces contents of the map with a snapshot read from input stream `is`. If the snapshot is not compatible
+		 * with the map or is corrupted, the map is left unchanged.
+		 * @throw snapshot_error If the snapshot could not be read or validated. */
+		template<typename S>
+		void load(S &is) { m_table.load(is); }
+
+		[[nodiscard]] allocator_type get_allocator() const { return m_table.get_allocator(); }
+		[[nodiscard]] hasher hash_function() const { return m_table.get_hash(); }
+		[[nodiscard]] key_equal key_eq() const { return m_table.get_cmp(); }
+
+		void swap(frozen_map &other) noexcept(std::is_nothrow_swappable_v<table_t>) { m_table.swap(other.m_table); }
+
+	private:
+		table_t m_table;
+	};
+
+	template<typename K, typename M, typename H, typename C, typename A>
+	inline void swap(frozen_map<K, M, H, C, A> &a, frozen_map<K, M, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+	/** Builds a frozen map from elements of map \p map, using hasher & comparator of \p map.
+	 * @throw std::invalid_argument If different keys of the map have equal hashes.
+	 * @throw std::runtime_error If the perfect hash function could not be built. */
+	template<typename M, typename = std::enable_if_t<_detail::has_mapped_type<M>::value>>
+	[[nodiscard]] inline frozen_map<typename M::key_type, typename M::mapped_type, typename M::hasher, typename M::key_equal> freeze(const M &map)
+	{
+		return {map.begin(), map.end(), map.hash_function(), map.key_eq()};
+	}
+}
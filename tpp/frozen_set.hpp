@@ -0,0 +1,133 @@
+/*
+ * Created by switchblade on 2023-01-28.
+ */
+
+#pragma once
+
+#include "detail/frozen_table.hpp"
+
+namespace tpp
+{
+	/** @brief Read-only hash set indexed by a perfect hash function.
+	 *
+	 * Frozen set is built once from a range of keys (or from another set via `freeze`), and can not be modified afterwards.
+	 * See `frozen_map` for details on the layout of the set.
+	 *
+	 * @note Keys of the set must have unique hashes, since the hash function is built from the output of `KeyHash`.
+	 * @tparam Key Key type stored by the set.
+	 * @tparam KeyHash Hash functor used by the set.
+	 * @tparam KeyCmp Compare functor used by the set.
+	 * @tparam Alloc Allocator used by the set. */
+	template<typename Key, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>, typename Alloc = std::allocator<Key>>
+	class frozen_set
+	{
+	public:
+		using key_type = Key;
+		using value_type = key_type;
+
+	private:
+		struct traits_t
+		{
+			template<typename T>
+			static constexpr auto &get_key(T &value) noexcept { return value; }
+			template<typename T>
+			static constexpr value_type make_value(const T &value) { return value_type{value}; }
+		};
+
+		using table_t = _detail::frozen_table<value_type, key_type, KeyHash, KeyCmp, Alloc, traits_t>;
+
+	public:
+		using reference = const value_type &;
+		using const_reference = const value_type &;
+		using pointer = const value_type *;
+		using const_pointer = const value_type *;
+
+		using iterator = typename table_t::const_iterator;
+		using const_iterator = typename table_t::const_iterator;
+
+		using size_type = typename table_t::size_type;
+		using difference_type = typename table_t::difference_type;
+
+		using hasher = typename table_t::hasher;
+		using key_equal = typename table_t::key_equal;
+		using allocator_type = typename table_t::allocator_type;
+
+	public:
+		/** Initializes an empty set. */
+		frozen_set() = default;
+		/** Initializes an empty set using the specified hasher, comparator and allocator. */
+		explicit frozen_set(const hasher &hash, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{}) : m_table(hash, cmp, alloc) {}
+
+		/** Initializes the set with an initializer list of keys. Duplicate keys are ignored.
+		 * @throw std::invalid_argument If different keys have equal hashes.
+		 * @throw std::runtime_error If the perfect hash function could not be built. */
+		frozen_set(std::initializer_list<value_type> il, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+				: frozen_set(il.begin(), il.end(), hash, cmp, alloc) {}
+		/** Initializes the set with a range of keys. Duplicate keys are ignored.
+		 * @throw std::invalid_argument If different keys have equal hashes.
+		 * @throw std::runtime_error If the perfect hash function could not be built. */
+		template<typename I>
+		frozen_set(I first, I last, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+				: m_table(first, last, hash, cmp, alloc) {}
+
+		/** Returns iterator to the first element of the set. */
+		[[nodiscard]] const_iterator begin() const noexcept { return m_table.begin(); }
+		/** @copydoc begin */
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		/** Returns iterator one past the last element of the set. */
+		[[nodiscard]] const_iterator end() const noexcept { return m_table.end(); }
+		/** @copydoc end */
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		/** Returns the amount of elements within the set. */
+		[[nodiscard]] constexpr size_type size() const noexcept { return m_table.size(); }
+		/** Checks if the set is empty. */
+		[[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+		/** Returns the amount of element slots of the set (including the unused ones). */
+		[[nodiscard]] size_type bucket_count() const noexcept { return m_table.bucket_count(); }
+		/** Returns the total amount of memory used by the element array & the hash function. */
+		[[nodiscard]] size_type memory_usage() const noexcept { return m_table.memory_usage(); }
+
+		/** Searches for the specified key within the set.
+		 * @return Iterator to the element, or the end iterator if the element was not found. */
+		[[nodiscard]] const_iterator find(const key_type &key) const { return m_table.find(key); }
+		/** Checks if the specified key is present within the set. */
+		[[nodiscard]] bool contains(const key_type &key) const { return m_table.contains(key); }
+		/** Returns the amount of elements with the specified key (0 or 1). */
+		[[nodiscard]] size_type count(const key_type &key) const { return contains(key); }
+
+		/** Writes a binary snapshot of the set to output stream `os`. Snapshot contains the hash function & the element array,
+		 * and can be restored via `load` without re-building the hash function.
+		 * @note Only available if the key type is trivially copyable.
+		 * @note Snapshots use native byte order & layout, and are only compatible with sets of the same type and hash function.
+		 * @throw snapshot_error If the snapshot could not be written. */
+		template<typename S>
+		void save(S &os) const { m_table.save(os); }
+		/** Replaces contents of the set with a snapshot read from input stream `is`. If the snapshot is not compatible
+		 * with the set or is corrupted, the set is left unchanged.
+		 * @throw snapshot_error If the snapshot could not be read or validated. */
+		template<typename S>
+		void load(S &is) { m_table.load(is); }
+
+		[[nodiscard]] allocator_type get_allocator() const { return m_table.get_allocator(); }
+		[[nodiscard]] hasher hash_function() const { return m_table.get_hash(); }
+		[[nodiscard]] key_equal key_eq() const { return m_table.get_cmp(); }
+
+		void swap(frozen_set &other) noexcept(std::is_nothrow_swappable_v<table_t>) { m_table.swap(other.m_table); }
+
+	private:
+		table_t m_table;
+	};
+
+	template<typename K, typename H, typename C, typename A>
+	inline void swap(frozen_set<K, H, C, A> &a, frozen_set<K, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
+
+	/** Builds a frozen set from keys of set \p set, using hasher & comparator of \p set.
+	 * @throw std::invalid_argument If different keys of the set have equal hashes.
+	 * @throw std::runtime_error If the perfect hash function could not be built. */
+	template<typename S, typename = std::enable_if_t<!_detail::has_mapped_type<S>::value>>
+	[[nodiscard]] inline frozen_set<typename S::key_type, typename S::hasher, typename S::key_equal> freeze(const S &set)
+	{
+		return {set.begin(), set.end(), set.hash_function(), set.key_eq()};
+	}
+}
@@ -0,0 +1,272 @@
+/*
+ * Created by switchblade on 2023-01-26.
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <string>
+
+#include "detail/table_common.hpp"
+#include "detail/meta_block.hpp"
+#include "detail/mapped_file.hpp"
+#include "detail/snapshot.hpp"
+
+namespace tpp
+{
+	/** @brief Read-only view of a `sparse_map` snapshot file, mapped into memory.
+	 *
+	 * The view maps a snapshot written by `sparse_map<Key, Mapped, KeyHash, KeyCmp>::save` and serves lookups & iteration
+	 * directly from the mapped metadata and node arrays, without copying or re-hashing the elements. Since the file is
+	 * mapped as shared, read-only memory, pages of the table are shared between all processes viewing the same file.
+	 *
+	 * Only the snapshot header & metadata sentinel are validated when the view is opened. Contents of the table are trusted,
+	 * however lookups never access memory outside of the mapped arrays, even if the file is corrupted. The file must not
+	 * be modified while it is viewed.
+	 *
+	 * @tparam Key Key type of the viewed map. Must be trivially copyable.
+	 * @tparam Mapped Mapped type of the viewed map. Must be trivially copyable.
+	 * @tparam KeyHash Hash functor used by the viewed map.
+	 * @tparam KeyCmp Compare functor used by the viewed map. */
+	template<typename Key, typename Mapped, typename KeyHash = std::hash<Key>, typename KeyCmp = std::equal_to<Key>>
+	class mapped_sparse_map_view : _detail::empty_base<KeyHash>, _detail::empty_base<KeyCmp>
+	{
+		static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Mapped>, "Mapped map views require trivially copyable key & mapped types");
+
+	public:
+		using key_type = Key;
+		using mapped_type = Mapped;
+		/* Elements are viewed as stored by `sparse_map`, and are never modified. */
+		using value_type = std::pair<key_type, mapped_type>;
+
+		using reference = const value_type &;
+		using const_reference = const value_type &;
+		using pointer = const value_type *;
+		using const_pointer = const value_type *;
+
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		using hasher = KeyHash;
+		using key_equal = KeyCmp;
+
+	private:
+		using hash_base = _detail::empty_base<KeyHash>;
+		using cmp_base = _detail::empty_base<KeyCmp>;
+
+		using meta_byte = _detail::meta_byte;
+		using meta_block = _detail::meta_block;
+
+		/* Must match traits of `sparse_map`, as the node layout is shared with the snapshot. */
+		struct traits_t
+		{
+			using link_type = _detail::empty_link;
+
+			template<typename T>
+			static constexpr auto &get_key(T &value) noexcept { return value.first; }
+			template<typename T>
+			static constexpr auto &get_mapped(T &value) noexcept { return value.second; }
+		};
+
+		using bucket_node = _detail::packed_node<value_type, std::allocator<value_type>, traits_t>;
+
+	public:
+		/** @brief Forward iterator over elements of the view. */
+		class const_iterator
+		{
+			friend class mapped_sparse_map_view;
+
+		public:
+			using value_type = typename mapped_sparse_map_view::value_type;
+			using reference = typename mapped_sparse_map_view::const_reference;
+			using pointer = typename mapped_sparse_map_view::const_pointer;
+			using size_type = typename mapped_sparse_map_view::size_type;
+			using difference_type = typename mapped_sparse_map_view::difference_type;
+			using iterator_category = std::forward_iterator_tag;
+
+		private:
+			constexpr const_iterator(const meta_byte *meta, const bucket_node *node) noexcept : m_meta(meta), m_node(node) {}
+
+		public:
+			constexpr const_iterator() noexcept = default;
+
+			constexpr const_iterator operator++(int) noexcept
+			{
+				auto tmp = *this;
+				++(*this);
+				return tmp;
+			}
+			constexpr const_iterator &operator++() noexcept
+			{
+				/* Metadata is terminated by the sentinel, which is not occupied. */
+				do { ++m_meta, ++m_node; } while (*m_meta != meta_byte::sentinel && !_detail::is_occupied(*m_meta));
+				return *this;
+			}
+
+			[[nodiscard]] constexpr pointer operator->() const noexcept { return &m_node->value(); }
+			[[nodiscard]] constexpr reference operator*() const noexcept { return m_node->value(); }
+
+			[[nodiscard]] constexpr bool operator==(const const_iterator &other) const noexcept { return m_node == other.m_node; }
+#if (__cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L))
+			[[nodiscard]] constexpr bool operator!=(const const_iterator &other) const noexcept { return m_node != other.m_node; }
+#endif
+
+		private:
+			const meta_byte *m_meta = nullptr;
+			const bucket_node *m_node = nullptr;
+		};
+		using iterator = const_iterator;
+
+	public:
+		/** Initializes an empty view. */
+		mapped_sparse_map_view() = default;
+
+		/** Maps the snapshot file at `path` using the specified hasher and comparator.
+		 * @throw std::system_error If the file could not be opened or mapped.
+		 * @throw snapshot_error If the file is not a snapshot compatible with the view. */
+		explicit mapped_sparse_map_view(const char *path, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{})
+				: hash_base(hash), cmp_base(cmp), m_file(path) { init(); }
+		/** @copydoc mapped_sparse_map_view */
+		explicit mapped_sparse_map_view(const std::string &path, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{})
+				: mapped_sparse_map_view(path.c_str(), hash, cmp) {}
+
+		mapped_sparse_map_view(const mapped_sparse_map_view &) = delete;
+		mapped_sparse_map_view &operator=(const mapped_sparse_map_view &) = delete;
+
+		mapped_sparse_map_view(mapped_sparse_map_view &&other) noexcept : hash_base(static_cast<hash_base &&>(other)), cmp_base(static_cast<cmp_base &&>(other)) { swap_data(other); }
+		mapped_sparse_map_view &operator=(mapped_sparse_map_view &&other) noexcept
+		{
+			hash_base::operator=(static_cast<hash_base &&>(other));
+			cmp_base::operator=(static_cast<cmp_base &&>(other));
+			swap_data(other);
+			return *this;
+		}
+
+		/** Returns iterator to the first element of the view. */
+		[[nodiscard]] const_iterator begin() const noexcept
+		{
+			auto result = const_iterator{m_meta, m_nodes};
+			if (m_capacity != 0 && !_detail::is_occupied(*m_meta)) ++result;
+			return result;
+		}
+		/** @copydoc begin */
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		/** Returns iterator one past the last element of the view. */
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator{m_meta + m_capacity, m_nodes + m_capacity}; }
+		/** @copydoc end */
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		/** Returns the amount of elements within the view. */
+		[[nodiscard]] constexpr size_type size() const noexcept { return m_size; }
+		/** Checks if the view is empty. */
+		[[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+		/** Returns the amount of buckets of the viewed map. */
+		[[nodiscard]] constexpr size_type bucket_count() const noexcept { return m_capacity; }
+
+		/** Searches for an element with the specified key within the view.
+		 * @return Iterator to the element, or the end iterator if the element was not found. */
+		[[nodiscard]] const_iterator find(const key_type &key) const
+		{
+			const auto pos = find_node(key);
+			return const_iterator{m_meta + pos, m_nodes + pos};
+		}
+		/** Checks if an element with the specified key is present within the view. */
+		[[nodiscard]] bool contains(const key_type &key) const { return find_node(key) != m_capacity; }
+		/** Returns reference to the mapped object of the specified element.
+		 * @throw std::out_of_range If no such element exists within the view. */
+		[[nodiscard]] const mapped_type &at(const key_type &key) const
+		{
+			const auto pos = find_node(key);
+			if (pos == m_capacity)
+				throw std::out_of_range("`mapped_sparse_map_view::at` - invalid key");
+			return m_nodes[pos].mapped();
+		}
+
+		[[nodiscard]] hasher hash_function() const { return hash_base::value(); }
+		[[nodiscard]] key_equal key_eq() const { return cmp_base::value(); }
+
+		void swap(mapped_sparse_map_view &other) noexcept
+		{
+			hash_base::swap(other);
+			cmp_base::swap(other);
+			swap_data(other);
+		}
+		friend void swap(mapped_sparse_map_view &a, mapped_sparse_map_view &b) noexcept { a.swap(b); }
+
+	private:
+		void init()
+		{
+			const auto *bytes = static_cast<const unsigned char *>(m_file.data());
+			if (m_file.size() < sizeof(_detail::snapshot_header))
+				throw snapshot_error("Invalid table snapshot");
+
+			_detail::snapshot_header expected;
+			expected.kind = static_cast<std::uint32_t>(_detail::snapshot_kind::swiss);
+			expected.node_size = sizeof(bucket_node);
+			expected.node_align = alignof(bucket_node);
+			expected.block_size = sizeof(meta_block);
+			expected.fingerprint = _detail::snapshot_fingerprint<key_type>(hash_base::value());
+
+			_detail::snapshot_header header;
+			std::memcpy(&header, bytes, sizeof(header));
+			header.validate(expected);
+
+			const auto capacity = header.capacity;
+			if (capacity > std::numeric_limits<size_type>::max() / sizeof(bucket_node) || ((capacity + 1) & capacity) != 0 || header.size > capacity)
+				throw snapshot_error("Invalid table snapshot");
+			const auto layout = _detail::swiss_snapshot_layout{capacity, sizeof(meta_block), sizeof(bucket_node), alignof(bucket_node)};
+			if (capacity != 0 && layout.total_size > m_file.size())
+				throw snapshot_error("Invalid table snapshot");
+
+			/* Snapshot of an empty map does not contain metadata or nodes. */
+			if (capacity == 0) return;
+			m_meta = reinterpret_cast<const meta_byte *>(bytes + layout.meta_offset);
+			m_nodes = reinterpret_cast<const bucket_node *>(bytes + layout.nodes_offset);
+			if (m_meta[capacity] != meta_byte::sentinel)
+				throw snapshot_error("Invalid table snapshot");
+
+			m_capacity = static_cast<size_type>(capacity);
+			m_size = static_cast<size_type>(header.size);
+		}
+
+		[[nodiscard]] size_type find_node(const key_type &key) const
+		{
+			TPP_IF_LIKELY(m_size != 0)
+			{
+				const auto h = hash_base::value()(key);
+				const auto [h1, h2] = _detail::decompose_hash(h);
+
+				/* Probe sequence is the same as that of `sparse_map`, and is limited to the capacity in case the file is corrupted. */
+				for (size_type pos = h1 & m_capacity, idx = 0; idx <= m_capacity; idx += sizeof(meta_block), pos = (pos + idx) & m_capacity)
+				{
+					const auto block = meta_block(m_meta + pos);
+					for (auto match = block.match_eq(h2); !match.empty(); ++match)
+					{
+						const auto offset = (pos + match.lsb_index()) & m_capacity;
+						TPP_IF_LIKELY(cmp_base::value()(m_nodes[offset].key(), key))
+							return offset;
+					}
+					TPP_IF_UNLIKELY(!block.match_empty().empty())
+						break;
+				}
+			}
+			return m_capacity;
+		}
+
+		void swap_data(mapped_sparse_map_view &other) noexcept
+		{
+			m_file.swap(other.m_file);
+			std::swap(m_meta, other.m_meta);
+			std::swap(m_nodes, other.m_nodes);
+			std::swap(m_capacity, other.m_capacity);
+			std::swap(m_size, other.m_size);
+		}
+
+		_detail::mapped_file m_file;
+		const meta_byte *m_meta = nullptr;
+		const bucket_node *m_nodes = nullptr;
+		size_type m_capacity = 0;
+		size_type m_size = 0;
+	};
+}
@@ -0,0 +1,70 @@
+/*
+ * Created by switchblade on 2023-01-24.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include "detail/executor.hpp"
+
+namespace tpp
+{
+	namespace _detail
+	{
+		/* Each worker receives several sub-ranges, since elements are not necessarily spread evenly between them. */
+		inline constexpr std::size_t ranges_per_worker = 4;
+	}
+
+	/** Invokes `f` with every element of `table` using executor `exec`. `table` must provide `split`, and `f` must be safe
+	 * to invoke concurrently for different elements.
+	 * @param table Table, which elements to visit.
+	 * @param f Functor invoked with every element.
+	 * @param exec Executor used to run parallel tasks (ex. `tpp::par`). */
+	template<typename Table, typename F, typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+	void parallel_for_each(Table &table, F f, const E &exec)
+	{
+		const auto ranges = table.split(exec.concurrency() * _detail::ranges_per_worker);
+		exec.bulk(ranges.size(), [&](std::size_t i) { for (auto &&value: ranges[i]) f(value); });
+	}
+	/** Invokes `f` with every element of `table` using `threads` worker threads. If `threads` is 0, uses
+	 * `std::thread::hardware_concurrency()` threads. */
+	template<typename Table, typename F>
+	void parallel_for_each(Table &table, F f, std::size_t threads = 0) { parallel_for_each(table, f, thread_executor{threads}); }
+
+	/** Reduces elements of `table` using executor `exec`. Every sub-range of the table is reduced in parallel, after which
+	 * the partial results are reduced in order of the sub-ranges, starting from `init`.
+	 * @param table Table, which elements to reduce.
+	 * @param init Initial value of the result.
+	 * @param reduce Associative binary functor used to combine results of `transform` and partial results.
+	 * @param transform Functor used to obtain a value from every element of the table.
+	 * @param exec Executor used to run parallel tasks (ex. `tpp::par`).
+	 * @return Result of the reduction. */
+	template<typename Table, typename T, typename R, typename F, typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+	[[nodiscard]] T parallel_reduce(Table &table, T init, R reduce, F transform, const E &exec)
+	{
+		const auto ranges = table.split(exec.concurrency() * _detail::ranges_per_worker);
+		auto partials = std::vector<std::optional<T>>(ranges.size());
+		exec.bulk(ranges.size(), [&](std::size_t i)
+		{
+			auto &partial = partials[i];
+			for (auto &&value: ranges[i])
+			{
+				if (partial.has_value())
+					partial = reduce(std::move(*partial), transform(value));
+				else
+					partial.emplace(transform(value));
+			}
+		});
+
+		for (auto &partial: partials)
+			if (partial.has_value()) init = reduce(std::move(init), std::move(*partial));
+		return init;
+	}
+	/** Reduces elements of `table` using `threads` worker threads. If `threads` is 0, uses `std::thread::hardware_concurrency()` threads. */
+	template<typename Table, typename T, typename R, typename F>
+	[[nodiscard]] T parallel_reduce(Table &table, T init, R reduce, F transform, std::size_t threads = 0)
+	{
+		return parallel_reduce(table, std::move(init), reduce, transform, thread_executor{threads});
+	}
+}
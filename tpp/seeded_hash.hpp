@@ -0,0 +1,98 @@
+/*
+ * Created by switchblade on 2023-01-31.
+ */
+
+#pragma once
+
+#include <random>
+#include <atomic>
+#include <chrono>
+
+#include "detail/table_common.hpp"
+#include "fast_hash.hpp"
+
+namespace tpp
+{
+	namespace _detail
+	{
+		template<typename H, typename K, typename = void>
+		struct is_seedable : std::false_type {};
+		template<typename H, typename K>
+		struct is_seedable<H, K, std::enable_if_t<std::is_invocable_r_v<std::size_t, const H &, const K &, std::uint64_t>>> : std::true_type {};
+
+		template<typename H, typename K>
+		using is_nothrow_seeded_hash = std::conditional_t<is_seedable<H, K>::value,
+		                                                  std::is_nothrow_invocable<const H &, const K &, std::uint64_t>,
+		                                                  std::is_nothrow_invocable<const H &, const K &>>;
+
+		/* Seeds are derived from a per-process random key and a counter, so that `std::random_device` is only queried once. */
+		[[nodiscard]] inline std::uint64_t random_seed() noexcept
+		{
+			static const std::uint64_t key = []() noexcept -> std::uint64_t
+			{
+				try
+				{
+					std::random_device device;
+					return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+				}
+				catch (...)
+				{
+					/* Fall back to the clock & a (randomized) stack address if no entropy source is available. */
+					const auto ticks = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+					const int local = 0;
+					return ticks ^ static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&local));
+				}
+			}();
+			static std::atomic<std::uint64_t> counter = {0};
+			return hash_u64(counter.fetch_add(1, std::memory_order_relaxed), key);
+		}
+	}
+
+	/** @brief Hash functor adapter, which mixes a per-instance random seed into the hash of `Hash`.
+	 *
+	 * Every default-constructed `seeded_hash` uses a different seed, so that keys colliding within one table (ex. keys crafted
+	 * by an attacker) do not collide within another, or after the table has been reseeded. The seed is copied together with the
+	 * hasher, thus it is kept by copies of the table and is not changed by rehashing.<br><br>
+	 * If `Hash` accepts a seed as the second argument (ex. `fast_hash` or `bytes_hash`), the seed is passed to it. Otherwise, the seed
+	 * is mixed into the result of `Hash`, which only separates keys that do not produce the same full hash of `Hash`.<br><br>
+	 * Swiss tables (`sparse_map`, `stable_map`, etc.) using a `seeded_hash` detect probe sequences which are far longer than expected
+	 * of a uniformly distributed hash, in which case the hasher is reseeded and the table is rehashed in-place. Reseeding invalidates
+	 * iterators, and hashes computed by copies of the hasher (ex. for `find_hashed`) must not be used after an insertion.
+	 *
+	 * @note Binary snapshots of a table contain hashes mixed with the seed, and can only be loaded by a table using the same seed.
+	 * Such a table can be created by passing `hash_function()` of the saved table to the constructor. */
+	template<typename T, typename Hash = fast_hash<T>>
+	class seeded_hash
+	{
+	public:
+		/** Hash is transparent if `Hash` is. */
+		using is_transparent = std::bool_constant<_detail::is_transparent<Hash>::value>;
+
+	public:
+		/** Initializes the hasher with a random seed. */
+		seeded_hash() : m_seed(_detail::random_seed()) {}
+		/** Initializes the hasher with the specified seed and an instance of `Hash`. */
+		constexpr explicit seeded_hash(std::uint64_t seed, const Hash &hash = Hash{}) : m_hash(hash), m_seed(seed) {}
+
+		/** Returns hash of `key` mixed with the seed. */
+		template<typename K = T>
+		[[nodiscard]] constexpr std::size_t operator()(const K &key) const noexcept(_detail::is_nothrow_seeded_hash<Hash, K>::value)
+		{
+			if constexpr (_detail::is_seedable<Hash, K>::value)
+				return m_hash(key, m_seed);
+			else
+				return _detail::to_size_hash(_detail::hash_u64(static_cast<std::uint64_t>(m_hash(key)), m_seed));
+		}
+
+		/** Returns the seed of the hasher. */
+		[[nodiscard]] constexpr std::uint64_t seed() const noexcept { return m_seed; }
+		/** Replaces the seed with a new random seed. */
+		void reseed() noexcept { m_seed = _detail::random_seed(); }
+		/** Replaces the seed with `seed`. */
+		constexpr void reseed(std::uint64_t seed) noexcept { m_seed = seed; }
+
+	private:
+		Hash m_hash;
+		std::uint64_t m_seed;
+	};
+}
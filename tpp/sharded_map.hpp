@@ -0,0 +1,259 @@
+/*
+ * Created by switchblade on 2023-01-20.
+ */
+
+#pragma once
+
+#include <shared_mutex>
+#include <optional>
+#include <utility>
+#include <limits>
+#include <array>
+#include <mutex>
+
+#include "detail/utility.hpp"
+
+namespace tpp
+{
+	namespace _detail
+	{
+		template<typename T, typename K, typename = void>
+		struct has_hashed_lookup : std::false_type {};
+		template<typename T, typename K>
+		struct has_hashed_lookup<T, K, std::void_t<decltype(std::declval<T &>().find_hashed(std::declval<const K &>(), std::size_t{}))>> : std::true_type {};
+
+		/* Member `erase_if` of concurrent containers hides the free function, thus it is invoked via ADL from here. */
+		template<typename T, typename P>
+		inline auto erase_table_if(T &table, P &pred) { return erase_if(table, pred); }
+	}
+
+	/** @brief Thread-safe hash map that splits elements between `Shards` independently locked tables.
+	 *
+	 * Every element is routed to a shard using the high bits of it's (remixed) hash, and every shard is protected by it's own
+	 * reader-writer lock, so that operations on different shards do not contend. Shards are padded to a cache line to avoid
+	 * false sharing between the locks. If `Table` provides prehashed overloads (`find_hashed`, `try_emplace_hashed`, etc.),
+	 * the key is hashed only once for both routing and lookup within the shard, unless the hasher is a reseedable `seeded_hash`.<br><br>
+	 * Since references to elements of the underlying tables cannot be safely returned while other threads modify the map,
+	 * elements are accessed through callbacks that are invoked while the corresponding shard is locked. Callbacks must not
+	 * access the sharded map itself, as doing so may result in a deadlock.
+	 *
+	 * @tparam Table Hash map type used for individual shards (ex. `tpp::sparse_map<K, M>` or `tpp::dense_map<K, M>`).
+	 * @tparam Shards Amount of shards. Must be a power of two. */
+	template<typename Table, std::size_t Shards = 16>
+	class sharded_map
+	{
+		static_assert(Shards != 0 && (Shards & (Shards - 1)) == 0, "Shard count must be a power of two");
+
+	public:
+		using table_type = Table;
+
+		using key_type = typename Table::key_type;
+		using mapped_type = typename Table::mapped_type;
+		using value_type = typename Table::value_type;
+
+		using size_type = typename Table::size_type;
+		using hasher = typename Table::hasher;
+
+	private:
+		constexpr static std::size_t shard_bits = _detail::log2(Shards);
+		/* Shard tables may reseed their hashers, in which case the routing hash cannot be reused for lookup. */
+		constexpr static bool use_hashed = _detail::has_hashed_lookup<Table, key_type>::value && !_detail::is_reseedable<hasher>::value;
+
+		struct alignas(_detail::cache_line_size) shard_t
+		{
+			mutable std::shared_mutex mtx;
+			Table table;
+		};
+
+	public:
+		/** Initializes an empty map. */
+		sharded_map() = default;
+
+		sharded_map(const sharded_map &) = delete;
+		sharded_map &operator=(const sharded_map &) = delete;
+
+		/** Returns the amount of shards of the map. */
+		[[nodiscard]] static constexpr size_type shard_count() noexcept { return Shards; }
+
+		/** Returns the total amount of elements within the map.
+		 * @note Shards are locked one after another, so the result may be stale if the map is modified concurrently. */
+		[[nodiscard]] size_type size() const
+		{
+			size_type result = 0;
+			for (auto &shard: m_shards)
+			{
+				const std::shared_lock lock{shard.mtx};
+				result += shard.table.size();
+			}
+			return result;
+		}
+		/** Checks if the map is empty. */
+		[[nodiscard]] bool empty() const { return size() == 0; }
+
+		/** Erases all elements from the map. */
+		void clear()
+		{
+			for (auto &shard: m_shards)
+			{
+				const std::unique_lock lock{shard.mtx};
+				shard.table.clear();
+			}
+		}
+		/** Reserves space for at least `n` elements, evenly distributed between the shards. */
+		void reserve(size_type n)
+		{
+			for (auto &shard: m_shards)
+			{
+				const std::unique_lock lock{shard.mtx};
+				shard.table.reserve((n + Shards - 1) / Shards);
+			}
+		}
+
+		/** Inserts a mapped value constructed from `args` at the specified key, if the key does not exist yet.
+		 * @return `true` if the element was inserted, `false` otherwise. */
+		template<typename... Args>
+		bool try_emplace(const key_type &key, Args &&...args)
+		{
+			const auto h = m_hash(key);
+			auto &shard = m_shards[shard_index(h)];
+			const std::unique_lock lock{shard.mtx};
+
+			if constexpr (use_hashed)
+				return shard.table.try_emplace_hashed(key, h, std::forward<Args>(args)...).second;
+			else
+				return shard.table.try_emplace(key, std::forward<Args>(args)...).second;
+		}
+		/** Removes the element at the specified key.
+		 * @return `1` if the element was removed, `0` otherwise. */
+		size_type erase(const key_type &key)
+		{
+			const auto h = m_hash(key);
+			auto &shard = m_shards[shard_index(h)];
+			const std::unique_lock lock{shard.mtx};
+
+			if constexpr (use_hashed)
+			{
+				const auto iter = shard.table.find_hashed(key, h);
+				if (iter == shard.table.end()) return 0;
+				shard.table.erase(iter);
+				return 1;
+			}
+			else
+				return shard.table.erase(key);
+		}
+
+		/** Returns a copy of the mapped value at the specified key, or an empty optional if no such element exists. */
+		[[nodiscard]] std::optional<mapped_type> find(const key_type &key) const
+		{
+			std::optional<mapped_type> result;
+			cvisit(key, [&](const auto &value) { result.emplace(value.second); });
+			return result;
+		}
+		/** Checks if the specified element is present within the map. */
+		[[nodiscard]] bool contains(const key_type &key) const
+		{
+			const auto h = m_hash(key);
+			auto &shard = m_shards[shard_index(h)];
+			const std::shared_lock lock{shard.mtx};
+
+			if constexpr (use_hashed)
+				return shard.table.contains_hashed(key, h);
+			else
+				return shard.table.find(key) != shard.table.end();
+		}
+
+		/** Invokes `f` with a reference to the element at the specified key. The shard of the element is locked
+		 * for exclusive access during the call, allowing `f` to modify the mapped value.
+		 * @return `true` if the element was found, `false` otherwise. */
+		template<typename F>
+		bool visit(const key_type &key, F &&f) { return do_visit<std::unique_lock<std::shared_mutex>>(*this, key, f); }
+		/** Invokes `f` with a const reference to the element at the specified key. The shard of the element is locked for shared access during the call.
+		 * @return `true` if the element was found, `false` otherwise. */
+		template<typename F>
+		bool visit(const key_type &key, F &&f) const { return cvisit(key, f); }
+		/** @copydoc visit(const key_type &, F &&) const */
+		template<typename F>
+		bool cvisit(const key_type &key, F &&f) const { return do_visit<std::shared_lock<std::shared_mutex>>(*this, key, f); }
+
+		/** Invokes `f` with a reference to every element of the map. Every shard is exclusively locked while it is visited. */
+		template<typename F>
+		void visit_all(F &&f)
+		{
+			for (auto &shard: m_shards)
+			{
+				const std::unique_lock lock{shard.mtx};
+				for (auto &&value: shard.table) f(value);
+			}
+		}
+		/** Invokes `f` with a const reference to every element of the map. Every shard is locked for shared access while it is visited. */
+		template<typename F>
+		void visit_all(F &&f) const { cvisit_all(f); }
+		/** @copydoc visit_all(F &&) const */
+		template<typename F>
+		void cvisit_all(F &&f) const
+		{
+			for (auto &shard: m_shards)
+			{
+				const std::shared_lock lock{shard.mtx};
+				for (auto &&value: std::as_const(shard.table)) f(value);
+			}
+		}
+
+		/** Removes all elements that satisfy the predicate `pred`. Every shard is exclusively locked while it is processed.
+		 * @return Amount of elements removed. */
+		template<typename P>
+		size_type erase_if(P pred)
+		{
+			size_type result = 0;
+			for (auto &shard: m_shards)
+			{
+				const std::unique_lock lock{shard.mtx};
+				result += _detail::erase_table_if(shard.table, pred);
+			}
+			return result;
+		}
+
+		/** Returns copy of the hash function used by the map. */
+		[[nodiscard]] hasher hash_function() const { return m_hash; }
+
+	private:
+		/* Routing uses top bits of the remixed hash. The remix is needed since bucket policies of the shard tables
+		 * may also use top bits of the (multiplicatively mixed) hash, in which case elements of every shard would end up
+		 * clustered in a small part of the shard's bucket array. */
+		[[nodiscard]] static constexpr std::size_t shard_index(std::size_t h) noexcept
+		{
+			if constexpr (Shards == 1)
+				return 0;
+			else
+			{
+				constexpr auto digits = std::numeric_limits<std::size_t>::digits;
+				constexpr auto mult = static_cast<std::size_t>(sizeof(std::size_t) > 4 ? 0xff51afd7ed558ccdull : 0x85ebca6bull);
+				return ((h ^ (h >> (digits / 2))) * mult) >> (digits - shard_bits);
+			}
+		}
+
+		template<typename L, typename M, typename F>
+		static bool do_visit(M &map, const key_type &key, F &f)
+		{
+			const auto h = map.m_hash(key);
+			auto &shard = map.m_shards[shard_index(h)];
+			const L lock{shard.mtx};
+
+			auto &table = shard.table;
+			const auto iter = [&]()
+			{
+				if constexpr (use_hashed)
+					return table.find_hashed(key, h);
+				else
+					return table.find(key);
+			}();
+
+			if (iter == table.end()) return false;
+			f(*iter);
+			return true;
+		}
+
+		std::array<shard_t, Shards> m_shards;
+		hasher m_hash;
+	};
+}
@@ -116,6 +116,23 @@ namespace tpp
 		template<typename I>
 		sparse_set(I first, I last, size_type bucket_count, const allocator_type &alloc) : sparse_set(first, last, bucket_count, hasher{}, alloc) {}
 
+		/** Initializes the set with a range of elements, using executor `exec` to hash and place the elements in parallel.
+		 * If the range contains multiple elements with equal keys, the first one is inserted.
+		 * @param exec Executor used to run parallel tasks (ex. `tpp::par`).
+		 * @param first Iterator to the first element of the source range.
+		 * @param last Iterator one past the last element of the source range.
+		 * @param hash Hasher used by the set.
+		 * @param cmp Comparator used by the set.
+		 * @param alloc Allocator used by the set.
+		 * @note Elements of ranges that are not random-access are inserted sequentially. */
+		template<typename E, typename I, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		[[nodiscard]] static sparse_set from_range(const E &exec, I first, I last, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+		{
+			auto result = sparse_set{0, hash, cmp, alloc};
+			result.insert(exec, first, last);
+			return result;
+		}
+
 		/** Copy-assigns the set. */
 		sparse_set &operator=(const sparse_set &) = default;
 		/** Move-assigns the set. */
@@ -146,6 +163,12 @@ namespace tpp
 		/** @copydoc end */
 		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
 
+		/** Splits the set into at most `n` disjoint sub-ranges that together cover all of it's elements.
+		 * Boundaries of the sub-ranges are aligned to metadata blocks of the buckets, so sub-ranges may contain different amounts of elements.
+		 * Sub-ranges are intended to be processed in parallel (see `tpp::parallel_for_each`).
+		 * @note Sub-ranges are invalidated together with iterators of the set. */
+		[[nodiscard]] std::vector<iterator_range<const_iterator>> split(size_type n) const { return m_table.split(n); }
+
 		/** Returns the total number of elements within the set. */
 		[[nodiscard]] constexpr size_type size() const noexcept { return m_table.size(); }
 		/** Checks if the set is empty (`size() == 0`). */
@@ -192,6 +215,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the source range. */
 		template<typename I>
 		void insert(I first, I last) { return m_table.insert(first, last); }
+		/** Inserts all elements from the range `[first, last)` into the set, using executor `exec` to hash and place the elements in parallel.
+		 * If the range contains multiple elements with equal keys, the first one is inserted.
+		 * @param exec Executor used to run parallel tasks (ex. `tpp::par`).
+		 * @param first Iterator to the first element of the source range.
+		 * @param last Iterator one past the last element of the source range.
+		 * @note Elements of ranges that are not random-access are inserted sequentially. */
+		template<typename E, typename I, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void insert(const E &exec, I first, I last) { m_table.insert(exec, first, last); }
 		/** Inserts all elements of an initializer list into the set. */
 		void insert(std::initializer_list<value_type> il) { return insert(il.begin(), il.end()); }
 		/** @copydoc insert */
@@ -259,9 +290,57 @@ namespace tpp
 		/** Reserves space for at least `n` buckets and rehashes the set if necessary.
 		 * @note The new amount of buckets is clamped to be at least `size() / max_load_factor()`. */
 		void rehash(size_type n) { m_table.rehash(n); }
+		/** Overloads of `reserve` & `rehash` that re-insert elements of the set in parallel, using either executor `exec`
+		 * or `threads` worker threads (where 0 selects `std::thread::hardware_concurrency()`). */
+		template<typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void reserve(size_type n, const E &exec) { m_table.reserve(n, exec); }
+		/** @copydoc reserve */
+		void reserve(size_type n, std::size_t threads) { m_table.reserve(n, thread_executor{threads}); }
+		/** @copydoc reserve */
+		template<typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void rehash(size_type n, const E &exec) { m_table.rehash(n, exec); }
+		/** @copydoc reserve */
+		void rehash(size_type n, std::size_t threads) { m_table.rehash(n, thread_executor{threads}); }
 		/** Returns the maximum load factor. */
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return m_table.max_load_factor(); }
 
+		/** Writes a binary snapshot of the set to output stream `os`. Snapshot contains raw metadata & nodes of the set,
+		 * and can be restored via `load` without re-hashing of the elements.
+		 * @note Only available if the value type are trivially copyable.
+		 * @note Snapshots use native byte order & layout, and are only compatible with sets of the same type and hash function.
+		 * @throw snapshot_error If the snapshot could not be written. */
+		template<typename S>
+		void save(S &os) const { m_table.save(os); }
+		/** Replaces contents of the set with a snapshot read from input stream `is`. If the snapshot is not compatible
+		 * with the set or is corrupted, the set is left unchanged.
+		 * @throw snapshot_error If the snapshot could not be read or validated. */
+		template<typename S>
+		void load(S &is) { m_table.load(is); }
+
+		/** @brief Enables or disables tracking of modified metadata blocks for incremental checkpoints via `checkpoint_delta`.
+		 *
+		 * When tracking is enabled, the set records which blocks were modified since tracking was enabled or since the
+		 * last `checkpoint_delta`. Elements modified through references & iterators are not tracked, and must be reported via `mark_dirty`.
+		 * Tracking state is not copied, moved or swapped with the set, and operations that replace or relocate all elements
+		 * (ex. rehash, `clear`, assignment) mark the entire set as modified.
+		 * @note Only available if the value type is trivially copyable. */
+		void set_dirty_tracking(bool enable) { m_table.set_dirty_tracking(enable); }
+		/** Checks if tracking of modified blocks is enabled. */
+		[[nodiscard]] bool dirty_tracking() const noexcept { return m_table.dirty_tracking(); }
+		/** Marks the block containing element at \p where as modified. Has no effect if tracking is disabled. */
+		void mark_dirty(const_iterator where) noexcept { m_table.mark_dirty(where); }
+		/** Writes the blocks modified since the previous checkpoint to output stream `os`, and resets the modified blocks.
+		 * If tracking is disabled, or the capacity of the set has changed, the delta contains all blocks of the set.
+		 * @throw snapshot_error If the delta could not be written, in which case the modified blocks are kept. */
+		template<typename S>
+		void checkpoint_delta(S &os) { m_table.checkpoint_delta(os); }
+		/** Applies a delta written by `checkpoint_delta` of another set read from input stream `is`. Deltas must be applied
+		 * in order, on top of a snapshot (or an equivalent set) of the set they were written from. If the delta is not
+		 * compatible with the set or is corrupted, the set is left unchanged.
+		 * @throw snapshot_error If the delta could not be read or validated. */
+		template<typename S>
+		void apply_delta(S &is) { m_table.apply_delta(is); }
+
 		[[nodiscard]] allocator_type get_allocator() const { return allocator_type{m_table.get_allocator()}; }
 		[[nodiscard]] hasher hash_function() const { return m_table.get_hash(); }
 		[[nodiscard]] key_equal key_eq() const { return m_table.get_cmp(); }
@@ -303,7 +382,7 @@ namespace tpp
 	}
 
 	template<typename K, typename H, typename C, typename A>
-	inline void swap(sparse_set<K, H, C, A> &a, sparse_set<K, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<sparse_set<K, H, C, A>>) { a.swap(b); }
+	inline void swap(sparse_set<K, H, C, A> &a, sparse_set<K, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	template<typename I, typename Key = _detail::iter_key_t<I>, typename Hash = std::hash<Key>, typename Cmp = std::equal_to<Key>, typename Alloc = std::allocator<Key>>
 	sparse_set(I, I, typename _detail::deduce_set_t<sparse_set, I, Hash, Cmp, Alloc>::size_type = 0, Hash = Hash{}, Cmp = Cmp{}, Alloc = Alloc{}) -> sparse_set<Key, Hash, Cmp, Alloc>;
@@ -578,6 +657,9 @@ namespace tpp
 		/** Reserves space for at least `n` buckets and rehashes the set if necessary.
 		 * @note The new amount of buckets is clamped to be at least `size() / max_load_factor()`. */
 		void rehash(size_type n) { m_table.rehash(n); }
+		/** Re-inserts elements of the set in insertion order and purges erased entries, shortening probe sequences after heavy churn.
+		 * @note Invalidates all iterators and references. */
+		void compact() { m_table.compact(); }
 		/** Returns the maximum load factor. */
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return m_table.max_load_factor(); }
 
@@ -622,7 +704,7 @@ namespace tpp
 	}
 
 	template<typename K, typename H, typename C, typename A>
-	inline void swap(ordered_sparse_set<K, H, C, A> &a, ordered_sparse_set<K, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<ordered_sparse_set<K, H, C, A>>) { a.swap(b); }
+	inline void swap(ordered_sparse_set<K, H, C, A> &a, ordered_sparse_set<K, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	template<typename I, typename Key = _detail::iter_key_t<I>, typename Hash = std::hash<Key>, typename Cmp = std::equal_to<Key>, typename Alloc = std::allocator<Key>>
 	ordered_sparse_set(I, I, typename _detail::deduce_set_t<ordered_sparse_set, I, Hash, Cmp, Alloc>::size_type = 0, Hash = Hash{}, Cmp = Cmp{}, Alloc = Alloc{}) -> ordered_sparse_set<Key, Hash, Cmp, Alloc>;
@@ -121,6 +121,23 @@ namespace tpp
 		template<typename I>
 		stable_map(I first, I last, size_type bucket_count, const allocator_type &alloc) : stable_map(first, last, bucket_count, hasher{}, alloc) {}
 
+		/** Initializes the map with a range of elements, using executor `exec` to hash and place the elements in parallel.
+		 * If the range contains multiple elements with equal keys, the first one is inserted.
+		 * @param exec Executor used to run parallel tasks (ex. `tpp::par`).
+		 * @param first Iterator to the first element of the source range.
+		 * @param last Iterator one past the last element of the source range.
+		 * @param hash Hasher used by the map.
+		 * @param cmp Comparator used by the map.
+		 * @param alloc Allocator used by the map.
+		 * @note Elements of ranges that are not random-access are inserted sequentially. */
+		template<typename E, typename I, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		[[nodiscard]] static stable_map from_range(const E &exec, I first, I last, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+		{
+			auto result = stable_map{0, hash, cmp, alloc};
+			result.insert(exec, first, last);
+			return result;
+		}
+
 		/** Copy-assigns the map. */
 		stable_map &operator=(const stable_map &) = default;
 		/** Move-assigns the map. */
@@ -149,6 +166,14 @@ namespace tpp
 		/** @copydoc end */
 		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
 
+		/** Splits the map into at most `n` disjoint sub-ranges that together cover all of it's elements.
+		 * Boundaries of the sub-ranges are aligned to metadata blocks of the buckets, so sub-ranges may contain different amounts of elements.
+		 * Sub-ranges are intended to be processed in parallel (see `tpp::parallel_for_each`).
+		 * @note Sub-ranges are invalidated together with iterators of the map. */
+		[[nodiscard]] std::vector<iterator_range<iterator>> split(size_type n) { return m_table.split(n); }
+		/** @copydoc split */
+		[[nodiscard]] std::vector<iterator_range<const_iterator>> split(size_type n) const { return m_table.split(n); }
+
 		/** Returns the total number of elements within the map. */
 		[[nodiscard]] constexpr size_type size() const noexcept { return m_table.size(); }
 		/** Checks if the map is empty (`size() == 0`). */
@@ -196,6 +221,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the source range. */
 		template<typename I>
 		void insert(I first, I last) { return m_table.insert(first, last); }
+		/** Inserts all elements from the range `[first, last)` into the map, using executor `exec` to hash and place the elements in parallel.
+		 * If the range contains multiple elements with equal keys, the first one is inserted.
+		 * @param exec Executor used to run parallel tasks (ex. `tpp::par`).
+		 * @param first Iterator to the first element of the source range.
+		 * @param last Iterator one past the last element of the source range.
+		 * @note Elements of ranges that are not random-access are inserted sequentially. */
+		template<typename E, typename I, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void insert(const E &exec, I first, I last) { m_table.insert(exec, first, last); }
 
 		/** Inserts all elements of an initializer list into the map. */
 		void insert(std::initializer_list<value_type> il) { return insert(il.begin(), il.end()); }
@@ -556,6 +589,24 @@ namespace tpp
 		template<typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
 		[[nodiscard]] const mapped_type &at(const K &key) const { return guard_at(find(key))->second; }
 
+		/** @brief Prehashed overloads of `find`, `contains`, `erase` & `try_emplace`.
+		 *
+		 * These overloads accept a precomputed hash of the key and skip hashing the key internally, allowing the hash to be
+		 * shared with external routing logic (ex. `sharded_map`). The behavior is undefined unless `hash == hash_function()(key)`. */
+		[[nodiscard]] iterator find_hashed(const key_type &key, size_type hash) { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] const_iterator find_hashed(const key_type &key, size_type hash) const { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] bool contains_hashed(const key_type &key, size_type hash) const { return m_table.contains_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		iterator erase_hashed(const key_type &key, size_type hash) { return m_table.erase_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace_hashed(const key_type &key, size_type hash, Args &&...args)
+		{
+			return m_table.try_emplace_hashed(key, hash, std::forward<Args>(args)...);
+		}
+
 		/** Returns reference to the specified element. If the element is not present within the map, inserts a default-constructed instance.
 		 * @param key Key of the element to search for.
 		 * @return Reference to the specified element. */
@@ -580,6 +631,17 @@ namespace tpp
 		/** Reserves space for at least `n` buckets and rehashes the map if necessary.
 		 * @note The new amount of buckets is clamped to be at least `size() / max_load_factor()`. */
 		void rehash(size_type n) { m_table.rehash(n); }
+		/** Overloads of `reserve` & `rehash` that re-insert elements of the map in parallel, using either executor `exec`
+		 * or `threads` worker threads (where 0 selects `std::thread::hardware_concurrency()`). */
+		template<typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void reserve(size_type n, const E &exec) { m_table.reserve(n, exec); }
+		/** @copydoc reserve */
+		void reserve(size_type n, std::size_t threads) { m_table.reserve(n, thread_executor{threads}); }
+		/** @copydoc reserve */
+		template<typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void rehash(size_type n, const E &exec) { m_table.rehash(n, exec); }
+		/** @copydoc reserve */
+		void rehash(size_type n, std::size_t threads) { m_table.rehash(n, thread_executor{threads}); }
 		/** Returns the maximum load fact. */
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return m_table.max_load_factor(); }
 
@@ -614,7 +676,7 @@ namespace tpp
 	};
 
 	template<typename K, typename M, typename H, typename C, typename A>
-	inline void swap(stable_map<K, M, H, C, A> &a, stable_map<K, M, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<stable_map<K, H, C, A>>) { a.swap(b); }
+	inline void swap(stable_map<K, M, H, C, A> &a, stable_map<K, M, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the map \p map that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
@@ -1198,6 +1260,24 @@ namespace tpp
 		template<typename K, typename = std::enable_if_t<table_t::is_transparent::value && std::is_invocable_v<hasher, K>>>
 		[[nodiscard]] const mapped_type &at(const K &key) const { return guard_at(find(key))->second; }
 
+		/** @brief Prehashed overloads of `find`, `contains`, `erase` & `try_emplace`.
+		 *
+		 * These overloads accept a precomputed hash of the key and skip hashing the key internally, allowing the hash to be
+		 * shared with external routing logic (ex. `sharded_map`). The behavior is undefined unless `hash == hash_function()(key)`. */
+		[[nodiscard]] iterator find_hashed(const key_type &key, size_type hash) { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] const_iterator find_hashed(const key_type &key, size_type hash) const { return m_table.find_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		[[nodiscard]] bool contains_hashed(const key_type &key, size_type hash) const { return m_table.contains_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		iterator erase_hashed(const key_type &key, size_type hash) { return m_table.erase_hashed(key, hash); }
+		/** @copydoc find_hashed */
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace_hashed(const key_type &key, size_type hash, Args &&...args)
+		{
+			return m_table.try_emplace_hashed(key, hash, std::forward<Args>(args)...);
+		}
+
 		/** Returns reference to the specified element. If the element is not present within the map, inserts a default-constructed instance.
 		 * @param key Key of the element to search for.
 		 * @return Reference to the specified element. */
@@ -1256,7 +1336,7 @@ namespace tpp
 	};
 
 	template<typename K, typename M, typename H, typename C, typename A>
-	inline void swap(ordered_stable_map<K, M, H, C, A> &a, ordered_stable_map<K, M, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<ordered_stable_map<K, M, H, C, A>>) { a.swap(b); }
+	inline void swap(ordered_stable_map<K, M, H, C, A> &a, ordered_stable_map<K, M, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the map \p map that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
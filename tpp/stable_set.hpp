@@ -110,6 +110,23 @@ namespace tpp
 		template<typename I>
 		stable_set(I first, I last, size_type bucket_count, const allocator_type &alloc) : stable_set(first, last, bucket_count, hasher{}, alloc) {}
 
+		/** Initializes the set with a range of elements, using executor `exec` to hash and place the elements in parallel.
+		 * If the range contains multiple elements with equal keys, the first one is inserted.
+		 * @param exec Executor used to run parallel tasks (ex. `tpp::par`).
+		 * @param first Iterator to the first element of the source range.
+		 * @param last Iterator one past the last element of the source range.
+		 * @param hash Hasher used by the set.
+		 * @param cmp Comparator used by the set.
+		 * @param alloc Allocator used by the set.
+		 * @note Elements of ranges that are not random-access are inserted sequentially. */
+		template<typename E, typename I, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		[[nodiscard]] static stable_set from_range(const E &exec, I first, I last, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{}, const allocator_type &alloc = allocator_type{})
+		{
+			auto result = stable_set{0, hash, cmp, alloc};
+			result.insert(exec, first, last);
+			return result;
+		}
+
 		/** Copy-assigns the set. */
 		stable_set &operator=(const stable_set &) = default;
 		/** Move-assigns the set. */
@@ -140,6 +157,12 @@ namespace tpp
 		/** @copydoc end */
 		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
 
+		/** Splits the set into at most `n` disjoint sub-ranges that together cover all of it's elements.
+		 * Boundaries of the sub-ranges are aligned to metadata blocks of the buckets, so sub-ranges may contain different amounts of elements.
+		 * Sub-ranges are intended to be processed in parallel (see `tpp::parallel_for_each`).
+		 * @note Sub-ranges are invalidated together with iterators of the set. */
+		[[nodiscard]] std::vector<iterator_range<const_iterator>> split(size_type n) const { return m_table.split(n); }
+
 		/** Returns the total number of elements within the set. */
 		[[nodiscard]] constexpr size_type size() const noexcept { return m_table.size(); }
 		/** Checks if the set is empty (`size() == 0`). */
@@ -186,6 +209,14 @@ namespace tpp
 		 * @param last Iterator one past the last element of the source range. */
 		template<typename I>
 		void insert(I first, I last) { return m_table.insert(first, last); }
+		/** Inserts all elements from the range `[first, last)` into the set, using executor `exec` to hash and place the elements in parallel.
+		 * If the range contains multiple elements with equal keys, the first one is inserted.
+		 * @param exec Executor used to run parallel tasks (ex. `tpp::par`).
+		 * @param first Iterator to the first element of the source range.
+		 * @param last Iterator one past the last element of the source range.
+		 * @note Elements of ranges that are not random-access are inserted sequentially. */
+		template<typename E, typename I, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void insert(const E &exec, I first, I last) { m_table.insert(exec, first, last); }
 		/** Inserts all elements of an initializer list into the set. */
 		void insert(std::initializer_list<value_type> il) { return insert(il.begin(), il.end()); }
 		/** @copydoc insert */
@@ -292,6 +323,17 @@ namespace tpp
 		/** Reserves space for at least `n` buckets and rehashes the set if necessary.
 		 * @note The new amount of buckets is clamped to be at least `size() / max_load_factor()`. */
 		void rehash(size_type n) { m_table.rehash(n); }
+		/** Overloads of `reserve` & `rehash` that re-insert elements of the set in parallel, using either executor `exec`
+		 * or `threads` worker threads (where 0 selects `std::thread::hardware_concurrency()`). */
+		template<typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void reserve(size_type n, const E &exec) { m_table.reserve(n, exec); }
+		/** @copydoc reserve */
+		void reserve(size_type n, std::size_t threads) { m_table.reserve(n, thread_executor{threads}); }
+		/** @copydoc reserve */
+		template<typename E, typename = std::enable_if_t<_detail::is_executor_v<E>>>
+		void rehash(size_type n, const E &exec) { m_table.rehash(n, exec); }
+		/** @copydoc reserve */
+		void rehash(size_type n, std::size_t threads) { m_table.rehash(n, thread_executor{threads}); }
 		/** Returns the maximum load factor. */
 		[[nodiscard]] constexpr float max_load_factor() const noexcept { return m_table.max_load_factor(); }
 
@@ -317,7 +359,7 @@ namespace tpp
 	};
 
 	template<typename K, typename H, typename C, typename A>
-	inline void swap(stable_set<K, H, C, A> &a, stable_set<K, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<stable_set<K, H, C, A>>) { a.swap(b); }
+	inline void swap(stable_set<K, H, C, A> &a, stable_set<K, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the set \p set that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
@@ -668,7 +710,7 @@ namespace tpp
 	};
 
 	template<typename K, typename H, typename C, typename A>
-	inline void swap(ordered_stable_set<K, H, C, A> &a, ordered_stable_set<K, H, C, A> &b) noexcept(std::is_nothrow_swappable_v<ordered_stable_set<K, H, C, A>>) { a.swap(b); }
+	inline void swap(ordered_stable_set<K, H, C, A> &a, ordered_stable_set<K, H, C, A> &b) noexcept(noexcept(a.swap(b))) { a.swap(b); }
 
 	/** Erases all elements from the set \p set that satisfy the predicate \p pred.
 	 * @return Amount of elements erased. */
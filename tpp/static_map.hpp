@@ -0,0 +1,123 @@
+/*
+ * Created by switchblade on 2023-01-29.
+ */
+
+#pragma once
+
+#include "detail/static_table.hpp"
+
+namespace tpp
+{
+	/** @brief Read-only hash map of a fixed set of elements, built in a constant expression.
+	 *
+	 * Static map is intended for small sets of keys known at compile time (ex. keywords or enum names). The map is built
+	 * without heap allocation, and when declared as `constexpr` requires no static initialization. During construction,
+	 * a seed is selected such that every key maps to a unique position of the index, thus a lookup consists of a hash,
+	 * a shift, an index load and a single key comparison. Elements are stored (and iterated) in the order they were specified.
+	 *
+	 * Size of the index grows quadratically with the amount of elements (it is ~N^2 / 2 bytes for up to 255 elements),
+	 * as such `frozen_map` should be used for larger tables.
+	 *
+	 * @tparam Key Key type stored by the map.
+	 * @tparam Mapped Mapped type associated with map keys.
+	 * @tparam N Amount of elements of the map.
+	 * @tparam KeyHash Hash functor used by the map. Must be usable in constant expressions.
+	 * @tparam KeyCmp Compare functor used by the map. Must be usable in constant expressions. */
+	template<typename Key, typename Mapped, std::size_t N, typename KeyHash = static_hash<Key>, typename KeyCmp = std::equal_to<Key>>
+	class static_map
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Mapped;
+		using value_type = std::pair<key_type, mapped_type>;
+
+	private:
+		struct traits_t
+		{
+			template<typename T>
+			static constexpr auto &get_key(T &value) noexcept { return value.first; }
+		};
+
+		using table_t = _detail::static_table<value_type, key_type, N, KeyHash, KeyCmp, traits_t>;
+
+	public:
+		using reference = const value_type &;
+		using const_reference = const value_type &;
+		using pointer = const value_type *;
+		using const_pointer = const value_type *;
+
+		using iterator = typename table_t::const_iterator;
+		using const_iterator = typename table_t::const_iterator;
+
+		using size_type = typename table_t::size_type;
+		using difference_type = typename table_t::difference_type;
+
+		using hasher = typename table_t::hasher;
+		using key_equal = typename table_t::key_equal;
+
+	public:
+		/** Initializes the map from an array of elements.
+		 * @throw std::invalid_argument If keys of the elements are not unique. When constructed in a constant expression,
+		 * results in a compilation error instead. */
+		constexpr static_map(const value_type (&values)[N], const hasher &hash = hasher{}, const key_equal &cmp = key_equal{})
+				: m_table(std::make_index_sequence<N>{}, values, hash, cmp) {}
+		/** @copydoc static_map */
+		constexpr static_map(const std::array<value_type, N> &values, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{})
+				: m_table(std::make_index_sequence<N>{}, values, hash, cmp) {}
+
+		/** Returns iterator to the first element of the map. */
+		[[nodiscard]] constexpr const_iterator begin() const noexcept { return m_table.begin(); }
+		/** @copydoc begin */
+		[[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin(); }
+		/** Returns iterator one past the last element of the map. */
+		[[nodiscard]] constexpr const_iterator end() const noexcept { return m_table.end(); }
+		/** @copydoc end */
+		[[nodiscard]] constexpr const_iterator cend() const noexcept { return end(); }
+
+		/** Returns the amount of elements within the map. */
+		[[nodiscard]] constexpr size_type size() const noexcept { return N; }
+		/** Checks if the map is empty. */
+		[[nodiscard]] constexpr bool empty() const noexcept { return N == 0; }
+		/** Returns the size of the index of the map. */
+		[[nodiscard]] constexpr size_type bucket_count() const noexcept { return m_table.bucket_count(); }
+
+		/** Searches for an element with the specified key within the map.
+		 * @return Iterator to the element, or the end iterator if the element was not found. */
+		[[nodiscard]] constexpr const_iterator find(const key_type &key) const { return m_table.find(key); }
+		/** Checks if an element with the specified key is present within the map. */
+		[[nodiscard]] constexpr bool contains(const key_type &key) const { return find(key) != end(); }
+		/** Returns the amount of elements with the specified key (0 or 1). */
+		[[nodiscard]] constexpr size_type count(const key_type &key) const { return contains(key); }
+		/** Returns reference to the mapped object of the specified element.
+		 * @throw std::out_of_range If no such element exists within the map. */
+		[[nodiscard]] constexpr const mapped_type &at(const key_type &key) const
+		{
+			const auto pos = find(key);
+			if (pos == end())
+				throw std::out_of_range("`static_map::at` - invalid key");
+			return pos->second;
+		}
+
+		[[nodiscard]] constexpr hasher hash_function() const { return m_table.get_hash(); }
+		[[nodiscard]] constexpr key_equal key_eq() const { return m_table.get_cmp(); }
+
+	private:
+		table_t m_table;
+	};
+
+	template<typename K, typename M, std::size_t N>
+	static_map(const std::pair<K, M> (&)[N]) -> static_map<K, M, N>;
+	template<typename K, typename M, std::size_t N>
+	static_map(const std::array<std::pair<K, M>, N> &) -> static_map<K, M, N>;
+
+	/** Builds a static map from a braced list of elements. For example:
+	 * @code{cpp}
+	 * constexpr auto keywords = tpp::make_static_map<std::string_view, token>({{"if", token::if_kw}, {"else", token::else_kw}});
+	 * static_assert(keywords.at("else") == token::else_kw);
+	 * @endcode */
+	template<typename K, typename M, typename H = static_hash<K>, typename C = std::equal_to<K>, std::size_t N>
+	[[nodiscard]] constexpr static_map<K, M, N, H, C> make_static_map(const std::pair<K, M> (&values)[N], const H &hash = H{}, const C &cmp = C{})
+	{
+		return static_map<K, M, N, H, C>{values, hash, cmp};
+	}
+}
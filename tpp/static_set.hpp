@@ -0,0 +1,106 @@
+/*
+ * Created by switchblade on 2023-01-29.
+ */
+
+#pragma once
+
+#include "detail/static_table.hpp"
+
+namespace tpp
+{
+	/** @brief Read-only hash set of a fixed set of keys, built in a constant expression.
+	 *
+	 * See `static_map` for details on the layout of the set.
+	 *
+	 * @tparam Key Key type stored by the set.
+	 * @tparam N Amount of keys of the set.
+	 * @tparam KeyHash Hash functor used by the set. Must be usable in constant expressions.
+	 * @tparam KeyCmp Compare functor used by the set. Must be usable in constant expressions. */
+	template<typename Key, std::size_t N, typename KeyHash = static_hash<Key>, typename KeyCmp = std::equal_to<Key>>
+	class static_set
+	{
+	public:
+		using key_type = Key;
+		using value_type = key_type;
+
+	private:
+		struct traits_t
+		{
+			template<typename T>
+			static constexpr auto &get_key(T &value) noexcept { return value; }
+		};
+
+		using table_t = _detail::static_table<value_type, key_type, N, KeyHash, KeyCmp, traits_t>;
+
+	public:
+		using reference = const value_type &;
+		using const_reference = const value_type &;
+		using pointer = const value_type *;
+		using const_pointer = const value_type *;
+
+		using iterator = typename table_t::const_iterator;
+		using const_iterator = typename table_t::const_iterator;
+
+		using size_type = typename table_t::size_type;
+		using difference_type = typename table_t::difference_type;
+
+		using hasher = typename table_t::hasher;
+		using key_equal = typename table_t::key_equal;
+
+	public:
+		/** Initializes the set from an array of keys.
+		 * @throw std::invalid_argument If the keys are not unique. When constructed in a constant expression,
+		 * results in a compilation error instead. */
+		constexpr static_set(const value_type (&values)[N], const hasher &hash = hasher{}, const key_equal &cmp = key_equal{})
+				: m_table(std::make_index_sequence<N>{}, values, hash, cmp) {}
+		/** @copydoc static_set */
+		constexpr static_set(const std::array<value_type, N> &values, const hasher &hash = hasher{}, const key_equal &cmp = key_equal{})
+				: m_table(std::make_index_sequence<N>{}, values, hash, cmp) {}
+
+		/** Returns iterator to the first element of the set. */
+		[[nodiscard]] constexpr const_iterator begin() const noexcept { return m_table.begin(); }
+		/** @copydoc begin */
+		[[nodiscard]] constexpr const_iterator cbegin() const noexcept { return begin(); }
+		/** Returns iterator one past the last element of the set. */
+		[[nodiscard]] constexpr const_iterator end() const noexcept { return m_table.end(); }
+		/** @copydoc end */
+		[[nodiscard]] constexpr const_iterator cend() const noexcept { return end(); }
+
+		/** Returns the amount of elements within the set. */
+		[[nodiscard]] constexpr size_type size() const noexcept { return N; }
+		/** Checks if the set is empty. */
+		[[nodiscard]] constexpr bool empty() const noexcept { return N == 0; }
+		/** Returns the size of the index of the set. */
+		[[nodiscard]] constexpr size_type bucket_count() const noexcept { return m_table.bucket_count(); }
+
+		/** Searches for the specified key within the set.
+		 * @return Iterator to the element, or the end iterator if the element was not found. */
+		[[nodiscard]] constexpr const_iterator find(const key_type &key) const { return m_table.find(key); }
+		/** Checks if the specified key is present within the set. */
+		[[nodiscard]] constexpr bool contains(const key_type &key) const { return find(key) != end(); }
+		/** Returns the amount of elements with the specified key (0 or 1). */
+		[[nodiscard]] constexpr size_type count(const key_type &key) const { return contains(key); }
+
+		[[nodiscard]] constexpr hasher hash_function() const { return m_table.get_hash(); }
+		[[nodiscard]] constexpr key_equal key_eq() const { return m_table.get_cmp(); }
+
+	private:
+		table_t m_table;
+	};
+
+	template<typename K, std::size_t N>
+	static_set(const K (&)[N]) -> static_set<K, N>;
+	template<typename K, std::size_t N>
+	static_set(const std::array<K, N> &) -> static_set<K, N>;
+
+	/** Builds a static set from a braced list of keys. For example:
+	 * @code{cpp}
+	 * constexpr auto methods = tpp::make_static_set<std::string_view>({"GET", "HEAD", "POST"});
+	 * static_assert(methods.contains("HEAD"));
+	 * @endcode */
+	template<typename K, typename H = static_hash<K>, typename C = std::equal_to<K>, std::size_t N>
+	[[nodiscard]] constexpr static_set<K, N, H, C> make_static_set(const K (&values)[N], const H &hash = H{}, const C &cmp = C{})
+	{
+		return static_set<K, N, H, C>{values, hash, cmp};
+	}
+}